@@ -31,6 +31,15 @@ namespace {
         }
         out << std::endl;
     }
+
+    void printArrayField(std::ostream& out, const std::string& name, const std::vector<std::string>& vec) {
+        out << "\t" << name << ":\t";
+        for (size_t i = 0; i < vec.size(); ++i) {
+            if (i > 0) out << ", ";
+            out << vec[i];
+        }
+        out << std::endl;
+    }
 }
 
 class Config::Impl {
@@ -84,7 +93,19 @@ public:
         cfg.m_domainId = item.value("m_domainId", 0);
         cfg.m_isPositive = item.value("m_isPositive", false);
         cfg.m_useTaskNextSample = item.value("m_useTaskNextSample", false);
+        cfg.m_takeBatchSize = item.value("m_takeBatchSize", 32);
+        cfg.m_pollIdleUs = item.value("m_pollIdleUs", 0);
+        cfg.m_dispatchMode = item.value("m_dispatchMode", "inline");
+        cfg.m_logLevel = item.value("m_logLevel", "info");
+        cfg.m_dispatchWorkers = item.value("m_dispatchWorkers", 2);
+        cfg.m_dispatchQueueSize = item.value("m_dispatchQueueSize", 4096);
+        cfg.m_sampleIntervalMs = item.value("m_sampleIntervalMs", 100);
+        cfg.m_matchTimeoutSec = item.value("m_matchTimeoutSec", 60);
+        cfg.m_roundIdleTimeoutSec = item.value("m_roundIdleTimeoutSec", 30);
+        cfg.m_baselineMode = item.value("m_baselineMode", "off");
+        cfg.m_regressionThresholdPct = item.value("m_regressionThresholdPct", 5);
         cfg.m_useDataArrived = item.value("m_useDataArrived", false);
+        cfg.m_persistentEntities = item.value("m_persistentEntities", false);
         cfg.m_useSyncDelay = item.value("m_useSyncDelay", false);
         cfg.m_remoteNum = item.value("m_remoteNum", 0);
         cfg.m_userAction = item.value("m_userAction", 0);
@@ -93,6 +114,17 @@ public:
         cfg.m_logTimeStamp = item.value("m_logTimeStamp", true);
         cfg.m_checkSample = item.value("m_checkSample", false);
         cfg.m_delayMode = item.value("m_delayMode", 0);
+        cfg.m_arrivalMode = item.value("m_arrivalMode", DEFAULT_ARRIVAL_MODE);
+        cfg.m_payloadPattern = item.value("m_payloadPattern", DEFAULT_PAYLOAD_PATTERN);
+        cfg.m_onDurationUs = item.value("m_onDurationUs", 0);
+        cfg.m_offDurationUs = item.value("m_offDurationUs", 0);
+        cfg.m_cpuAffinity = item.value("m_cpuAffinity", "");
+        cfg.m_rtPriority = item.value("m_rtPriority", 0);
+        cfg.m_lockMemory = item.value("m_lockMemory", false);
+        cfg.m_prefault = item.value("m_prefault", false);
+        cfg.m_sendThreadNum = item.value("m_sendThreadNum", 1);
+        cfg.m_shareWriter = item.value("m_shareWriter", false);
+        cfg.m_checkDeadLine = item.value("m_checkDeadLine", item.value("m_cheakDeadLine", 0));
         
 
         auto load_vector = [&](const std::string& key, std::vector<int>& vec, bool& has) {
@@ -116,6 +148,23 @@ public:
         load_vector("m_writerNum", cfg.m_writerNum, cfg.has_m_writerNum);
         load_vector("m_readerTopicRange", cfg.m_readerTopicRange, cfg.has_m_readerTopicRange);
         load_vector("m_writerTopicRange", cfg.m_writerTopicRange, cfg.has_m_writerTopicRange);
+        load_vector("m_pubNum", cfg.m_pubNum, cfg.has_m_pubNum);
+        load_vector("m_subNum", cfg.m_subNum, cfg.has_m_subNum);
+        load_vector("m_remoteWriterNum", cfg.m_remoteWriterNum, cfg.has_m_remoteWriterNum);
+        load_vector("m_remoteReaderNum", cfg.m_remoteReaderNum, cfg.has_m_remoteReaderNum);
+
+        auto load_strings = [&](const std::string& key, std::vector<std::string>& vec) {
+            auto it = item.find(key);
+            if (it != item.end() && it->is_array()) {
+                vec = it->get<std::vector<std::string>>();
+            }
+            };
+
+        load_strings("m_dpQosNames", cfg.m_dpQosNames);
+        load_strings("m_pubQosNames", cfg.m_pubQosNames);
+        load_strings("m_subQosNames", cfg.m_subQosNames);
+        load_strings("m_writerConfigs", cfg.m_writerConfigs);
+        load_strings("m_readerConfigs", cfg.m_readerConfigs);
 
         if (item.contains("configs") && item["configs"].is_array()) {
             cfg.configs = item["configs"].get<std::vector<std::string>>();
@@ -219,8 +268,14 @@ public:
                 &cfg.m_recvPrintGap,
                 &cfg.m_sendDelay,
                 &cfg.m_sendDelayCount,
-                &cfg.m_sendPrintGap              
+                &cfg.m_sendPrintGap
             };
+            // scale:: 模式按轮次递增实体数；traffic:: 中这些数组按 Domain 对齐，不参与推导
+            if (cfg.name.rfind("scale::", 0) == 0) {
+                candidates.push_back(&cfg.m_dpNum);
+                candidates.push_back(&cfg.m_writerNum);
+                candidates.push_back(&cfg.m_readerNum);
+            }
 
             for (const auto* vec : candidates) {
                 if (!vec->empty()) {
@@ -278,7 +333,19 @@ public:
         out << "\tm_domainId:\t" << c.m_domainId << std::endl;
         out << "\tm_isPositive:\t" << c.m_isPositive << std::endl;
         out << "\tm_useTaskNextSample:\t" << c.m_useTaskNextSample << std::endl;
+        out << "\tm_takeBatchSize:\t" << c.m_takeBatchSize << std::endl;
+        out << "\tm_pollIdleUs:\t" << c.m_pollIdleUs << std::endl;
+        out << "\tm_dispatchMode:\t" << c.m_dispatchMode << std::endl;
+        out << "\tm_logLevel:\t" << c.m_logLevel << std::endl;
+        out << "\tm_dispatchWorkers:\t" << c.m_dispatchWorkers << std::endl;
+        out << "\tm_dispatchQueueSize:\t" << c.m_dispatchQueueSize << std::endl;
+        out << "\tm_sampleIntervalMs:\t" << c.m_sampleIntervalMs << std::endl;
+        out << "\tm_matchTimeoutSec:\t" << c.m_matchTimeoutSec << std::endl;
+        out << "\tm_roundIdleTimeoutSec:\t" << c.m_roundIdleTimeoutSec << std::endl;
+        out << "\tm_baselineMode:\t" << c.m_baselineMode << std::endl;
+        out << "\tm_regressionThresholdPct:\t" << c.m_regressionThresholdPct << std::endl;
         out << "\tm_useDataArrived:\t" << c.m_useDataArrived << std::endl;
+        out << "\tm_persistentEntities:\t" << c.m_persistentEntities << std::endl;
         out << "\tm_remoteNum:\t" << c.m_remoteNum << std::endl;
         out << "\tm_userAction:\t" << c.m_userAction << std::endl;
         out << "\tm_latencyMode:\t" << c.m_latencyMode << std::endl;
@@ -287,6 +354,14 @@ public:
         out << "\tm_logTimeStamp:\t" << c.m_logTimeStamp << std::endl;
         out << "\tm_checkSample:\t" << c.m_checkSample << std::endl;
         out << "\tm_delayMode:\t" << c.m_delayMode << std::endl;
+        out << "\tm_arrivalMode:\t" << c.m_arrivalMode << std::endl;
+        out << "\tm_payloadPattern:\t" << c.m_payloadPattern << std::endl;
+        out << "\tm_sendThreadNum:\t" << c.m_sendThreadNum << std::endl;
+        out << "\tm_shareWriter:\t" << c.m_shareWriter << std::endl;
+        out << "\tm_cpuAffinity:\t" << c.m_cpuAffinity << std::endl;
+        out << "\tm_rtPriority:\t" << c.m_rtPriority << std::endl;
+        out << "\tm_lockMemory:\t" << c.m_lockMemory << std::endl;
+        out << "\tm_prefault:\t" << c.m_prefault << std::endl;
         out << "\tm_activeLoop:\t" << c.m_activeLoop << std::endl;
         out << "\tm_loopNum:\t" << c.m_loopNum << std::endl;
 
@@ -298,6 +373,23 @@ public:
         printArrayField(out, "m_sendPrintGap", c.m_sendPrintGap);
         printArrayField(out, "m_recvPrintGap", c.m_recvPrintGap);
 
+        if (c.name.rfind("traffic::", 0) == 0) {
+            printArrayField(out, "m_domainIds", c.m_domainIds);
+            printArrayField(out, "m_dpNum", c.m_dpNum);
+            printArrayField(out, "m_dpQosNames", c.m_dpQosNames);
+            printArrayField(out, "m_pubNum", c.m_pubNum);
+            printArrayField(out, "m_pubQosNames", c.m_pubQosNames);
+            printArrayField(out, "m_subNum", c.m_subNum);
+            printArrayField(out, "m_subQosNames", c.m_subQosNames);
+            printArrayField(out, "m_writerNum", c.m_writerNum);
+            printArrayField(out, "m_writerConfigs", c.m_writerConfigs);
+            printArrayField(out, "m_readerNum", c.m_readerNum);
+            printArrayField(out, "m_readerConfigs", c.m_readerConfigs);
+            printArrayField(out, "m_remoteWriterNum", c.m_remoteWriterNum);
+            printArrayField(out, "m_remoteReaderNum", c.m_remoteReaderNum);
+        }
+        out << "\tm_checkDeadLine:\t" << c.m_checkDeadLine << std::endl;
+
         out << "\tm_resultPath:\t" << c.m_resultPath << std::endl;
     }
 
@@ -326,6 +418,8 @@ public:
 
     static constexpr const char* DEFAULT_LATENCY_MODE = "pp";
     static constexpr const char* DEFAULT_CLOCK_DEV_NAME = "CLOCK_REALTIME";
+    static constexpr const char* DEFAULT_ARRIVAL_MODE = "constant";
+    static constexpr const char* DEFAULT_PAYLOAD_PATTERN = "incrementing";
 };
 
 // ============= Config 接口实现 =============
@@ -384,6 +478,17 @@ void Config::selectConfig(const std::string& name) {
     throw std::runtime_error("未找到配置: " + name);
 }
 
+bool Config::findConfig(const std::string& name, ConfigData& out) const {
+    for (const auto& cfg : pImpl_->configs_) {
+        if (cfg.name == name) {
+            out = cfg;
+            pImpl_->normalizeConfigArrays(out);
+            return true;
+        }
+    }
+    return false;
+}
+
 size_t Config::getConfigCount() const {
     return pImpl_->configs_.size();
 }
@@ -403,7 +508,8 @@ void Config::printCurrentConfig(std::ostream& out) const {
     }
     else if (name.rfind("tp::", 0) == 0 ||
         name.rfind("delay::", 0) == 0 ||
-        name.rfind("scale::", 0) == 0) {
+        name.rfind("scale::", 0) == 0 ||
+        name.rfind("traffic::", 0) == 0) {
         pImpl_->printCurrentConfig(pImpl_->current_, out);
     }
     else {
@@ -482,7 +588,19 @@ void Config::printConfigToStream(const ConfigData& c, std::ostream& out) {
     out << "\tm_domainId:\t" << c.m_domainId << std::endl;
     out << "\tm_isPositive:\t" << (c.m_isPositive ? "true" : "false") << std::endl;
     out << "\tm_useTaskNextSample:\t" << (c.m_useTaskNextSample ? "true" : "false") << std::endl;
+    out << "\tm_takeBatchSize:\t" << c.m_takeBatchSize << std::endl;
+    out << "\tm_pollIdleUs:\t" << c.m_pollIdleUs << std::endl;
+    out << "\tm_dispatchMode:\t" << c.m_dispatchMode << std::endl;
+    out << "\tm_logLevel:\t" << c.m_logLevel << std::endl;
+    out << "\tm_dispatchWorkers:\t" << c.m_dispatchWorkers << std::endl;
+    out << "\tm_dispatchQueueSize:\t" << c.m_dispatchQueueSize << std::endl;
+    out << "\tm_sampleIntervalMs:\t" << c.m_sampleIntervalMs << std::endl;
+    out << "\tm_matchTimeoutSec:\t" << c.m_matchTimeoutSec << std::endl;
+    out << "\tm_roundIdleTimeoutSec:\t" << c.m_roundIdleTimeoutSec << std::endl;
+    out << "\tm_baselineMode:\t" << c.m_baselineMode << std::endl;
+    out << "\tm_regressionThresholdPct:\t" << c.m_regressionThresholdPct << std::endl;
     out << "\tm_useDataArrived:\t" << (c.m_useDataArrived ? "true" : "false") << std::endl;
+    out << "\tm_persistentEntities:\t" << (c.m_persistentEntities ? "true" : "false") << std::endl;
     out << "\tm_remoteNum:\t" << c.m_remoteNum << std::endl;
     out << "\tm_userAction:\t" << c.m_userAction << std::endl;
     out << "\tm_latencyMode:\t" << c.m_latencyMode << std::endl;
@@ -491,6 +609,16 @@ void Config::printConfigToStream(const ConfigData& c, std::ostream& out) {
     out << "\tm_logTimeStamp:\t" << (c.m_logTimeStamp ? "true" : "false") << std::endl;
     out << "\tm_checkSample:\t" << (c.m_checkSample ? "true" : "false") << std::endl;
     out << "\tm_delayMode:\t" << c.m_delayMode << std::endl;
+    out << "\tm_arrivalMode:\t" << c.m_arrivalMode << std::endl;
+    out << "\tm_onDurationUs:\t" << c.m_onDurationUs << std::endl;
+    out << "\tm_offDurationUs:\t" << c.m_offDurationUs << std::endl;
+    out << "\tm_payloadPattern:\t" << c.m_payloadPattern << std::endl;
+    out << "\tm_sendThreadNum:\t" << c.m_sendThreadNum << std::endl;
+    out << "\tm_shareWriter:\t" << c.m_shareWriter << std::endl;
+    out << "\tm_cpuAffinity:\t" << c.m_cpuAffinity << std::endl;
+    out << "\tm_rtPriority:\t" << c.m_rtPriority << std::endl;
+    out << "\tm_lockMemory:\t" << c.m_lockMemory << std::endl;
+    out << "\tm_prefault:\t" << c.m_prefault << std::endl;
     out << "\tm_activeLoop:\t" << c.m_activeLoop << std::endl;
     out << "\tm_loopNum:\t" << c.m_loopNum << std::endl;
 
@@ -516,5 +644,22 @@ void Config::printConfigToStream(const ConfigData& c, std::ostream& out) {
     printVec("m_sendPrintGap", c.m_sendPrintGap);
     printVec("m_recvPrintGap", c.m_recvPrintGap);
 
+    if (c.name.rfind("traffic::", 0) == 0) {
+        printVec("m_domainIds", c.m_domainIds);
+        printVec("m_dpNum", c.m_dpNum);
+        printArrayField(out, "m_dpQosNames", c.m_dpQosNames);
+        printVec("m_pubNum", c.m_pubNum);
+        printArrayField(out, "m_pubQosNames", c.m_pubQosNames);
+        printVec("m_subNum", c.m_subNum);
+        printArrayField(out, "m_subQosNames", c.m_subQosNames);
+        printVec("m_writerNum", c.m_writerNum);
+        printArrayField(out, "m_writerConfigs", c.m_writerConfigs);
+        printVec("m_readerNum", c.m_readerNum);
+        printArrayField(out, "m_readerConfigs", c.m_readerConfigs);
+        printVec("m_remoteWriterNum", c.m_remoteWriterNum);
+        printVec("m_remoteReaderNum", c.m_remoteReaderNum);
+    }
+    out << "\tm_checkDeadLine:\t" << c.m_checkDeadLine << std::endl;
+
     out << "\tm_resultPath:\t" << c.m_resultPath << std::endl;
 }
\ No newline at end of file
@@ -22,6 +22,9 @@ public:
     void selectConfig(size_t index);
     void selectConfig(const std::string& name);
 
+    // 按名称取配置副本（补齐数组后），不改变当前配置；traffic:: 用于解析端点配置
+    bool findConfig(const std::string& name, ConfigData& out) const;
+
     size_t getConfigCount() const;
     void listAvailableConfigs() const;
     void printCurrentConfig(std::ostream& out = std::cout) const;
@@ -16,22 +16,45 @@ struct ConfigData {
     std::string m_topicName;
 
     std::string m_clockDevName;
-    std::string m_latencyMode;
+    std::string m_latencyMode;      // 时延模式: pp 闭环 ping-pong（默认）/ ol 开环（按计划时刻计时）
     std::string m_resultPath;
+    std::string m_arrivalMode;      // 发送到达过程: constant / poisson / onoff
+    std::string m_payloadPattern;   // 负载内容: incrementing / constant / random / compressible / file:<路径>
+    std::string m_logLevel;         // 日志级别: "info" 或 "info;ResourceUtilization:debug"（按模块覆盖）
+    std::string m_dispatchMode;     // 接收分发: inline（默认）/ spsc / pool
+    std::string m_baselineMode;     // 基线: off（默认）/ record 记录为基线 / compare 与基线比较
+    std::string m_cpuAffinity;      // 线程绑核规则，如 "sender:2;dds_listener:3;logger:0;resource_sampler:1"
 
     int m_activeLoop;
     int m_delayMode;
     int m_domainId;
     int m_loopNum;
-    int m_remoteNum;
+    int m_remoteNum;                // scale:: 每个 Reader 预期的 Writer 数（含进程外），决定丢包基数与结束条件
     int m_userAction;
+    int m_onDurationUs;             // onoff 模式 ON 时长（微秒）
+    int m_offDurationUs;            // onoff 模式 OFF 时长（微秒）
+    int m_rtPriority;               // 热路径线程实时优先级（Linux SCHED_FIFO 1-99），0 为不修改；忙轮询接收线程不提升；suite 模式只取首个配置
+    int m_sendThreadNum;            // 吞吐发送线程数（DDS::Bytes），默认 1
+    int m_takeBatchSize;            // 轮询接收单次 take 的最大样本数，1 为 take_next_sample
+    int m_pollIdleUs;               // 轮询无数据时休眠时长（微秒），0 为忙轮询
+    int m_dispatchWorkers;          // pool 分发的工作线程数
+    int m_dispatchQueueSize;        // 分发队列容量（向上取整为 2 的幂）
+    int m_sampleIntervalMs;         // 每轮区间采样周期（毫秒），0 为关闭
+    int m_matchTimeoutSec;          // 等待对端匹配的超时（秒），0 为按上限 60 分钟
+    int m_roundIdleTimeoutSec;      // 吞吐订阅端等待结束包时无新数据的超时（秒），超时按已收数据结算，0 为按上限 60 分钟
+    int m_regressionThresholdPct;   // 回归判定阈值（%）：吞吐中位数下降或尾时延中位数上升超过此值
+    int m_checkDeadLine;            // traffic:: 到达间隔期限（微秒），0 为不检查；JSON 键为 m_cheakDeadLine
 
     bool m_isPositive;
     bool m_logTimeStamp;
     bool m_checkSample;
-    bool m_useDataArrived;
+    bool m_useDataArrived;          // 通知接收：Listener 只挂 DATA_AVAILABLE 唤醒消费线程批量 take
     bool m_useSyncDelay;
-    bool m_useTaskNextSample;
+    bool m_useTaskNextSample;       // 轮询接收：专用线程 take 取数，替代 Listener 回调
+    bool m_lockMemory;              // 锁定进程内存（Linux mlockall）
+    bool m_prefault;                // 预触碰负载缓冲区与实时线程栈
+    bool m_shareWriter;             // 多线程发送时所有线程共用一个 Writer（测量 Writer 锁竞争）
+    bool m_persistentEntities;      // 吞吐模式跨轮复用参与者与端点，轮次以结束包在带内划分
 
     std::vector<std::string> configs;
     std::vector<int> m_domainIds;
@@ -49,6 +72,17 @@ struct ConfigData {
     std::vector<int> m_readerTopicRange;
     std::vector<int> m_writerTopicRange;
 
+    // traffic:: 混合负载拓扑（按 m_domainIds 下标对齐，不足时沿用最后一个）
+    std::vector<std::string> m_dpQosNames;
+    std::vector<std::string> m_pubQosNames;
+    std::vector<std::string> m_subQosNames;
+    std::vector<std::string> m_writerConfigs;   // Writer 端点配置名，第 i 个 Writer 取 [i % size]
+    std::vector<std::string> m_readerConfigs;   // Reader 端点配置名，同上
+    std::vector<int> m_pubNum;
+    std::vector<int> m_subNum;
+    std::vector<int> m_remoteWriterNum;         // 每个 Reader 预期匹配的 Writer 数（含进程外）
+    std::vector<int> m_remoteReaderNum;         // 每个 Writer 预期匹配的 Reader 数（含进程外）
+
     // 标志字段：是否显式配置了该数组
     bool has_configs = false;
     bool has_m_domainIds = false;
@@ -64,4 +98,8 @@ struct ConfigData {
     bool has_m_writerNum = false;
     bool has_m_readerTopicRange = false;
     bool has_m_writerTopicRange = false;
+    bool has_m_pubNum = false;
+    bool has_m_subNum = false;
+    bool has_m_remoteWriterNum = false;
+    bool has_m_remoteReaderNum = false;
 };
\ No newline at end of file
@@ -2,23 +2,84 @@
 #include "DDSManager_Bytes.h"
 #include "Logger.h"
 #include "GloMemPool.h"
+#include "ResourceUtilization.h"
+#include "PayloadFactory.h"
+#include "ReceiveDispatcher.h"
+#include "PacketHeader.h"
 
 #include "ZRDDSDataReader.h"
 #include "ZRDDSTypeSupport.h"
 #include "ZRBuiltinTypesTypeSupport.h"
 #include "ZRDDSDataWriter.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <random>
 #include <chrono>
+#include <thread>
+#include <condition_variable>
+
+// 单个样本的公共处理：有效性检查、结束包拦截、完整性校验、上层回调
+// Listener 回调与轮询线程共用，保证两种接收路径的行为一致；
+// dispatcher 非空时数据样本（含校验）交给分发层，结束包先等分发层排空再回调
+static void process_received_sample(
+    const DDS::Bytes& sample,
+    const DDS::SampleInfo& info,
+    const DDSManager_Bytes::OnDataReceivedCallback_Bytes& onDataReceived,
+    const DDSManager_Bytes::OnEndOfRoundCallback& onEndOfRound,
+    SampleVerifier* verifier,
+    ReceiveDispatcher* dispatcher
+) {
+    if (!info.valid_data || sample.value.length() < sizeof(PacketHeader)) {
+        if (verifier && info.valid_data) {
+            verifier->recordTruncated();
+        }
+        ZR_LOG_WARN("DDSManager_Bytes", "[DDSManager_Bytes] 收到无效或过短的数据包 | valid=" << info.valid_data
+            << " | length=" << sample.value.length());
+        return;
+    }
 
-// Packet Header 结构（内部定义）
-struct PacketHeader {
-    uint32_t sequence;
-    uint64_t timestamp;
-    uint8_t  packet_type; // 0 = 数据包, 1 = 结束包
-};
+    const uint8_t* buffer = sample.value.get_contiguous_buffer();
+    if (!buffer) {
+        if (verifier) {
+            verifier->recordTruncated();
+        }
+        Logger::getInstance().error("[DDSManager_Bytes] buffer 为空");
+        return;
+    }
+
+    const PacketHeader* hdr = reinterpret_cast<const PacketHeader*>(buffer);
+
+    if (hdr->packet_type == 1) {
+        Logger::getInstance().logAndPrint(
+            "[DDSManager_Bytes] 收到结束包 | seq=" + std::to_string(hdr->sequence) +
+            " | round=" + std::to_string(hdr->round) +
+            " | ts=" + std::to_string(hdr->timestamp) +
+            " | length=" + std::to_string(sample.value.length())
+        );
+        if (dispatcher) {
+            dispatcher->drain();
+        }
+        if (onEndOfRound) {
+            onEndOfRound(hdr->round);
+        }
+        return;
+    }
+
+    if (dispatcher) {
+        dispatcher->dispatch(sample, info);
+        return;
+    }
+
+    if (verifier) {
+        verifier->verify(buffer, sample.value.length(), sizeof(PacketHeader));
+    }
+
+    if (onDataReceived) {
+        onDataReceived(sample, info);
+    }
+}
 
 // 内部 Listener 类
 class DDSManager_Bytes::MyDataReaderListener
@@ -27,8 +88,15 @@ class DDSManager_Bytes::MyDataReaderListener
 public:
     MyDataReaderListener(
         OnDataReceivedCallback_Bytes dataCb,
-        OnEndOfRoundCallback endCb
-    ) : onDataReceived_(std::move(dataCb)), onEndOfRound_(std::move(endCb)) {
+        OnEndOfRoundCallback endCb,
+        SampleVerifier* verifier,
+        ReceiveDispatcher* dispatcher,
+        MatchTracker* matches
+    ) : onDataReceived_(std::move(dataCb)), onEndOfRound_(std::move(endCb)), verifier_(verifier), dispatcher_(dispatcher), matches_(matches) {
+    }
+
+    void on_subscription_matched(DDS::DataReader* reader, const DDS::SubscriptionMatchedStatus& status) override {
+        matches_->update(reader, status.current_count);
     }
 
     void on_process_sample(
@@ -36,39 +104,211 @@ public:
         const DDS::Bytes& sample,
         const DDS::SampleInfo& info
     ) override {
-        if (!info.valid_data || sample.value.length() < sizeof(PacketHeader)) {
-            Logger::getInstance().logAndPrint("[DDSManager_Bytes] 收到无效或过短的数据包");
-            return;
+        // DDS 接收线程首次回调时登记角色，用于每线程 CPU 归因
+        static thread_local bool thread_registered = false;
+        if (!thread_registered) {
+            ResourceUtilization::instance().registerCurrentThread("dds_listener");
+            thread_registered = true;
         }
 
-        const uint8_t* buffer = sample.value.get_contiguous_buffer();
-        if (!buffer) {
-            Logger::getInstance().error("[DDSManager_Bytes] buffer 为空");
-            return;
+        process_received_sample(sample, info, onDataReceived_, onEndOfRound_, verifier_, dispatcher_);
+    }
+
+private:
+    OnDataReceivedCallback_Bytes onDataReceived_;
+    OnEndOfRoundCallback onEndOfRound_;
+    SampleVerifier* verifier_;  // 未开启 m_checkSample 时为 nullptr
+    ReceiveDispatcher* dispatcher_;  // m_dispatchMode 为 inline 时为 nullptr
+    MatchTracker* matches_;
+};
+
+// 内部轮询器：Reader 的样本由专用线程主动 take 取数，替代 on_process_sample 逐条回调
+//   m_useTaskNextSample：忙轮询 / 定时轮询，无数据时 yield 或休眠 m_pollIdleUs
+//   m_useDataArrived   ：Reader 只挂 DATA_AVAILABLE 通知，回调仅唤醒本线程，由本线程批量 take
+class DDSManager_Bytes::ReaderPoller {
+public:
+    using BytesReader = DDS::ZRDDSDataReader<DDS::Bytes, DDS::BytesSeq>;
+
+    // 数据到达通知：回调中不取数据，只唤醒消费线程；匹配变化转给 MatchTracker
+    class ArrivalListener : public virtual DDS::DataReaderListener {
+    public:
+        explicit ArrivalListener(ReaderPoller* owner) : owner_(owner) {}
+        void on_data_available(DDS::DataReader*) override { owner_->notify(); }
+        void on_subscription_matched(DDS::DataReader* reader, const DDS::SubscriptionMatchedStatus& status) override {
+            owner_->matches_->update(reader, status.current_count);
         }
+    private:
+        ReaderPoller* owner_;
+    };
+
+    ReaderPoller(
+        OnDataReceivedCallback_Bytes dataCb,
+        OnEndOfRoundCallback endCb,
+        SampleVerifier* verifier,
+        ReceiveDispatcher* dispatcher,
+        MatchTracker* matches,
+        int batch_size,
+        int idle_us,
+        bool wait_for_arrival
+    ) : onDataReceived_(std::move(dataCb))
+      , onEndOfRound_(std::move(endCb))
+      , verifier_(verifier)
+      , dispatcher_(dispatcher)
+      , matches_(matches)
+      , batch_size_(std::max(batch_size, 1))
+      , idle_us_(std::max(idle_us, 0))
+      , wait_for_arrival_(wait_for_arrival)
+      , arrival_listener_(this) {
+    }
 
-        const PacketHeader* hdr = reinterpret_cast<const PacketHeader*>(buffer);
+    ~ReaderPoller() { stop(); }
 
-        if (hdr->packet_type == 1) {
-            Logger::getInstance().logAndPrint(
-                "[DDSManager_Bytes] 收到结束包 | seq=" + std::to_string(hdr->sequence) +
-                " | ts=" + std::to_string(hdr->timestamp) +
-                " | length=" + std::to_string(sample.value.length())
-            );
-            if (onEndOfRound_) {
-                onEndOfRound_();
+    // 创建 Reader 时挂此 Listener：两种模式都关注匹配变化，通知模式另外关注 DATA_AVAILABLE
+    DDS::DataReaderListener* listener() { return &arrival_listener_; }
+    DDS::StatusMask listener_mask() const {
+        return wait_for_arrival_ ? (DDS::DATA_AVAILABLE_STATUS | DDS::SUBSCRIPTION_MATCHED_STATUS) : DDS::SUBSCRIPTION_MATCHED_STATUS;
+    }
+
+    bool start(DDS::DataReader* reader) {
+        reader_ = dynamic_cast<BytesReader*>(reader);
+        if (!reader_) {
+            Logger::getInstance().error("[DDSManager_Bytes] 轮询模式：DataReader 类型转换失败");
+            return false;
+        }
+        stop_flag_.store(false, std::memory_order_release);
+        thread_ = std::thread(&ReaderPoller::run, this);
+        return true;
+    }
+
+    // 必须在删除 Reader 所属 Participant 之前调用；通知模式下 Listener 仍可能被回调，
+    // 因此对象本身要等 Participant 删除后再释放
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stop_flag_.store(true, std::memory_order_release);
+        }
+        wake_cv_.notify_one();
+
+        if (thread_.joinable()) {
+            thread_.join();
+
+            std::ostringstream oss;
+            oss << "[DDSManager_Bytes] " << (wait_for_arrival_ ? "通知接收" : "轮询接收")
+                << "统计 | 样本: " << samples_
+                << " | 批次: " << batches_
+                << " | 平均批量: " << (batches_ > 0 ? static_cast<double>(samples_) / batches_ : 0.0);
+            if (wait_for_arrival_) {
+                const uint64_t callbacks = callbacks_.load(std::memory_order_relaxed);
+                oss << " | 到达回调: " << callbacks
+                    << " | 唤醒: " << wakeups_
+                    << " | 每次唤醒样本: " << (wakeups_ > 0 ? static_cast<double>(samples_) / wakeups_ : 0.0)
+                    << " | 每次回调样本: " << (callbacks > 0 ? static_cast<double>(samples_) / callbacks : 0.0);
             }
-            return;
+            else {
+                oss << " | 空轮询: " << empty_polls_;
+            }
+            Logger::getInstance().logAndPrint(oss.str());
         }
+    }
 
-        if (onDataReceived_) {
-            onDataReceived_(sample, info);
+    // DDS 接收线程调用
+    void notify() {
+        callbacks_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            pending_ = true;
         }
+        wake_cv_.notify_one();
     }
 
 private:
+    void run() {
+        // 忙轮询线程不能以实时优先级运行（yield 无法让出给 DDS 传输线程），单独登记角色
+        const bool spinning = !wait_for_arrival_ && idle_us_ == 0;
+        ResourceUtilization::instance().registerCurrentThread(spinning ? "dds_poller_spin" : "dds_poller");
+
+        DDS::BytesSeq data_seq;
+        DDS::SampleInfoSeq info_seq;
+        DDS::Bytes single_sample;
+        DDS::SampleInfo single_info;
+        bool error_reported = false;
+
+        while (!stop_flag_.load(std::memory_order_acquire)) {
+            DDS::ReturnCode_t ret;
+            if (batch_size_ == 1) {
+                // 批量为 1 时逐个取样本，省去借出/归还序列的开销
+                ret = reader_->take_next_sample(single_sample, single_info);
+                if (ret == DDS::RETCODE_OK) {
+                    process_received_sample(single_sample, single_info, onDataReceived_, onEndOfRound_, verifier_, dispatcher_);
+                    ++samples_;
+                    ++batches_;
+                    continue;
+                }
+            }
+            else {
+                ret = reader_->take(data_seq, info_seq, batch_size_,
+                    DDS::ANY_SAMPLE_STATE, DDS::ANY_VIEW_STATE, DDS::ANY_INSTANCE_STATE);
+                if (ret == DDS::RETCODE_OK) {
+                    const DDS_ULong n = info_seq.length();
+                    for (DDS_ULong i = 0; i < n; ++i) {
+                        process_received_sample(data_seq[i], info_seq[i], onDataReceived_, onEndOfRound_, verifier_, dispatcher_);
+                    }
+                    reader_->return_loan(data_seq, info_seq);
+                    samples_ += n;
+                    ++batches_;
+                    continue;
+                }
+            }
+
+            if (ret != DDS::RETCODE_NO_DATA && !error_reported) {
+                Logger::getInstance().error("[DDSManager_Bytes] 轮询 take 失败，返回码: " + std::to_string(ret));
+                error_reported = true;
+            }
+
+            // 已取空：通知模式等待下一次到达回调；take 与等待之间到达的通知由 pending_ 保留，不会丢失
+            if (wait_for_arrival_) {
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_cv_.wait(lock, [this] { return pending_ || stop_flag_.load(std::memory_order_acquire); });
+                pending_ = false;
+                ++wakeups_;
+                continue;
+            }
+
+            // 轮询模式：idle_us 为 0 时忙轮询（只让出时间片），否则短暂休眠
+            ++empty_polls_;
+            if (idle_us_ > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(idle_us_));
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    BytesReader* reader_ = nullptr;
     OnDataReceivedCallback_Bytes onDataReceived_;
     OnEndOfRoundCallback onEndOfRound_;
+    SampleVerifier* verifier_;
+    ReceiveDispatcher* dispatcher_;
+    MatchTracker* matches_;
+    int batch_size_;
+    int idle_us_;
+    bool wait_for_arrival_;
+    ArrivalListener arrival_listener_;
+
+    std::thread thread_;
+    std::atomic<bool> stop_flag_{ false };
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    bool pending_ = false;
+    std::atomic<uint64_t> callbacks_{ 0 };
+
+    // 仅由轮询线程写，stop() 在 join 之后读取
+    uint64_t samples_ = 0;
+    uint64_t batches_ = 0;
+    uint64_t empty_polls_ = 0;
+    uint64_t wakeups_ = 0;
 };
 
 // -------------------------------
@@ -85,13 +325,27 @@ DDSManager_Bytes::DDSManager_Bytes(const ConfigData& config, const std::string&
     , data_reader_qos_name_(config.m_readerQosName)
     , xml_qos_file_path_(xml_qos_file_path)
     , is_positive_role_(config.m_isPositive)
+    , send_thread_num_(config.m_sendThreadNum)
+    , share_writer_(config.m_shareWriter)
+    , use_polling_(config.m_useTaskNextSample || config.m_useDataArrived)
+    , use_data_arrived_(config.m_useDataArrived)
+    , dispatch_mode_(ReceiveDispatcher::parseMode(config.m_dispatchMode))
+    , dispatch_workers_(config.m_dispatchWorkers)
+    , dispatch_queue_size_(config.m_dispatchQueueSize)
+    , dispatch_slot_bytes_(config.m_maxSize.empty() ? 0 : static_cast<size_t>(*std::max_element(config.m_maxSize.begin(), config.m_maxSize.end())))
+    , take_batch_size_(config.m_takeBatchSize)
+    , poll_idle_us_(config.m_pollIdleUs)
 {
+    PayloadFactory::instance().configure(config.m_payloadPattern);
+    sample_verifier_.setEnabled(config.m_checkSample);
 }
 
 DDSManager_Bytes::~DDSManager_Bytes() {
     if (is_initialized_) {
         shutdown();
     }
+    release_pollers();
+    release_dispatcher();
 }
 
 // -------------------------------
@@ -104,6 +358,10 @@ bool DDSManager_Bytes::initialize(
 ) {
     Logger::getInstance().logAndPrint("[DDSManager_Bytes] 开始初始化（吞吐模式）...");
 
+    sample_verifier_.reset();
+    match_tracker_.reset();
+    SampleVerifier* verifier = sample_verifier_.enabled() ? &sample_verifier_ : nullptr;
+
     const char* qosFilePath = xml_qos_file_path_.c_str();
     const char* p_lib_name = "default_lib";
     const char* p_prof_name = "default_profile";
@@ -158,17 +416,52 @@ bool DDSManager_Bytes::initialize(
         return false;
     }
 
+    // 接收端按 m_dispatchMode 创建分发层（inline 时不创建）
+    if (!is_positive_role_ && !setup_dispatcher(dataCallback, verifier)) {
+        return false;
+    }
+
     // 根据角色创建 Writer 或 Reader
     if (is_positive_role_) {
         m_throughput_writer = participant_->create_datawriter_with_topic_and_qos_profile(
             throughput_topic_->get_name(), type_support,
             "default_lib", "default_profile", data_writer_qos_name_.c_str(),
-            nullptr, DDS::STATUS_MASK_NONE);
+            match_tracker_.writerListener(), DDS::PUBLICATION_MATCHED_STATUS);
         if (!m_throughput_writer) {
             Logger::getInstance().error("[DDSManager_Bytes] 创建吞吐 DataWriter 失败");
             return false;
         }
         Logger::getInstance().logAndPrint("[DDSManager_Bytes] 吞吐 DataWriter 创建成功");
+
+        // 多线程发送且不共用 Writer 时，为其余发送线程各创建一个 Writer
+        m_sender_writers.clear();
+        m_sender_writers.push_back(dynamic_cast<BytesWriter*>(m_throughput_writer));
+        const int writer_count = share_writer_ ? 1 : std::max(send_thread_num_, 1);
+        for (int i = 1; i < writer_count; ++i) {
+            DDS::DataWriter* extra_writer = participant_->create_datawriter_with_topic_and_qos_profile(
+                throughput_topic_->get_name(), type_support,
+                "default_lib", "default_profile", data_writer_qos_name_.c_str(),
+                match_tracker_.writerListener(), DDS::PUBLICATION_MATCHED_STATUS);
+            if (!extra_writer) {
+                Logger::getInstance().error("[DDSManager_Bytes] 创建第 " + std::to_string(i + 1) + " 个发送 DataWriter 失败");
+                return false;
+            }
+            m_sender_writers.push_back(dynamic_cast<BytesWriter*>(extra_writer));
+        }
+        if (writer_count > 1) {
+            Logger::getInstance().logAndPrint("[DDSManager_Bytes] 多线程发送 DataWriter 创建成功，共 " + std::to_string(writer_count) + " 个");
+        }
+    }
+    else if (use_polling_) {
+        // 轮询 / 通知模式：由专用线程 take 取数
+        m_throughput_reader = create_polled_reader(
+            throughput_topic_->get_name(),
+            std::move(dataCallback), std::move(endCallback), verifier);
+        if (!m_throughput_reader) {
+            Logger::getInstance().error("[DDSManager_Bytes] 创建吞吐 DataReader 失败");
+            return false;
+        }
+        Logger::getInstance().logAndPrint("[DDSManager_Bytes] 吞吐 DataReader 创建成功（专用线程取数）");
     }
     else {
         void* mem = GloMemPool::allocate(sizeof(MyDataReaderListener), __FILE__, __LINE__);
@@ -176,7 +469,7 @@ bool DDSManager_Bytes::initialize(
             Logger::getInstance().error("[DDSManager_Bytes] 分配监听器内存失败");
             return false;
         }
-        m_throughput_listener_ = new (mem) MyDataReaderListener(std::move(dataCallback), std::move(endCallback));
+        m_throughput_listener_ = new (mem) MyDataReaderListener(std::move(dataCallback), std::move(endCallback), verifier, dispatcher_, &match_tracker_);
 
         m_throughput_reader = participant_->create_datareader_with_topic_and_qos_profile(
             throughput_topic_->get_name(), type_support,
@@ -208,6 +501,10 @@ bool DDSManager_Bytes::initialize_latency(
 ) {
     Logger::getInstance().logAndPrint("[DDSManager_Bytes] 开始初始化（时延模式）...");
 
+    sample_verifier_.reset();
+    match_tracker_.reset();
+    SampleVerifier* verifier = sample_verifier_.enabled() ? &sample_verifier_ : nullptr;
+
     const char* qosFilePath = xml_qos_file_path_.c_str();
     const char* p_lib_name = "default_lib";
     const char* p_prof_name = "default_profile";
@@ -268,6 +565,12 @@ bool DDSManager_Bytes::initialize_latency(
         return false;
     }
 
+    // Initiator 收 Pong、Responder 收 Ping，按 m_dispatchMode 创建分发层；
+    // 应答回调共用一个 Pong 样本，pool 模式也只用一个工作线程
+    if (!setup_dispatcher(is_positive_role_ ? pong_callback : ping_callback, verifier, 1)) {
+        return false;
+    }
+
     // === 根据角色创建不同实体 ===
 
     if (is_positive_role_) {
@@ -275,16 +578,26 @@ bool DDSManager_Bytes::initialize_latency(
         m_ping_writer = participant_->create_datawriter_with_topic_and_qos_profile(
             ping_topic_->get_name(), type_support,
             "default_lib", "default_profile", data_writer_qos_name_.c_str(),
-            nullptr, DDS::STATUS_MASK_NONE);
+            match_tracker_.writerListener(), DDS::PUBLICATION_MATCHED_STATUS);
         if (!m_ping_writer) {
             Logger::getInstance().error("[DDSManager_Bytes] 创建 Ping DataWriter 失败");
             return false;
         }
+        m_ping_typed_writer = dynamic_cast<BytesWriter*>(m_ping_writer);
 
-        if (pong_callback) {
+        if (pong_callback && use_polling_) {
+            m_pong_reader = create_polled_reader(
+                pong_topic_->get_name(),
+                std::move(pong_callback), std::move(end_callback), verifier);
+            if (!m_pong_reader) {
+                Logger::getInstance().error("[DDSManager_Bytes] 创建 Pong DataReader 失败");
+                return false;
+            }
+        }
+        else if (pong_callback) {
             void* mem = GloMemPool::allocate(sizeof(MyDataReaderListener), __FILE__, __LINE__);
             if (!mem) return false;
-            m_pong_listener_ = new (mem) MyDataReaderListener(std::move(pong_callback), std::move(end_callback));
+            m_pong_listener_ = new (mem) MyDataReaderListener(std::move(pong_callback), std::move(end_callback), verifier, dispatcher_, &match_tracker_);
 
             m_pong_reader = participant_->create_datareader_with_topic_and_qos_profile(
                 pong_topic_->get_name(), type_support,
@@ -300,10 +613,19 @@ bool DDSManager_Bytes::initialize_latency(
     }
     else {
         // Responder: 收 Ping，发 Pong
-        if (ping_callback || end_callback) {
+        if ((ping_callback || end_callback) && use_polling_) {
+            m_ping_reader = create_polled_reader(
+                ping_topic_->get_name(),
+                std::move(ping_callback), std::move(end_callback), verifier);
+            if (!m_ping_reader) {
+                Logger::getInstance().error("[DDSManager_Bytes] 创建 Ping DataReader 失败");
+                return false;
+            }
+        }
+        else if (ping_callback || end_callback) {
             void* mem = GloMemPool::allocate(sizeof(MyDataReaderListener), __FILE__, __LINE__);
             if (!mem) return false;
-            m_ping_listener_ = new (mem) MyDataReaderListener(std::move(ping_callback), std::move(end_callback));
+            m_ping_listener_ = new (mem) MyDataReaderListener(std::move(ping_callback), std::move(end_callback), verifier, dispatcher_, &match_tracker_);
 
             m_ping_reader = participant_->create_datareader_with_topic_and_qos_profile(
                 ping_topic_->get_name(), type_support,
@@ -318,11 +640,12 @@ bool DDSManager_Bytes::initialize_latency(
         m_pong_writer = participant_->create_datawriter_with_topic_and_qos_profile(
             pong_topic_->get_name(), type_support,
             "default_lib", "default_profile", data_writer_qos_name_.c_str(),
-            nullptr, DDS::STATUS_MASK_NONE);
+            match_tracker_.writerListener(), DDS::PUBLICATION_MATCHED_STATUS);
         if (!m_pong_writer) {
             Logger::getInstance().error("[DDSManager_Bytes] 创建 Pong DataWriter 失败");
             return false;
         }
+        m_pong_typed_writer = dynamic_cast<BytesWriter*>(m_pong_writer);
 
         Logger::getInstance().logAndPrint("[DDSManager_Bytes] 时延模式（Responder）初始化完成：Ping Reader + Pong Writer");
     }
@@ -339,12 +662,21 @@ bool DDSManager_Bytes::initialize_latency(
 void DDSManager_Bytes::shutdown() {
     if (!is_initialized_ || !factory_) return;
 
+    // 轮询线程仍持有 Reader，须先于 Participant 删除前停止
+    stop_pollers();
+
     if (participant_) {
         participant_->delete_contained_entities();
         factory_->delete_participant(participant_);
         participant_ = nullptr;
     }
 
+    // 通知模式的 Listener 内嵌在轮询器中，Reader 删除后才能释放
+    release_pollers();
+
+    // 不再有新样本进入，处理完队列中剩余样本后停止分发层
+    release_dispatcher();
+
     // 清理所有 listener 内存（若已分配）
     auto safe_delete_listener = [](MyDataReaderListener* ptr) {
         if (ptr) {
@@ -373,11 +705,118 @@ void DDSManager_Bytes::shutdown() {
     m_ping_reader = nullptr;
     m_pong_writer = nullptr;
     m_pong_reader = nullptr;
+    m_ping_typed_writer = nullptr;
+    m_pong_typed_writer = nullptr;
+    m_sender_writers.clear();
 
     is_initialized_ = false;
     Logger::getInstance().logAndPrint("[DDSManager_Bytes] 已关闭");
 }
 
+// -------------------------------
+// 轮询接收（m_useTaskNextSample）
+// -------------------------------
+
+DDS::DataReader* DDSManager_Bytes::create_polled_reader(
+    const char* topic_name,
+    OnDataReceivedCallback_Bytes data_cb,
+    OnEndOfRoundCallback end_cb,
+    SampleVerifier* verifier
+) {
+    void* mem = GloMemPool::allocate(sizeof(ReaderPoller), __FILE__, __LINE__);
+    if (!mem) {
+        Logger::getInstance().error("[DDSManager_Bytes] 分配轮询器内存失败");
+        return nullptr;
+    }
+    ReaderPoller* poller = new (mem) ReaderPoller(
+        std::move(data_cb), std::move(end_cb), verifier, dispatcher_, &match_tracker_, take_batch_size_, poll_idle_us_, use_data_arrived_);
+    m_pollers_.push_back(poller);   // 失败时由 release_pollers() 统一释放
+
+    DDS::DataReader* reader = participant_->create_datareader_with_topic_and_qos_profile(
+        topic_name, DDS::BytesTypeSupport::get_instance(),
+        "default_lib", "default_profile", data_reader_qos_name_.c_str(),
+        poller->listener(), poller->listener_mask());
+    if (!reader || !poller->start(reader)) {
+        return nullptr;
+    }
+
+    std::string idle_desc;
+    if (use_data_arrived_) {
+        idle_desc = "等待 DATA_AVAILABLE 通知";
+    }
+    else {
+        idle_desc = poll_idle_us_ > 0 ? "休眠 " + std::to_string(poll_idle_us_) + "us" : std::string("忙轮询");
+    }
+    Logger::getInstance().logAndPrint(
+        "[DDSManager_Bytes] 接收线程已启动 | 批量: " + std::to_string(std::max(take_batch_size_, 1)) +
+        (take_batch_size_ <= 1 ? " (take_next_sample)" : " (take)") +
+        " | 无数据时: " + idle_desc);
+    return reader;
+}
+
+// -------------------------------
+// 接收分发（m_dispatchMode）
+// -------------------------------
+
+bool DDSManager_Bytes::setup_dispatcher(const OnDataReceivedCallback_Bytes& data_cb, SampleVerifier* verifier, int worker_limit) {
+    release_dispatcher();
+    if (dispatch_mode_ == ReceiveDispatcher::Mode::Inline) {
+        return true;
+    }
+
+    int workers = dispatch_workers_;
+    if (worker_limit > 0 && dispatch_mode_ == ReceiveDispatcher::Mode::WorkStealing && workers > worker_limit) {
+        Logger::getInstance().logAndPrint(
+            "[DDSManager_Bytes] 时延测试回调不可并发，pool 工作线程数由 " + std::to_string(workers) +
+            " 限制为 " + std::to_string(worker_limit));
+        workers = worker_limit;
+    }
+
+    void* mem = GloMemPool::allocate(sizeof(ReceiveDispatcher), __FILE__, __LINE__);
+    if (!mem) {
+        Logger::getInstance().error("[DDSManager_Bytes] 分配接收分发器内存失败");
+        return false;
+    }
+    dispatcher_ = new (mem) ReceiveDispatcher(dispatch_mode_, workers, dispatch_queue_size_, dispatch_slot_bytes_);
+
+    // 校验随数据回调一起移到工作线程，DDS 接收线程只负责拷贝入队
+    OnDataReceivedCallback_Bytes cb = data_cb;
+    return dispatcher_->start([cb, verifier](const DDS::Bytes& sample, const DDS::SampleInfo& info) {
+        if (verifier) {
+            verifier->verify(sample.value.get_contiguous_buffer(), sample.value.length(), sizeof(PacketHeader));
+        }
+        if (cb) {
+            cb(sample, info);
+        }
+    });
+}
+
+void DDSManager_Bytes::release_dispatcher() {
+    if (!dispatcher_) return;
+
+    dispatcher_->stop();
+    Logger::getInstance().logAndPrint(
+        std::string("[DDSManager_Bytes] 接收分发统计（") + ReceiveDispatcher::modeName(dispatcher_->mode()) + "）| " +
+        formatDispatchStats(dispatcher_->snapshot()));
+    dispatcher_->~ReceiveDispatcher();
+    GloMemPool::deallocate(dispatcher_);
+    dispatcher_ = nullptr;
+}
+
+void DDSManager_Bytes::stop_pollers() {
+    for (ReaderPoller* poller : m_pollers_) {
+        poller->stop();
+    }
+}
+
+void DDSManager_Bytes::release_pollers() {
+    for (ReaderPoller* poller : m_pollers_) {
+        poller->~ReaderPoller();
+        GloMemPool::deallocate(poller);
+    }
+    m_pollers_.clear();
+}
+
 // -------------------------------
 // prepare/cleanup 数据
 // -------------------------------
@@ -425,12 +864,11 @@ bool DDSManager_Bytes::prepareBytesData(
 
     PacketHeader* hdr = reinterpret_cast<PacketHeader*>(buffer);
     hdr->sequence = sequence;
+    hdr->round = 0;
     hdr->timestamp = timestamp;
     hdr->packet_type = 0;
 
-    for (DDS_ULong i = header_size; i < ul_size; ++i) {
-        sample.value[i] = static_cast<DDS::Octet>((i + sequence) % 255);
-    }
+    PayloadFactory::instance().fill(buffer, header_size, ul_size);
     sample.value._length = ul_size;
 
     return true;
@@ -462,6 +900,7 @@ bool DDSManager_Bytes::prepareEndBytesData(DDS::Bytes& sample, int minSize) {
 
     PacketHeader* hdr = reinterpret_cast<PacketHeader*>(buffer);
     hdr->sequence = 0xFFFFFFFF;
+    hdr->round = 0;
     hdr->timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::steady_clock::now().time_since_epoch()
     ).count();
@@ -479,6 +918,44 @@ void DDSManager_Bytes::cleanupBytesData(DDS::Bytes& sample) {
     DDS_OctetSeq_finalize(&sample.value);
 }
 
+bool DDSManager_Bytes::prepareReusableBytesData(DDS::Bytes& sample, int capacity) {
+    const size_t header_size = sizeof(PacketHeader);
+    DDS_ULong ul_size = static_cast<DDS_ULong>(capacity);
+    if (ul_size < header_size) ul_size = static_cast<DDS_ULong>(header_size);
+
+    DDS_Octet* buffer = static_cast<DDS_Octet*>(
+        GloMemPool::allocate(ul_size * sizeof(DDS_Octet), __FILE__, __LINE__)
+        );
+    if (!buffer) {
+        Logger::getInstance().error("[DDSManager_Bytes] 可复用样本内存分配失败，大小: " + std::to_string(ul_size));
+        return false;
+    }
+
+    DDS_OctetSeq_initialize(&sample.value);
+    if (!DDS_OctetSeq_loan_contiguous(&sample.value, buffer, ul_size, ul_size)) {
+        GloMemPool::deallocate(buffer);
+        DDS_OctetSeq_finalize(&sample.value);
+        Logger::getInstance().error("[DDSManager_Bytes] 可复用样本租借内存失败");
+        return false;
+    }
+
+    PacketHeader* hdr = reinterpret_cast<PacketHeader*>(buffer);
+    hdr->sequence = 0;
+    hdr->round = 0;
+    hdr->timestamp = 0;
+    hdr->packet_type = 0;
+    PayloadFactory::instance().fill(buffer, header_size, ul_size);
+    sample.value._length = ul_size;
+    return true;
+}
+
+void DDSManager_Bytes::releaseReusableBytesData(DDS::Bytes& sample) {
+    // 租借的缓冲区不归序列所有，finalize 后需自行归还内存池
+    DDS_Octet* buffer = sample.value.get_contiguous_buffer();
+    DDS_OctetSeq_finalize(&sample.value);
+    GloMemPool::deallocate(buffer);
+}
+
 std::string DDSManager_Bytes::make_ping_topic_name() const {
     return base_topic_name_ + "_Ping";
 }
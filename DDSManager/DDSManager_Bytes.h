@@ -7,16 +7,20 @@
 #include "ZRDDSDataWriter.h"
 #include "DomainParticipant.h"
 #include "DomainParticipantFactory.h"
+#include "SampleVerifier.h"
+#include "ReceiveDispatcher.h"
+#include "MatchTracker.h"
 
 #include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 class DDSManager_Bytes {
 public:
     using OnDataReceivedCallback_Bytes = std::function<void(const DDS::Bytes&, const DDS::SampleInfo&)>;
-    using OnEndOfRoundCallback = std::function<void()>;
+    using OnEndOfRoundCallback = std::function<void(uint32_t round)>;   // round：结束包包头中的轮次标记
 
     DDSManager_Bytes(const ConfigData& config, const std::string& xml_qos_file_path);
     ~DDSManager_Bytes();
@@ -54,6 +58,15 @@ public:
     DDS::DataWriter* get_Pong_data_writer() const { return m_pong_writer; }
     DDS::DataReader* get_Pong_data_reader() const { return m_pong_reader; }
 
+    // 时延用：创建实体时已完成类型转换的 Writer，热路径上无需 dynamic_cast
+    using BytesWriter = DDS::ZRDDSDataWriter<DDS::Bytes>;
+    BytesWriter* get_Ping_typed_writer() const { return m_ping_typed_writer; }
+    BytesWriter* get_Pong_typed_writer() const { return m_pong_typed_writer; }
+
+    // 吞吐多线程发送（m_sendThreadNum > 1）：独立 Writer 时每个发送线程一个，[0] 即 get_data_writer()；
+    // m_shareWriter 时只有一个，由所有线程共用
+    const std::vector<BytesWriter*>& get_sender_writers() const { return m_sender_writers; }
+
     // 数据准备
     bool prepareBytesData(
         DDS::Bytes& sample,
@@ -65,6 +78,21 @@ public:
     bool prepareEndBytesData(DDS::Bytes& sample, int minSize);
     void cleanupBytesData(DDS::Bytes& sample);
 
+    // 可复用样本：一次性分配 capacity 字节并填充负载，发送前只需改写包头和 _length
+    bool prepareReusableBytesData(DDS::Bytes& sample, int capacity);
+    void releaseReusableBytesData(DDS::Bytes& sample);
+
+    // m_checkSample：监听线程对收到的数据样本做完整性校验，每轮初始化时清零
+    const SampleVerifier& sample_verifier() const { return sample_verifier_; }
+
+    // 本 Manager 创建的 Writer / Reader 的匹配状态，由匹配回调驱动，每次初始化时清零
+    MatchTracker& match_tracker() { return match_tracker_; }
+
+    // m_dispatchMode 为 pool 且工作线程多于 1 个时，数据回调会被并发调用
+    bool concurrent_dispatch() const {
+        return dispatch_mode_ == ReceiveDispatcher::Mode::WorkStealing && dispatch_workers_ > 1;
+    }
+
 private:
     // === 配置字段 ===
     int domain_id_;
@@ -76,6 +104,16 @@ private:
     std::string data_reader_qos_name_;
     std::string xml_qos_file_path_;
     bool is_positive_role_;
+    int send_thread_num_;
+    bool share_writer_;
+    bool use_polling_;                    // m_useTaskNextSample / m_useDataArrived：专用线程 take 取数，替代 on_process_sample
+    bool use_data_arrived_;               // m_useDataArrived：取空后等待 DATA_AVAILABLE 通知，而非轮询
+    ReceiveDispatcher::Mode dispatch_mode_;
+    int dispatch_workers_;
+    int dispatch_queue_size_;
+    size_t dispatch_slot_bytes_;          // 分发槽位大小，取各轮 m_maxSize 的最大值
+    int take_batch_size_;
+    int poll_idle_us_;
 
     // === DDS 实体 ===
     DDS::DomainParticipantFactory* factory_ = nullptr;
@@ -93,6 +131,11 @@ private:
     DDS::DataReader* m_ping_reader = nullptr;
     DDS::DataWriter* m_pong_writer = nullptr;
     DDS::DataReader* m_pong_reader = nullptr;
+    BytesWriter* m_ping_typed_writer = nullptr;
+    BytesWriter* m_pong_typed_writer = nullptr;
+
+    // 🔹 多线程发送用的 Writer 列表（同一 Topic）
+    std::vector<BytesWriter*> m_sender_writers;
 
     // Listener
     class MyDataReaderListener;
@@ -100,11 +143,34 @@ private:
     MyDataReaderListener* m_pong_listener_ = nullptr;
     MyDataReaderListener* m_throughput_listener_ = nullptr;  // 原来的 listener_
 
+    // 轮询接收器（每个 Reader 一个线程）
+    class ReaderPoller;
+    std::vector<ReaderPoller*> m_pollers_;
+
+    // 接收分发层（m_dispatchMode 非 inline 时创建，Listener / 轮询器共用）
+    ReceiveDispatcher* dispatcher_ = nullptr;
+
+    SampleVerifier sample_verifier_;
+    MatchTracker match_tracker_;
+
     bool is_initialized_ = false;
 
     // === 内部辅助函数 ===
     bool create_type_and_participant();
 
+    DDS::DataReader* create_polled_reader(
+        const char* topic_name,
+        OnDataReceivedCallback_Bytes data_cb,
+        OnEndOfRoundCallback end_cb,
+        SampleVerifier* verifier
+    );
+    void stop_pollers();
+    void release_pollers();
+
+    // worker_limit > 0 时限制 pool 模式的工作线程数（时延测试的回调不可并发）
+    bool setup_dispatcher(const OnDataReceivedCallback_Bytes& data_cb, SampleVerifier* verifier, int worker_limit = 0);
+    void release_dispatcher();
+
     // 分开创建不同模式的实体
     bool create_throughput_entities(OnDataReceivedCallback_Bytes data_cb, OnEndOfRoundCallback end_cb);
     bool create_latency_entities(
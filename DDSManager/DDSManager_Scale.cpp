@@ -0,0 +1,381 @@
+﻿// DDSManager_Scale.cpp
+#include "DDSManager_Scale.h"
+#include "Logger.h"
+#include "GloMemPool.h"
+#include "PayloadFactory.h"
+#include "ResourceUtilization.h"
+#include "PacketHeader.h"
+
+#include "ZRDDSTypeSupport.h"
+#include "ZRBuiltinTypesTypeSupport.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+namespace {
+    // 按轮次取值：数组不足时沿用最后一个，为空时返回默认值
+    int valueAt(const std::vector<int>& vec, int round_index, int default_value) {
+        if (vec.empty()) return default_value;
+        size_t idx = std::min(static_cast<size_t>(std::max(round_index, 0)), vec.size() - 1);
+        return vec[idx];
+    }
+
+    void loadRange(const std::vector<int>& range, int& begin, int& end) {
+        begin = range.size() > 0 ? std::max(range[0], 0) : 0;
+        end = range.size() > 1 ? std::max(range[1], begin) : begin;
+    }
+}
+
+// ========================
+// ScaleLayout
+// ========================
+
+ScaleLayout ScaleLayout::fromConfig(const ConfigData& config, int round_index) {
+    ScaleLayout layout;
+    layout.domain_ids = config.m_domainIds;
+    if (layout.domain_ids.empty()) {
+        layout.domain_ids.push_back(config.m_domainId);
+    }
+    layout.participants_per_domain = std::max(valueAt(config.m_dpNum, round_index, 1), 1);
+
+    loadRange(config.m_writerTopicRange, layout.writer_topic_begin, layout.writer_topic_end);
+    loadRange(config.m_readerTopicRange, layout.reader_topic_begin, layout.reader_topic_end);
+    if (layout.writer_topic_end > layout.writer_topic_begin) {
+        layout.writers_per_topic = std::max(valueAt(config.m_writerNum, round_index, 1), 1);
+    }
+    if (layout.reader_topic_end > layout.reader_topic_begin) {
+        layout.readers_per_topic = std::max(valueAt(config.m_readerNum, round_index, 1), 1);
+    }
+    return layout;
+}
+
+std::string ScaleLayout::describe() const {
+    std::ostringstream oss;
+    oss << "Domain: " << domain_ids.size() << " 个 | Participant: " << participantCount()
+        << " (每 Domain " << participants_per_domain << ")"
+        << " | Writer: " << writerCount()
+        << " (Topic [" << writer_topic_begin << ", " << writer_topic_end << ") × " << writers_per_topic << ")"
+        << " | Reader: " << readerCount()
+        << " (Topic [" << reader_topic_begin << ", " << reader_topic_end << ") × " << readers_per_topic << ")";
+    return oss.str();
+}
+
+// ========================
+// 内部 Listener：每个 Reader 一个，携带 reader_index
+// ========================
+
+class DDSManager_Scale::ScaleReaderListener
+    : public virtual DDS::SimpleDataReaderListener<DDS::Bytes, DDS::BytesSeq, DDS::ZRDDSDataReader<DDS::Bytes, DDS::BytesSeq>>
+{
+public:
+    ScaleReaderListener(size_t reader_index, MatchTracker* matches, const OnScaleDataCallback& data_cb, const OnScaleEndCallback& end_cb)
+        : reader_index_(reader_index), matches_(matches), onDataReceived_(data_cb), onEndOfRound_(end_cb) {
+    }
+
+    void on_subscription_matched(DDS::DataReader* reader, const DDS::SubscriptionMatchedStatus& status) override {
+        matches_->update(reader, status.current_count);
+    }
+
+    void on_process_sample(
+        DDS::DataReader*,
+        const DDS::Bytes& sample,
+        const DDS::SampleInfo& info
+    ) override {
+        static thread_local bool thread_registered = false;
+        if (!thread_registered) {
+            ResourceUtilization::instance().registerCurrentThread("dds_listener");
+            thread_registered = true;
+        }
+
+        if (!info.valid_data || sample.value.length() < sizeof(PacketHeader)) {
+            return;
+        }
+        const uint8_t* buffer = sample.value.get_contiguous_buffer();
+        if (!buffer) {
+            return;
+        }
+
+        const PacketHeader* hdr = reinterpret_cast<const PacketHeader*>(buffer);
+        if (hdr->packet_type == 1) {
+            if (onEndOfRound_) {
+                onEndOfRound_(reader_index_, hdr->source);
+            }
+            return;
+        }
+        if (onDataReceived_) {
+            onDataReceived_(reader_index_, sample, info);
+        }
+    }
+
+private:
+    size_t reader_index_;
+    MatchTracker* matches_;
+    OnScaleDataCallback onDataReceived_;
+    OnScaleEndCallback onEndOfRound_;
+};
+
+// ========================
+// 构造 & 析构
+// ========================
+
+DDSManager_Scale::DDSManager_Scale(const ConfigData& config, const std::string& xml_qos_file_path)
+    : base_topic_name_(config.m_topicName.empty() ? "scale_topic" : config.m_topicName)
+    , participant_factory_qos_name_(config.m_dpfQosName)
+    , participant_qos_name_(config.m_dpQosName)
+    , data_writer_qos_name_(config.m_writerQosName)
+    , data_reader_qos_name_(config.m_readerQosName)
+    , xml_qos_file_path_(xml_qos_file_path)
+{
+    PayloadFactory::instance().configure(config.m_payloadPattern);
+}
+
+DDSManager_Scale::~DDSManager_Scale() {
+    if (is_initialized_) {
+        shutdown();
+    }
+}
+
+std::string DDSManager_Scale::make_topic_name(int topic_index) const {
+    return base_topic_name_ + "_" + std::to_string(topic_index);
+}
+
+// ========================
+// initialize - 按布局 / 实体计划创建全部实体
+// ========================
+
+bool DDSManager_Scale::initialize(const ScaleLayout& layout, OnScaleDataCallback data_callback, OnScaleEndCallback end_callback) {
+    Logger::getInstance().logAndPrint("[DDSManager_Scale] 开始初始化 | " + layout.describe());
+
+    EntityPlan plan;
+    plan.reserve(static_cast<size_t>(layout.participantCount()));
+    for (int domain_id : layout.domain_ids) {
+        for (int d = 0; d < layout.participants_per_domain; ++d) {
+            ParticipantPlan participant;
+            participant.domain_id = domain_id;
+            for (int t = layout.writer_topic_begin; t < layout.writer_topic_end; ++t) {
+                for (int w = 0; w < layout.writers_per_topic; ++w) {
+                    participant.writers.push_back({ t, make_topic_name(t), std::string() });
+                }
+            }
+            for (int t = layout.reader_topic_begin; t < layout.reader_topic_end; ++t) {
+                for (int r = 0; r < layout.readers_per_topic; ++r) {
+                    participant.readers.push_back({ t, make_topic_name(t), std::string() });
+                }
+            }
+            plan.push_back(std::move(participant));
+        }
+    }
+    return initialize(plan, std::move(data_callback), std::move(end_callback));
+}
+
+bool DDSManager_Scale::initialize(const EntityPlan& plan, OnScaleDataCallback data_callback, OnScaleEndCallback end_callback) {
+    const char* p_lib_name = "default_lib";
+    const char* p_prof_name = "default_profile";
+    const char* pf_qos_name = participant_factory_qos_name_.empty() ? nullptr : participant_factory_qos_name_.c_str();
+
+    // 计划中的 QoS 名为空时回落到配置默认值，仍为空则交给 ZRDDS 默认 QoS
+    auto pick_qos = [](const std::string& planned, const std::string& fallback) -> const char* {
+        if (!planned.empty()) return planned.c_str();
+        return fallback.empty() ? nullptr : fallback.c_str();
+        };
+
+    factory_ = DDS::DomainParticipantFactory::get_instance_w_profile(
+        xml_qos_file_path_.c_str(), p_lib_name, p_prof_name, pf_qos_name);
+    if (!factory_) {
+        Logger::getInstance().error("[DDSManager_Scale] 获取 DomainParticipantFactory 失败");
+        return false;
+    }
+
+    DDS::BytesTypeSupport* type_support = DDS::BytesTypeSupport::get_instance();
+    if (!type_support) {
+        Logger::getInstance().error("[DDSManager_Scale] 获取 BytesTypeSupport 实例失败");
+        return false;
+    }
+
+    size_t writer_total = 0;
+    size_t reader_total = 0;
+    for (const ParticipantPlan& p : plan) {
+        writer_total += p.writers.size();
+        reader_total += p.readers.size();
+    }
+    match_tracker_.reset();
+    participants_.reserve(plan.size());
+    writers_.reserve(writer_total);
+    readers_.reserve(reader_total);
+    listeners_.reserve(reader_total);
+
+    for (const ParticipantPlan& p : plan) {
+        const int participant_index = static_cast<int>(participants_.size());
+        DDS::DomainParticipant* participant = factory_->create_participant_with_qos_profile(
+            p.domain_id, p_lib_name, p_prof_name, pick_qos(p.qos_name, participant_qos_name_),
+            nullptr, DDS::STATUS_MASK_NONE);
+        if (!participant) {
+            Logger::getInstance().error("[DDSManager_Scale] 创建 DomainParticipant 失败 | domain=" +
+                std::to_string(p.domain_id) + " | 序号=" + std::to_string(participant_index));
+            shutdown();
+            return false;
+        }
+        participants_.push_back(participant);
+
+        const char* registered_type_name = type_support->get_type_name();
+        if (type_support->register_type(participant, registered_type_name) != DDS::RETCODE_OK) {
+            Logger::getInstance().error("[DDSManager_Scale] 注册类型失败");
+            shutdown();
+            return false;
+        }
+
+        // 同一 Participant 内同名 Topic 只创建一次
+        std::map<std::string, DDS::Topic*> topics;
+        auto get_topic = [&](const std::string& topic_name) -> DDS::Topic* {
+            auto it = topics.find(topic_name);
+            if (it != topics.end()) return it->second;
+            DDS::Topic* topic = participant->create_topic(
+                topic_name.c_str(), registered_type_name,
+                DDS::TOPIC_QOS_DEFAULT, nullptr, DDS::STATUS_MASK_NONE);
+            if (!topic) {
+                Logger::getInstance().error("[DDSManager_Scale] 创建 Topic '" + topic_name + "' 失败");
+                return nullptr;
+            }
+            topics.emplace(topic_name, topic);
+            return topic;
+            };
+
+        for (const EndpointPlan& w : p.writers) {
+            DDS::Topic* topic = get_topic(w.topic_name);
+            if (!topic) {
+                shutdown();
+                return false;
+            }
+            DDS::DataWriter* writer = participant->create_datawriter_with_topic_and_qos_profile(
+                topic->get_name(), type_support,
+                p_lib_name, p_prof_name, pick_qos(w.qos_name, data_writer_qos_name_),
+                match_tracker_.writerListener(), DDS::PUBLICATION_MATCHED_STATUS);
+            if (!writer) {
+                Logger::getInstance().error("[DDSManager_Scale] 创建 DataWriter 失败 | topic=" + w.topic_name);
+                shutdown();
+                return false;
+            }
+            WriterEntry entry;
+            entry.participant = participant_index;
+            entry.topic = w.flow;
+            entry.writer = writer;
+            entry.typed_writer = dynamic_cast<BytesWriter*>(writer);
+            writers_.push_back(entry);
+        }
+
+        for (const EndpointPlan& r : p.readers) {
+            DDS::Topic* topic = get_topic(r.topic_name);
+            if (!topic) {
+                shutdown();
+                return false;
+            }
+            void* mem = GloMemPool::allocate(sizeof(ScaleReaderListener), __FILE__, __LINE__);
+            if (!mem) {
+                Logger::getInstance().error("[DDSManager_Scale] 分配监听器内存失败");
+                shutdown();
+                return false;
+            }
+            ScaleReaderListener* listener = new (mem) ScaleReaderListener(readers_.size(), &match_tracker_, data_callback, end_callback);
+            listeners_.push_back(listener);
+
+            DDS::DataReader* reader = participant->create_datareader_with_topic_and_qos_profile(
+                topic->get_name(), type_support,
+                p_lib_name, p_prof_name, pick_qos(r.qos_name, data_reader_qos_name_),
+                listener, DDS::DATA_AVAILABLE_STATUS | DDS::SUBSCRIPTION_MATCHED_STATUS);
+            if (!reader) {
+                Logger::getInstance().error("[DDSManager_Scale] 创建 DataReader 失败 | topic=" + r.topic_name);
+                shutdown();
+                return false;
+            }
+            ReaderEntry entry;
+            entry.participant = participant_index;
+            entry.topic = r.flow;
+            entry.reader = reader;
+            readers_.push_back(entry);
+        }
+    }
+
+    is_initialized_ = true;
+    Logger::getInstance().logAndPrint("[DDSManager_Scale] 初始化成功 | Participant: " + std::to_string(participants_.size()) +
+        " | Writer: " + std::to_string(writers_.size()) + " | Reader: " + std::to_string(readers_.size()));
+    return true;
+}
+
+void DDSManager_Scale::shutdown() {
+    if (factory_) {
+        for (DDS::DomainParticipant* participant : participants_) {
+            participant->delete_contained_entities();
+            factory_->delete_participant(participant);
+        }
+    }
+    participants_.clear();
+    writers_.clear();
+    readers_.clear();
+
+    // Listener 在 Reader 删除之后释放
+    for (ScaleReaderListener* listener : listeners_) {
+        listener->~ScaleReaderListener();
+        GloMemPool::deallocate(listener);
+    }
+    listeners_.clear();
+
+    if (is_initialized_) {
+        Logger::getInstance().logAndPrint("[DDSManager_Scale] 已关闭");
+    }
+    is_initialized_ = false;
+}
+
+// ========================
+// 样本准备
+// ========================
+
+bool DDSManager_Scale::prepareReusableBytesData(DDS::Bytes& sample, int capacity) {
+    const size_t header_size = sizeof(PacketHeader);
+    DDS_ULong ul_size = static_cast<DDS_ULong>(capacity);
+    if (ul_size < header_size) ul_size = static_cast<DDS_ULong>(header_size);
+
+    DDS_Octet* buffer = static_cast<DDS_Octet*>(
+        GloMemPool::allocate(ul_size * sizeof(DDS_Octet), __FILE__, __LINE__)
+        );
+    if (!buffer) {
+        Logger::getInstance().error("[DDSManager_Scale] 可复用样本内存分配失败，大小: " + std::to_string(ul_size));
+        return false;
+    }
+
+    DDS_OctetSeq_initialize(&sample.value);
+    if (!DDS_OctetSeq_loan_contiguous(&sample.value, buffer, ul_size, ul_size)) {
+        GloMemPool::deallocate(buffer);
+        DDS_OctetSeq_finalize(&sample.value);
+        Logger::getInstance().error("[DDSManager_Scale] 可复用样本租借内存失败");
+        return false;
+    }
+
+    PacketHeader* hdr = reinterpret_cast<PacketHeader*>(buffer);
+    hdr->sequence = 0;
+    hdr->round = 0;
+    hdr->timestamp = 0;
+    hdr->packet_type = 0;
+    hdr->source = 0;
+    PayloadFactory::instance().fill(buffer, header_size, ul_size);
+    sample.value._length = ul_size;
+    return true;
+}
+
+void DDSManager_Scale::releaseReusableBytesData(DDS::Bytes& sample) {
+    // 租借的缓冲区不归序列所有，finalize 后需自行归还内存池
+    DDS_Octet* buffer = sample.value.get_contiguous_buffer();
+    DDS_OctetSeq_finalize(&sample.value);
+    GloMemPool::deallocate(buffer);
+}
+
+bool DDSManager_Scale::prepareEndBytesData(DDS::Bytes& sample) {
+    if (!prepareReusableBytesData(sample, static_cast<int>(sizeof(PacketHeader)))) {
+        return false;
+    }
+    PacketHeader* hdr = reinterpret_cast<PacketHeader*>(sample.value.get_contiguous_buffer());
+    hdr->sequence = 0xFFFFFFFF;
+    hdr->packet_type = 1; // 结束包标记
+    return true;
+}
@@ -0,0 +1,135 @@
+﻿// DDSManager_Scale.h
+#pragma once
+
+#include "ConfigData.h"
+#include "MatchTracker.h"
+#include "ZRBuiltinTypes.h"
+#include "ZRDDSDataReader.h"
+#include "ZRDDSDataWriter.h"
+#include "DomainParticipant.h"
+#include "DomainParticipantFactory.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief scale:: 模式的实体布局（由配置与轮次计算）
+ *
+ * 每个 m_domainIds 中的 Domain 创建 m_dpNum 个 Participant；
+ * 每个 Participant 对 m_writerTopicRange = [begin, end) 中的每个 Topic 创建 m_writerNum 个 Writer，
+ * 对 m_readerTopicRange 中的每个 Topic 创建 m_readerNum 个 Reader（区间非空时 0 按 1 处理）。
+ * Topic 名为 "<m_topicName>_<序号>"。m_dpNum / m_writerNum / m_readerNum 按轮次取值，不足时沿用最后一个。
+ */
+struct ScaleLayout {
+    std::vector<int> domain_ids;
+    int participants_per_domain = 1;
+    int writer_topic_begin = 0;
+    int writer_topic_end = 0;
+    int writers_per_topic = 0;
+    int reader_topic_begin = 0;
+    int reader_topic_end = 0;
+    int readers_per_topic = 0;
+
+    static ScaleLayout fromConfig(const ConfigData& config, int round_index);
+
+    int participantCount() const { return static_cast<int>(domain_ids.size()) * participants_per_domain; }
+    int writersPerParticipant() const { return (writer_topic_end - writer_topic_begin) * writers_per_topic; }
+    int readersPerParticipant() const { return (reader_topic_end - reader_topic_begin) * readers_per_topic; }
+    int writerCount() const { return participantCount() * writersPerParticipant(); }
+    int readerCount() const { return participantCount() * readersPerParticipant(); }
+    std::string describe() const;
+};
+
+/**
+ * @brief 通用实体计划：逐个 Participant 列出要创建的 Writer / Reader。
+ *
+ * ScaleLayout 与 traffic:: 拓扑都展开成该计划再交给 DDSManager_Scale::initialize；
+ * QoS 名为空时使用管理器构造时配置中的默认 QoS。
+ */
+struct EndpointPlan {
+    int flow = 0;                   // 流序号（scale:: 为 Topic 序号，traffic:: 为端点配置序号）
+    std::string topic_name;
+    std::string qos_name;
+};
+
+struct ParticipantPlan {
+    int domain_id = 0;
+    std::string qos_name;
+    std::vector<EndpointPlan> writers;
+    std::vector<EndpointPlan> readers;
+};
+
+using EntityPlan = std::vector<ParticipantPlan>;
+
+/**
+ * @brief 规模测试 DDS 管理器：一个进程内创建 N 个 Participant × M 个 Writer/Reader（DDS::Bytes）。
+ *
+ * 与 DDSManager_Bytes 一样每轮 initialize() / shutdown()；所有 Reader 共用同一组回调，
+ * 通过 reader_index（readers() 中的下标）区分实体。
+ */
+class DDSManager_Scale {
+public:
+    using BytesWriter = DDS::ZRDDSDataWriter<DDS::Bytes>;
+    using OnScaleDataCallback = std::function<void(size_t reader_index, const DDS::Bytes&, const DDS::SampleInfo&)>;
+    // source 为结束包包头中的发送端 Writer 标识，同一 Writer 的重复结束包 source 相同
+    using OnScaleEndCallback = std::function<void(size_t reader_index, uint32_t source)>;
+
+    struct WriterEntry {
+        int participant = 0;            // 所属 Participant 序号
+        int topic = 0;                  // 流序号（EndpointPlan::flow）
+        DDS::DataWriter* writer = nullptr;
+        BytesWriter* typed_writer = nullptr;
+    };
+
+    struct ReaderEntry {
+        int participant = 0;
+        int topic = 0;
+        DDS::DataReader* reader = nullptr;
+    };
+
+    DDSManager_Scale(const ConfigData& config, const std::string& xml_qos_file_path);
+    ~DDSManager_Scale();
+
+    DDSManager_Scale(const DDSManager_Scale&) = delete;
+    DDSManager_Scale& operator=(const DDSManager_Scale&) = delete;
+
+    bool initialize(const ScaleLayout& layout, OnScaleDataCallback data_callback, OnScaleEndCallback end_callback);
+    bool initialize(const EntityPlan& plan, OnScaleDataCallback data_callback, OnScaleEndCallback end_callback);
+    void shutdown();
+
+    bool is_initialized() const { return is_initialized_; }
+    const std::vector<WriterEntry>& writers() const { return writers_; }
+    const std::vector<ReaderEntry>& readers() const { return readers_; }
+    size_t participant_count() const { return participants_.size(); }
+
+    // 端点匹配跟踪：initialize() 时重置，所有 Writer / Reader 的匹配回调都汇入这里
+    MatchTracker& match_tracker() { return match_tracker_; }
+
+    // 可复用样本：一次性分配 capacity 字节并填充负载，发送前只需改写包头和 _length
+    bool prepareReusableBytesData(DDS::Bytes& sample, int capacity);
+    void releaseReusableBytesData(DDS::Bytes& sample);
+    bool prepareEndBytesData(DDS::Bytes& sample);   // 以 releaseReusableBytesData 释放
+
+private:
+    std::string make_topic_name(int topic_index) const;
+
+    std::string base_topic_name_;
+    std::string participant_factory_qos_name_;
+    std::string participant_qos_name_;
+    std::string data_writer_qos_name_;
+    std::string data_reader_qos_name_;
+    std::string xml_qos_file_path_;
+
+    DDS::DomainParticipantFactory* factory_ = nullptr;
+    std::vector<DDS::DomainParticipant*> participants_;
+    std::vector<WriterEntry> writers_;
+    std::vector<ReaderEntry> readers_;
+
+    class ScaleReaderListener;
+    std::vector<ScaleReaderListener*> listeners_;
+
+    MatchTracker match_tracker_;
+
+    bool is_initialized_ = false;
+};
@@ -2,6 +2,10 @@
 #include "DDSManager_ZeroCopyBytes.h"
 #include "Logger.h"
 #include "GloMemPool.h"
+#include "ResourceUtilization.h"
+#include "PayloadFactory.h"
+#include "RealtimeProfile.h"
+#include "PacketHeader.h"
 
 #include "ZRDDSDataReader.h"
 #include "ZRDDSTypeSupport.h"
@@ -14,13 +18,6 @@
 #include <chrono>
 #include <cstring> // for memset
 
-// Packet Header 结构（保持与 Bytes 版一致）
-struct PacketHeader {
-    uint32_t sequence;     // 序列号
-    uint64_t timestamp;    // 发送时间（纳秒）
-    uint8_t  packet_type;  // 0=普通数据, 1=结束包
-};
-
 // 内部 Listener 类 - 使用 ZeroCopyBytes 类型
 class DDSManager_ZeroCopyBytes::MyDataReaderListener
     : public virtual DDS::SimpleDataReaderListener<
@@ -32,8 +29,14 @@ class DDSManager_ZeroCopyBytes::MyDataReaderListener
 public:
     MyDataReaderListener(
         OnDataReceivedCallback_ZC dataCb,
-        OnEndOfRoundCallback endCb
-    ) : onDataReceived_(std::move(dataCb)), onEndOfRound_(std::move(endCb)) {
+        OnEndOfRoundCallback endCb,
+        SampleVerifier* verifier,
+        MatchTracker* matches
+    ) : onDataReceived_(std::move(dataCb)), onEndOfRound_(std::move(endCb)), verifier_(verifier), matches_(matches) {
+    }
+
+    void on_subscription_matched(DDS::DataReader* reader, const DDS::SubscriptionMatchedStatus& status) override {
+        matches_->update(reader, status.current_count);
     }
 
     virtual void on_process_sample(
@@ -41,7 +44,17 @@ public:
         const DDS_ZeroCopyBytes& sample,
         const DDS::SampleInfo& info
     ) override {
-        if (!info.valid_data || sample.userLength < sizeof(PacketHeader)) {
+        // DDS 接收线程首次回调时登记角色，用于每线程 CPU 归因
+        static thread_local bool thread_registered = false;
+        if (!thread_registered) {
+            ResourceUtilization::instance().registerCurrentThread("dds_listener");
+            thread_registered = true;
+        }
+
+        if (!info.valid_data || !sample.userBuffer || sample.userLength < sizeof(PacketHeader)) {
+            if (verifier_ && info.valid_data) {
+                verifier_->recordTruncated();
+            }
             Logger::getInstance().logAndPrint("[DDSManager_ZeroCopyBytes] Invalid or short packet.");
             return;
         }
@@ -51,15 +64,19 @@ public:
         if (hdr->packet_type == 1) {
             Logger::getInstance().logAndPrint(
                 "[DDSManager_ZeroCopyBytes] Received end-of-round packet | seq=" +
-                std::to_string(hdr->sequence) + " | ts=" + std::to_string(hdr->timestamp)
+                std::to_string(hdr->sequence) + " | round=" + std::to_string(hdr->round) +
+                " | ts=" + std::to_string(hdr->timestamp)
             );
             if (onEndOfRound_) {
-                onEndOfRound_();
+                onEndOfRound_(hdr->round);
             }
             return;
         }
 
         // 正常数据包
+        if (verifier_) {
+            verifier_->verify(reinterpret_cast<const uint8_t*>(sample.userBuffer), sample.userLength, sizeof(PacketHeader));
+        }
         if (onDataReceived_) {
             onDataReceived_(sample, info);
         }
@@ -68,6 +85,8 @@ public:
 private:
     OnDataReceivedCallback_ZC onDataReceived_;
     OnEndOfRoundCallback onEndOfRound_;
+    SampleVerifier* verifier_;  // 未开启 m_checkSample 时为 nullptr
+    MatchTracker* matches_;
 };
 
 // 构造函数
@@ -84,12 +103,21 @@ DDSManager_ZeroCopyBytes::DDSManager_ZeroCopyBytes(const ConfigData& config, con
     , max_possible_size_(0)
     , global_buffer_(nullptr)
 {
+    PayloadFactory::instance().configure(config.m_payloadPattern);
+    sample_verifier_.setEnabled(config.m_checkSample);
+    if (config.m_useTaskNextSample || config.m_useDataArrived) {
+        Logger::getInstance().logAndPrint("[DDSManager_ZeroCopyBytes] 警告：轮询/通知接收（m_useTaskNextSample / m_useDataArrived）仅支持 DDS::Bytes，零拷贝模式仍使用 Listener 接收");
+    }
 }
 
 DDSManager_ZeroCopyBytes::~DDSManager_ZeroCopyBytes() {
     if (is_initialized_) {
         shutdown();
     }
+    if (end_buffer_) {
+        GloMemPool::deallocate(end_buffer_);
+        end_buffer_ = nullptr;
+    }
 }
 
 bool DDSManager_ZeroCopyBytes::initialize(
@@ -98,6 +126,10 @@ bool DDSManager_ZeroCopyBytes::initialize(
 ) {
     std::cout << "[DDSManager_ZeroCopyBytes] Initializing DDS entities...\n";
 
+    sample_verifier_.reset();
+    match_tracker_.reset();
+    SampleVerifier* verifier = sample_verifier_.enabled() ? &sample_verifier_ : nullptr;
+
     const char* qosFilePath = xml_qos_file_path_.c_str();
     const char* p_lib_name = "default_lib";
     const char* p_prof_name = "default_profile";
@@ -150,10 +182,13 @@ bool DDSManager_ZeroCopyBytes::initialize(
     // ========== 零拷贝关键步骤：预分配全局缓冲区 ==========
     size_t totalBufferSize = max_possible_size_ + DEFAULT_HEADER_RESERVE;
     global_buffer_ = static_cast<char*>(GloMemPool::allocate(totalBufferSize, __FILE__, __LINE__));
+    ++buffer_generation_;
     if (!global_buffer_) {
         std::cerr << "[DDSManager_ZeroCopyBytes] Failed to allocate global buffer for zero-copy.\n";
         return false;
     }
+    // 开启预缺页时在测试开始前触碰全部页面
+    RealtimeProfile::instance().prefault(global_buffer_, totalBufferSize);
     std::cout << "[DDSManager_ZeroCopyBytes] Allocated global zero-copy buffer of size: " << totalBufferSize << " bytes\n";
 
     // 创建 Writer 或 Reader
@@ -161,7 +196,7 @@ bool DDSManager_ZeroCopyBytes::initialize(
         data_writer_ = participant_->create_datawriter_with_topic_and_qos_profile(
             topic_->get_name(), type_support,
             "default_lib", "default_profile", data_writer_qos_name_.c_str(),
-            nullptr, DDS::STATUS_MASK_NONE);
+            match_tracker_.writerListener(), DDS::PUBLICATION_MATCHED_STATUS);
         if (!data_writer_) {
             GloMemPool::deallocate(global_buffer_);
             global_buffer_ = nullptr;
@@ -178,12 +213,12 @@ bool DDSManager_ZeroCopyBytes::initialize(
             std::cerr << "[DDSManager_ZeroCopyBytes] Memory allocation failed for listener.\n";
             return false;
         }
-        listener_ = new (mem) MyDataReaderListener(std::move(dataCallback), std::move(endCallback));
+        listener_ = new (mem) MyDataReaderListener(std::move(dataCallback), std::move(endCallback), verifier, &match_tracker_);
 
         data_reader_ = participant_->create_datareader_with_topic_and_qos_profile(
             topic_->get_name(), type_support,
             "default_lib", "default_profile", data_reader_qos_name_.c_str(),
-            listener_, DDS::DATA_AVAILABLE_STATUS);
+            listener_, DDS::DATA_AVAILABLE_STATUS | DDS::SUBSCRIPTION_MATCHED_STATUS);
         if (!data_reader_) {
             listener_->~MyDataReaderListener();
             GloMemPool::deallocate(listener_);
@@ -207,6 +242,153 @@ bool DDSManager_ZeroCopyBytes::initialize(
     return true;
 }
 
+// 时延测试专用初始化：Initiator 发 Ping 收 Pong，Responder 收 Ping 发 Pong
+bool DDSManager_ZeroCopyBytes::initialize_latency(
+    OnDataReceivedCallback_ZC ping_callback,
+    OnDataReceivedCallback_ZC pong_callback,
+    OnEndOfRoundCallback end_callback
+) {
+    std::cout << "[DDSManager_ZeroCopyBytes] Initializing DDS entities (latency mode)...\n";
+
+    sample_verifier_.reset();
+    match_tracker_.reset();
+    SampleVerifier* verifier = sample_verifier_.enabled() ? &sample_verifier_ : nullptr;
+
+    const char* qosFilePath = xml_qos_file_path_.c_str();
+    const char* p_lib_name = "default_lib";
+    const char* p_prof_name = "default_profile";
+    const char* pf_qos_name = participant_factory_qos_name_.empty() ? nullptr : participant_factory_qos_name_.c_str();
+    const char* p_qos_name = participant_qos_name_.empty() ? nullptr : participant_qos_name_.c_str();
+
+    factory_ = DDS::DomainParticipantFactory::get_instance_w_profile(
+        qosFilePath, p_lib_name, p_prof_name, pf_qos_name);
+    if (!factory_) {
+        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to get DomainParticipantFactory.\n";
+        return false;
+    }
+
+    participant_ = factory_->create_participant_with_qos_profile(
+        domain_id_, p_lib_name, p_prof_name, p_qos_name, nullptr, DDS::STATUS_MASK_NONE);
+    if (!participant_) {
+        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to create DomainParticipant.\n";
+        return false;
+    }
+
+    DDS::ZeroCopyBytesTypeSupport* type_support = DDS::ZeroCopyBytesTypeSupport::get_instance();
+    if (!type_support) {
+        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to get ZeroCopyBytesTypeSupport instance.\n";
+        return false;
+    }
+
+    const char* registered_type_name = type_support->get_type_name();
+    if (!registered_type_name || strlen(registered_type_name) == 0) {
+        std::cerr << "[DDSManager_ZeroCopyBytes] Type name is null or empty.\n";
+        return false;
+    }
+
+    if (type_support->register_type(participant_, registered_type_name) != DDS::RETCODE_OK) {
+        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to register type '" << registered_type_name << "'.\n";
+        return false;
+    }
+
+    // === 创建 Ping 和 Pong Topic ===
+    const std::string ping_topic_name = make_ping_topic_name();
+    const std::string pong_topic_name = make_pong_topic_name();
+    ping_topic_ = participant_->create_topic(
+        ping_topic_name.c_str(), registered_type_name,
+        DDS::TOPIC_QOS_DEFAULT, nullptr, DDS::STATUS_MASK_NONE);
+    pong_topic_ = participant_->create_topic(
+        pong_topic_name.c_str(), registered_type_name,
+        DDS::TOPIC_QOS_DEFAULT, nullptr, DDS::STATUS_MASK_NONE);
+    if (!ping_topic_ || !pong_topic_) {
+        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to create latency topics.\n";
+        return false;
+    }
+
+    // ========== 预分配全局缓冲区（Ping 与 Pong 共用，按角色只会有一方写入） ==========
+    size_t totalBufferSize = max_possible_size_ + DEFAULT_HEADER_RESERVE;
+    global_buffer_ = static_cast<char*>(GloMemPool::allocate(totalBufferSize, __FILE__, __LINE__));
+    ++buffer_generation_;
+    if (!global_buffer_) {
+        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to allocate global buffer for zero-copy.\n";
+        return false;
+    }
+    // 开启预缺页时在测试开始前触碰全部页面
+    RealtimeProfile::instance().prefault(global_buffer_, totalBufferSize);
+    std::cout << "[DDSManager_ZeroCopyBytes] Allocated global zero-copy buffer of size: " << totalBufferSize << " bytes\n";
+
+    if (role_ == "publisher") {
+        // Initiator: 发 Ping，收 Pong
+        ping_writer_ = participant_->create_datawriter_with_topic_and_qos_profile(
+            ping_topic_->get_name(), type_support,
+            "default_lib", "default_profile", data_writer_qos_name_.c_str(),
+            match_tracker_.writerListener(), DDS::PUBLICATION_MATCHED_STATUS);
+        if (!ping_writer_) {
+            std::cerr << "[DDSManager_ZeroCopyBytes] Failed to create Ping DataWriter.\n";
+            return false;
+        }
+        ping_typed_writer_ = dynamic_cast<ZCWriter*>(ping_writer_);
+
+        if (pong_callback) {
+            void* mem = GloMemPool::allocate(sizeof(MyDataReaderListener), __FILE__, __LINE__);
+            if (!mem) {
+                std::cerr << "[DDSManager_ZeroCopyBytes] Memory allocation failed for Pong listener.\n";
+                return false;
+            }
+            pong_listener_ = new (mem) MyDataReaderListener(std::move(pong_callback), std::move(end_callback), verifier, &match_tracker_);
+
+            pong_reader_ = participant_->create_datareader_with_topic_and_qos_profile(
+                pong_topic_->get_name(), type_support,
+                "default_lib", "default_profile", data_reader_qos_name_.c_str(),
+                pong_listener_, DDS::DATA_AVAILABLE_STATUS | DDS::SUBSCRIPTION_MATCHED_STATUS);
+            if (!pong_reader_) {
+                std::cerr << "[DDSManager_ZeroCopyBytes] Failed to create Pong DataReader.\n";
+                return false;
+            }
+        }
+        std::cout << "[DDSManager_ZeroCopyBytes] Latency mode (Initiator): Ping Writer + Pong Reader.\n";
+    }
+    else if (role_ == "subscriber") {
+        // Responder: 收 Ping，发 Pong（先建 Writer，保证首个 Ping 到达时即可回复）
+        pong_writer_ = participant_->create_datawriter_with_topic_and_qos_profile(
+            pong_topic_->get_name(), type_support,
+            "default_lib", "default_profile", data_writer_qos_name_.c_str(),
+            match_tracker_.writerListener(), DDS::PUBLICATION_MATCHED_STATUS);
+        if (!pong_writer_) {
+            std::cerr << "[DDSManager_ZeroCopyBytes] Failed to create Pong DataWriter.\n";
+            return false;
+        }
+        pong_typed_writer_ = dynamic_cast<ZCWriter*>(pong_writer_);
+
+        if (ping_callback || end_callback) {
+            void* mem = GloMemPool::allocate(sizeof(MyDataReaderListener), __FILE__, __LINE__);
+            if (!mem) {
+                std::cerr << "[DDSManager_ZeroCopyBytes] Memory allocation failed for Ping listener.\n";
+                return false;
+            }
+            ping_listener_ = new (mem) MyDataReaderListener(std::move(ping_callback), std::move(end_callback), verifier, &match_tracker_);
+
+            ping_reader_ = participant_->create_datareader_with_topic_and_qos_profile(
+                ping_topic_->get_name(), type_support,
+                "default_lib", "default_profile", data_reader_qos_name_.c_str(),
+                ping_listener_, DDS::DATA_AVAILABLE_STATUS | DDS::SUBSCRIPTION_MATCHED_STATUS);
+            if (!ping_reader_) {
+                std::cerr << "[DDSManager_ZeroCopyBytes] Failed to create Ping DataReader.\n";
+                return false;
+            }
+        }
+        std::cout << "[DDSManager_ZeroCopyBytes] Latency mode (Responder): Ping Reader + Pong Writer.\n";
+    }
+    else {
+        std::cerr << "[DDSManager_ZeroCopyBytes] Invalid role: " << role_ << "\n";
+        return false;
+    }
+
+    is_initialized_ = true;
+    std::cout << "[DDSManager_ZeroCopyBytes] Latency mode initialization successful.\n";
+    return true;
+}
+
 void DDSManager_ZeroCopyBytes::shutdown() {
     if (!factory_) return;
 
@@ -228,6 +410,32 @@ void DDSManager_ZeroCopyBytes::shutdown() {
         topic_ = nullptr;
         data_writer_ = nullptr;
         data_reader_ = nullptr;
+        ping_topic_ = nullptr;
+        pong_topic_ = nullptr;
+        ping_writer_ = nullptr;
+        ping_reader_ = nullptr;
+        pong_writer_ = nullptr;
+        pong_reader_ = nullptr;
+        ping_typed_writer_ = nullptr;
+        pong_typed_writer_ = nullptr;
+    }
+
+    // 时延 Listener 在 Reader 删除之后释放，避免监听线程访问已析构对象
+    auto safe_delete_listener = [](MyDataReaderListener* ptr) {
+        if (ptr) {
+            ptr->~MyDataReaderListener();
+            GloMemPool::deallocate(ptr);
+        }
+        };
+    safe_delete_listener(ping_listener_);
+    safe_delete_listener(pong_listener_);
+    ping_listener_ = nullptr;
+    pong_listener_ = nullptr;
+
+    // 结束包缓冲区在 Writer 删除之后释放，此前可能仍被借用
+    if (end_buffer_) {
+        GloMemPool::deallocate(end_buffer_);
+        end_buffer_ = nullptr;
     }
 
     is_initialized_ = false;
@@ -251,6 +459,7 @@ bool DDSManager_ZeroCopyBytes::ensureBufferSize(size_t user_data_size) {
 
     // 分配新 buffer
     global_buffer_ = static_cast<char*>(GloMemPool::allocate(required_total, __FILE__, __LINE__));
+    ++buffer_generation_;
     if (!global_buffer_) {
         std::cerr << "[DDSManager_ZeroCopyBytes] Failed to allocate buffer for size: " << required_total << "\n";
         max_possible_size_ = 0;
@@ -295,59 +504,75 @@ bool DDSManager_ZeroCopyBytes::prepareZeroCopyData(DDS_ZeroCopyBytes& sample, in
     // 填充 PacketHeader
     PacketHeader* hdr = reinterpret_cast<PacketHeader*>(sample.userBuffer);
     hdr->sequence = sequence;
+    hdr->round = 0;
     hdr->timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::steady_clock::now().time_since_epoch())
         .count();
     hdr->packet_type = 0; // 普通数据包
 
-    // 填充 payload（可选）
-    for (size_t i = headerSize; i < static_cast<size_t>(dataSize); ++i) {
-        sample.userBuffer[i] = static_cast<DDS::Octet>((i + sequence) % 255);
-    }
-
-    Logger::getInstance().logAndPrint(
-        "prepareZeroCopyData: seq=" + std::to_string(sequence) +
-        " userLength=" + std::to_string(sample.userLength) +
-        " reservedLength=" + std::to_string(DEFAULT_HEADER_RESERVE) +
-        " totalLength=" + std::to_string(sample.totalLength)
-    );
+    // 从模板缓存拷贝 payload
+    PayloadFactory::instance().fill(reinterpret_cast<uint8_t*>(sample.userBuffer), headerSize, static_cast<size_t>(dataSize));
 
     return true;
 }
 
 // 准备结束包（统一格式）
 bool DDSManager_ZeroCopyBytes::prepareEndZeroCopyData(DDS_ZeroCopyBytes& sample) {
-    if (!global_buffer_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Global buffer not allocated.\n";
-        return false;
-    }
-
     const size_t headerSize = sizeof(PacketHeader);
     const size_t dataSize = headerSize;
 
-    if (dataSize > max_possible_size_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] End packet size exceeds limit.\n";
-        return false;
+    // 不复用 global_buffer_：其上的 Ping / 数据样本可能尚未被 DDS 归还
+    if (!end_buffer_) {
+        end_buffer_ = static_cast<char*>(GloMemPool::allocate(dataSize + DEFAULT_HEADER_RESERVE, __FILE__, __LINE__));
+        if (!end_buffer_) {
+            std::cerr << "[DDSManager_ZeroCopyBytes] Failed to allocate end packet buffer.\n";
+            return false;
+        }
     }
 
-    sample.totalLength = max_possible_size_ + DEFAULT_HEADER_RESERVE;
+    sample.totalLength = dataSize + DEFAULT_HEADER_RESERVE;
     sample.reservedLength = DEFAULT_HEADER_RESERVE;
-    sample.value = global_buffer_;
-    sample.userBuffer = global_buffer_ + DEFAULT_HEADER_RESERVE;
+    sample.value = end_buffer_;
+    sample.userBuffer = end_buffer_ + DEFAULT_HEADER_RESERVE;
     sample.userLength = dataSize;
 
     PacketHeader* hdr = reinterpret_cast<PacketHeader*>(sample.userBuffer);
     hdr->sequence = 0xFFFFFFFF;
+    hdr->round = 0;
     hdr->timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::steady_clock::now().time_since_epoch())
         .count();
     hdr->packet_type = 1; // 结束包标记
+    hdr->source = 0;
 
     memset(sample.userBuffer + headerSize, 0, dataSize - headerSize);
 
-    Logger::getInstance().logAndPrint(
-        "prepareEndZeroCopyData: length=" + std::to_string(sample.userLength)
-    );
+    ZR_LOG_DEBUG("DDSManager_ZeroCopyBytes", "prepareEndZeroCopyData: length=" << sample.userLength);
 
     return true;
-}
\ No newline at end of file
+}
+
+// 绑定全局缓冲区并填充一次 payload；调用方此后只改写包头与 userLength
+bool DDSManager_ZeroCopyBytes::prepareReusableZeroCopyData(DDS_ZeroCopyBytes& sample, int capacity) {
+    const size_t headerSize = sizeof(PacketHeader);
+    size_t userSize = static_cast<size_t>(capacity) < headerSize ? headerSize : static_cast<size_t>(capacity);
+    if (!global_buffer_ || userSize > max_possible_size_) {
+        std::cerr << "[DDSManager_ZeroCopyBytes] Reusable sample (" << userSize
+            << ") does not fit global buffer (" << max_possible_size_ << "). Call ensureBufferSize first!\n";
+        return false;
+    }
+
+    sample.totalLength = max_possible_size_ + DEFAULT_HEADER_RESERVE;
+    sample.reservedLength = DEFAULT_HEADER_RESERVE;
+    sample.value = global_buffer_;
+    sample.userBuffer = global_buffer_ + DEFAULT_HEADER_RESERVE;
+    sample.userLength = userSize;
+
+    PacketHeader* hdr = reinterpret_cast<PacketHeader*>(sample.userBuffer);
+    hdr->sequence = 0;
+    hdr->round = 0;
+    hdr->timestamp = 0;
+    hdr->packet_type = 0;
+    PayloadFactory::instance().fill(reinterpret_cast<uint8_t*>(sample.userBuffer), headerSize, userSize);
+    return true;
+}
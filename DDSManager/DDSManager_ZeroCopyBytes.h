@@ -7,9 +7,12 @@
 #include "DomainParticipant.h"
 #include "DomainParticipantFactory.h"
 #include "ZRBuiltinTypes.h"  
+#include "ZRDDSDataWriter.h"
+#include "SampleVerifier.h"
+#include "MatchTracker.h"
 
 using OnDataReceivedCallback_ZC = std::function<void(const DDS_ZeroCopyBytes&, const DDS::SampleInfo&)>;
-using OnEndOfRoundCallback = std::function<void()>;
+using OnEndOfRoundCallback = std::function<void(uint32_t round)>;   // round：结束包包头中的轮次标记
 
 class DDSManager_ZeroCopyBytes {
 public:
@@ -27,6 +30,13 @@ public:
         OnEndOfRoundCallback endCallback = nullptr
     );
 
+    // 初始化时延测试实体（Ping/Pong 两个 Topic）
+    bool initialize_latency(
+        OnDataReceivedCallback_ZC ping_callback = nullptr,
+        OnDataReceivedCallback_ZC pong_callback = nullptr,
+        OnEndOfRoundCallback end_callback = nullptr
+    );
+
     void shutdown();
 
     bool ensureBufferSize(size_t user_data_size);
@@ -37,11 +47,37 @@ public:
     DDS::DataReader* get_data_reader() const { return data_reader_; }
     bool is_initialized() const { return is_initialized_; }
 
+    // 时延测试实体访问接口
+    DDS::DataWriter* get_Ping_data_writer() const { return ping_writer_; }
+    DDS::DataReader* get_Ping_data_reader() const { return ping_reader_; }
+    DDS::DataWriter* get_Pong_data_writer() const { return pong_writer_; }
+    DDS::DataReader* get_Pong_data_reader() const { return pong_reader_; }
+
+    // 创建实体时已完成类型转换的 Writer，热路径上无需 dynamic_cast
+    using ZCWriter = DDS::ZRDDSDataWriter<DDS_ZeroCopyBytes>;
+    ZCWriter* get_Ping_typed_writer() const { return ping_typed_writer_; }
+    ZCWriter* get_Pong_typed_writer() const { return pong_typed_writer_; }
+
+    size_t buffer_capacity() const { return max_possible_size_; }
+
     // 辅助函数：准备 ZeroCopyBytes 测试数据
     // 注意：与 Bytes 不同，这里我们假设缓冲区已预分配，只需设置 userLength 并填充数据
     bool prepareZeroCopyData(DDS_ZeroCopyBytes& sample, int dataSize, uint32_t sequence);
+    // 结束包使用独立的小缓冲区：全局缓冲区可能仍被刚写出的数据样本借用，不能在其上改写包头
     bool prepareEndZeroCopyData(DDS_ZeroCopyBytes& sample);
 
+    // 热路径用：把样本绑定到全局缓冲区并一次性填充 payload，之后每次发送只改写包头和 userLength（不打印日志）
+    bool prepareReusableZeroCopyData(DDS_ZeroCopyBytes& sample, int capacity);
+
+    // m_checkSample：监听线程对收到的数据样本做完整性校验，每轮初始化时清零
+    const SampleVerifier& sample_verifier() const { return sample_verifier_; }
+
+    // 本 Manager 创建的 Writer / Reader 的匹配状态，由匹配回调驱动，每次初始化时清零
+    MatchTracker& match_tracker() { return match_tracker_; }
+
+    // 全局缓冲区每次（重新）分配后递增；复用样本据此判断是否需要重新绑定
+    uint64_t buffer_generation() const { return buffer_generation_; }
+
 private:
     std::string xml_qos_file_path_;
 
@@ -59,6 +95,8 @@ private:
     static constexpr size_t DEFAULT_HEADER_RESERVE = 1024; // 推荐值，大于512即可
     size_t max_possible_size_; // 最大数据包大小，用于预分配
     char* global_buffer_;      // 预先分配的大块内存
+    uint64_t buffer_generation_ = 0;
+    char* end_buffer_ = nullptr;   // 结束包专用缓冲区（首次发送结束包时分配，shutdown 时释放）
 
     // DDS 实体
     DDS::DomainParticipantFactory* factory_ = nullptr;
@@ -67,8 +105,26 @@ private:
     DDS::DataWriter* data_writer_ = nullptr;
     DDS::DataReader* data_reader_ = nullptr;
 
+    // 时延测试实体
+    DDS::Topic* ping_topic_ = nullptr;
+    DDS::Topic* pong_topic_ = nullptr;
+    DDS::DataWriter* ping_writer_ = nullptr;
+    DDS::DataReader* ping_reader_ = nullptr;
+    DDS::DataWriter* pong_writer_ = nullptr;
+    DDS::DataReader* pong_reader_ = nullptr;
+    ZCWriter* ping_typed_writer_ = nullptr;
+    ZCWriter* pong_typed_writer_ = nullptr;
+
     class MyDataReaderListener;
     MyDataReaderListener* listener_ = nullptr;
+    MyDataReaderListener* ping_listener_ = nullptr;
+    MyDataReaderListener* pong_listener_ = nullptr;
+
+    SampleVerifier sample_verifier_;
+    MatchTracker match_tracker_;
+
+    std::string make_ping_topic_name() const { return topic_name_ + "_Ping"; }
+    std::string make_pong_topic_name() const { return topic_name_ + "_Pong"; }
 
     bool is_initialized_ = false;
 };
\ No newline at end of file
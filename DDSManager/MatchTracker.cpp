@@ -0,0 +1,143 @@
+﻿// MatchTracker.cpp
+#include "MatchTracker.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    // timeout 为 0 时的等待上限
+    constexpr std::chrono::minutes kMaxMatchWait{ 60 };
+}
+
+std::string formatTimeToMatch(const std::string& what, double ms) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << what << " 匹配完成 | time-to-match: " << ms << " ms";
+    return oss.str();
+}
+
+MatchTracker::MatchTracker()
+    : writer_listener_(this)
+    , started_at_(std::chrono::steady_clock::now()) {
+}
+
+void MatchTracker::reset() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    counts_.clear();
+    started_at_ = std::chrono::steady_clock::now();
+    matched_once_ = false;
+    last_time_to_match_ms_ = -1.0;
+}
+
+void MatchTracker::update(const void* entity, int32_t current_count) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        counts_[entity] = current_count;
+    }
+    cv_.notify_all();
+}
+
+void MatchTracker::seed(const void* entity, int32_t polled_count) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        // 已有回调记录时以回调为准：查询结果可能早于查询返回前到达的回调
+        if (!counts_.emplace(entity, polled_count).second) {
+            return;
+        }
+    }
+    cv_.notify_all();
+}
+
+bool MatchTracker::seedWriters(const std::vector<DDS::DataWriter*>& writers, const std::vector<int32_t>& expected, std::vector<Target>& targets) {
+    for (size_t i = 0; i < writers.size(); ++i) {
+        DDS::DataWriter* writer = writers[i];
+        DDS::PublicationMatchedStatus status{};
+        if (!writer || writer->get_publication_matched_status(status) != DDS::RETCODE_OK) {
+            Logger::getInstance().error("[MatchTracker] 获取 Publication Matched 状态失败");
+            return false;
+        }
+        seed(writer, status.current_count);
+        targets.emplace_back(writer, i < expected.size() ? std::max<int32_t>(expected[i], 1) : 1);
+    }
+    return true;
+}
+
+bool MatchTracker::seedReaders(const std::vector<DDS::DataReader*>& readers, const std::vector<int32_t>& expected, std::vector<Target>& targets) {
+    for (size_t i = 0; i < readers.size(); ++i) {
+        DDS::DataReader* reader = readers[i];
+        DDS::SubscriptionMatchedStatus status{};
+        if (!reader || reader->get_subscription_matched_status(status) != DDS::RETCODE_OK) {
+            Logger::getInstance().error("[MatchTracker] 获取 Subscription Matched 状态失败");
+            return false;
+        }
+        seed(reader, status.current_count);
+        targets.emplace_back(reader, i < expected.size() ? std::max<int32_t>(expected[i], 1) : 1);
+    }
+    return true;
+}
+
+bool MatchTracker::waitForWriters(const std::vector<DDS::DataWriter*>& writers, std::chrono::milliseconds timeout) {
+    std::vector<Target> targets;
+    if (!seedWriters(writers, {}, targets)) return false;
+    return waitForEntities(targets, timeout);
+}
+
+bool MatchTracker::waitForReaders(const std::vector<DDS::DataReader*>& readers, std::chrono::milliseconds timeout) {
+    std::vector<Target> targets;
+    if (!seedReaders(readers, {}, targets)) return false;
+    return waitForEntities(targets, timeout);
+}
+
+bool MatchTracker::waitForEndpoints(const std::vector<DDS::DataWriter*>& writers, const std::vector<int32_t>& writer_expected,
+    const std::vector<DDS::DataReader*>& readers, const std::vector<int32_t>& reader_expected,
+    std::chrono::milliseconds timeout) {
+    std::vector<Target> targets;
+    targets.reserve(writers.size() + readers.size());
+    if (!seedWriters(writers, writer_expected, targets) || !seedReaders(readers, reader_expected, targets)) {
+        return false;
+    }
+    return waitForEntities(targets, timeout);
+}
+
+bool MatchTracker::waitForEntities(const std::vector<Target>& targets, std::chrono::milliseconds timeout) {
+    if (targets.empty()) return false;
+
+    auto is_matched = [this](const Target& target) {
+        auto it = counts_.find(target.first);
+        return it != counts_.end() && it->second >= target.second;
+        };
+    auto all_matched = [&targets, &is_matched] {
+        return std::all_of(targets.begin(), targets.end(), is_matched);
+        };
+
+    const std::chrono::milliseconds limit = timeout.count() > 0
+        ? timeout : std::chrono::duration_cast<std::chrono::milliseconds>(kMaxMatchWait);
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (!cv_.wait_for(lock, limit, all_matched)) {
+        if (timeout.count() <= 0) {
+            Logger::getInstance().error("[MatchTracker] 等待匹配达到上限 " + std::to_string(kMaxMatchWait.count()) + " 分钟，放弃等待");
+        }
+        else if (targets.size() > 1) {
+            const size_t unmatched = static_cast<size_t>(std::count_if(targets.begin(), targets.end(),
+                [&is_matched](const Target& target) { return !is_matched(target); }));
+            Logger::getInstance().logAndPrint("[MatchTracker] 等待匹配超时 | 未匹配端点: " +
+                std::to_string(unmatched) + "/" + std::to_string(targets.size()));
+        }
+        return false;
+    }
+
+    if (!matched_once_) {
+        last_time_to_match_ms_ = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - started_at_).count();
+        matched_once_ = true;
+    }
+    return true;
+}
+
+double MatchTracker::lastTimeToMatchMs() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return last_time_to_match_ms_;
+}
@@ -0,0 +1,105 @@
+﻿// MatchTracker.h
+#pragma once
+
+#include "ZRDDSDataReader.h"
+#include "ZRDDSDataWriter.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 将 time-to-match 格式化为单行日志文本
+ */
+std::string formatTimeToMatch(const std::string& what, double ms);
+
+/**
+ * @brief 端点匹配跟踪：由 on_publication_matched / on_subscription_matched 回调驱动，
+ * 等待方阻塞在条件变量上，匹配完成时立即被唤醒，不再按秒轮询 get_*_matched_status。
+ *
+ * DDSManager 每次创建实体前 reset()；Writer 挂 writerListener()（PUBLICATION_MATCHED_STATUS），
+ * 已有数据 Listener 的 Reader 在其 on_subscription_matched 中转调 update()。
+ * waitForWriters()/waitForReaders() 先主动查询一次当前匹配数，补上挂接前可能错过的回调；
+ * 查询值只在该端点还没有回调记录时写入，避免覆盖查询期间回调写入的更新值。
+ *
+ * time-to-match：reset() 到所等待端点全部匹配的耗时，每次 reset() 后只记录首次等待成功的结果。
+ * 每轮重建实体时即「实体创建 → 发现并匹配」耗时；实体复用（m_persistentEntities）时
+ * 每轮开始 reset() 一次，等待时重新查询到已有匹配，耗时接近 0。
+ */
+class MatchTracker {
+public:
+    MatchTracker();
+
+    MatchTracker(const MatchTracker&) = delete;
+    MatchTracker& operator=(const MatchTracker&) = delete;
+
+    /**
+     * @brief 清空匹配计数并以当前时刻作为 time-to-match 的起点
+     */
+    void reset();
+
+    /**
+     * @brief 记录某个 Writer / Reader 当前匹配到的对端数（DDS 回调线程调用）
+     */
+    void update(const void* entity, int32_t current_count);
+
+    /**
+     * @brief 等待所有给定端点至少匹配到一个对端
+     * @param timeout 为 0 时按上限 60 分钟等待，防止对端始终不出现时永久阻塞
+     * @return 超时或查询匹配状态失败返回 false
+     */
+    bool waitForWriters(const std::vector<DDS::DataWriter*>& writers, std::chrono::milliseconds timeout);
+    bool waitForReaders(const std::vector<DDS::DataReader*>& readers, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 同时等待一组 Writer 与 Reader，time-to-match 记到最后一个端点匹配完成时
+     * @param writer_expected / reader_expected 与端点一一对应的期望对端数，为空时均按 1
+     * @return 两组端点都为空、超时或查询匹配状态失败返回 false
+     */
+    bool waitForEndpoints(const std::vector<DDS::DataWriter*>& writers, const std::vector<int32_t>& writer_expected,
+        const std::vector<DDS::DataReader*>& readers, const std::vector<int32_t>& reader_expected,
+        std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 本次 reset() 后首次等待成功时记录的 time-to-match（毫秒），尚未匹配为 -1
+     */
+    double lastTimeToMatchMs() const;
+
+    DDS::DataWriterListener* writerListener() { return &writer_listener_; }
+
+private:
+    class WriterListener : public virtual DDS::DataWriterListener {
+    public:
+        explicit WriterListener(MatchTracker* owner) : owner_(owner) {}
+        void on_liveliness_lost(DDS::DataWriter*, const DDS::LivelinessLostStatus&) override {}
+        void on_offered_deadline_missed(DDS::DataWriter*, const DDS::OfferedDeadlineMissedStatus&) override {}
+        void on_offered_incompatible_qos(DDS::DataWriter*, const DDS::OfferedIncompatibleQosStatus&) override {}
+        void on_publication_matched(DDS::DataWriter* writer, const DDS::PublicationMatchedStatus& status) override {
+            owner_->update(writer, status.current_count);
+        }
+    private:
+        MatchTracker* owner_;
+    };
+
+    // 等待目标：端点及其期望对端数
+    using Target = std::pair<const void*, int32_t>;
+
+    void seed(const void* entity, int32_t polled_count);
+    bool seedWriters(const std::vector<DDS::DataWriter*>& writers, const std::vector<int32_t>& expected, std::vector<Target>& targets);
+    bool seedReaders(const std::vector<DDS::DataReader*>& readers, const std::vector<int32_t>& expected, std::vector<Target>& targets);
+    bool waitForEntities(const std::vector<Target>& targets, std::chrono::milliseconds timeout);
+
+    WriterListener writer_listener_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::unordered_map<const void*, int32_t> counts_;
+    std::chrono::steady_clock::time_point started_at_;
+    bool matched_once_ = false;
+    double last_time_to_match_ms_ = -1.0;
+};
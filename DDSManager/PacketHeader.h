@@ -0,0 +1,26 @@
+﻿// PacketHeader.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 所有测试模式共用的样本包头，位于每个 DDS::Bytes / ZeroCopyBytes 负载起始处。
+ *
+ * 收发两端按此布局直接 reinterpret_cast，因此各模块必须包含本头文件而不是各自定义；
+ * 样本长度小于 sizeof(PacketHeader) 时接收端直接丢弃，发送端的包大小下限也按此取值。
+ */
+struct PacketHeader {
+    uint32_t sequence;      // 序列号
+    uint32_t round;         // 轮次标记（吞吐测试为 m_activeLoop + 1，0 为未标记）
+    uint64_t timestamp;     // 发送时间（纳秒，时延 / 混合负载测试使用）
+    uint8_t  packet_type;   // 0 = 数据包, 1 = 结束包
+    uint32_t source;        // 发送端 Writer 标识（scale:: / traffic:: 结束包按 Writer 去重，0 为未标记）
+};
+
+// 线上布局：与已发布版本互通，不随编译器对齐策略变化
+static_assert(sizeof(PacketHeader) == 24, "PacketHeader 线上布局必须为 24 字节");
+static_assert(offsetof(PacketHeader, round) == 4, "PacketHeader::round 偏移变化");
+static_assert(offsetof(PacketHeader, timestamp) == 8, "PacketHeader::timestamp 偏移变化");
+static_assert(offsetof(PacketHeader, packet_type) == 16, "PacketHeader::packet_type 偏移变化");
+static_assert(offsetof(PacketHeader, source) == 20, "PacketHeader::source 偏移变化");
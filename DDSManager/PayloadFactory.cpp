@@ -0,0 +1,164 @@
+﻿// PayloadFactory.cpp
+#include "PayloadFactory.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace {
+    constexpr uint8_t kConstantByte = 0xA5;
+    constexpr uint64_t kRandomSeed = 0x5A5A1234DEADBEEFull; // 固定种子：收发两端生成相同内容
+    constexpr size_t kCompressibleBlock = 64;
+
+    // 以已填充的前 filled 字节为源，倍增拷贝铺满整个缓冲区
+    void replicate(uint8_t* data, size_t filled, size_t size) {
+        while (filled < size) {
+            size_t n = std::min(filled, size - filled);
+            std::memcpy(data + filled, data, n);
+            filled += n;
+        }
+    }
+}
+
+PayloadFactory& PayloadFactory::instance() {
+    static PayloadFactory factory;
+    return factory;
+}
+
+bool PayloadFactory::configure(const std::string& spec) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    const std::string requested = spec.empty() ? "incrementing" : spec;
+    if (requested == spec_) {
+        return true;
+    }
+
+    bool ok = true;
+    Pattern pattern = Pattern::Incrementing;
+    std::vector<uint8_t> file_data;
+    if (requested == "incrementing") {
+        pattern = Pattern::Incrementing;
+    }
+    else if (requested == "constant") {
+        pattern = Pattern::Constant;
+    }
+    else if (requested == "random") {
+        pattern = Pattern::Random;
+    }
+    else if (requested == "compressible") {
+        pattern = Pattern::Compressible;
+    }
+    else if (requested.compare(0, 5, "file:") == 0) {
+        std::ifstream in(requested.substr(5), std::ios::binary);
+        if (in) {
+            file_data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        if (file_data.empty()) {
+            Logger::getInstance().error("[PayloadFactory] 无法读取负载文件或文件为空: " + requested.substr(5) +
+                "，回退为 incrementing");
+            ok = false;
+        }
+        else {
+            pattern = Pattern::File;
+        }
+    }
+    else {
+        Logger::getInstance().error("[PayloadFactory] 未知负载模式: " + requested + "，回退为 incrementing");
+        ok = false;
+    }
+
+    spec_ = ok ? requested : "incrementing";
+    pattern_ = pattern;
+    file_data_ = std::move(file_data);
+    cache_.reset();
+    return ok;
+}
+
+bool PayloadFactory::fill(uint8_t* buffer, size_t begin, size_t end) {
+    if (!buffer || end <= begin) {
+        return end == begin;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    ensureCapacity(end);
+    std::memcpy(buffer + begin, cache_->data() + begin, end - begin);
+    return true;
+}
+
+std::shared_ptr<const std::vector<uint8_t>> PayloadFactory::snapshot(size_t size) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    ensureCapacity(size);
+    return cache_;
+}
+
+std::string PayloadFactory::describe() const {
+    return "payload=" + spec_ + " | cache=" + std::to_string(cache_ ? cache_->size() : 0) + " bytes";
+}
+
+void PayloadFactory::ensureCapacity(size_t size) {
+    if (cache_ && cache_->size() >= size) {
+        return;
+    }
+    // 按 2 的幂向上取整，避免包长递增时反复重建
+    size_t capacity = kMinCacheSize;
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+    // 新建而非原地扩容：已发出的快照保持不变
+    auto cache = std::make_shared<std::vector<uint8_t>>(capacity);
+    build(*cache);
+    cache_ = std::move(cache);
+    Logger::getInstance().logAndPrint("[PayloadFactory] 已生成负载模板 | " + describe());
+}
+
+void PayloadFactory::build(std::vector<uint8_t>& cache) const {
+    const size_t size = cache.size();
+    uint8_t* data = cache.data();
+
+    switch (pattern_) {
+    case Pattern::Incrementing: {
+        const size_t period = std::min<size_t>(255, size);
+        for (size_t i = 0; i < period; ++i) {
+            data[i] = static_cast<uint8_t>(i);
+        }
+        replicate(data, period, size);
+        break;
+    }
+    case Pattern::Constant:
+        std::memset(data, kConstantByte, size);
+        break;
+    case Pattern::Random: {
+        std::mt19937_64 gen(kRandomSeed);
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t v = gen();
+            std::memcpy(data + i, &v, sizeof(v));
+        }
+        if (i < size) {
+            uint64_t v = gen();
+            std::memcpy(data + i, &v, size - i);
+        }
+        break;
+    }
+    case Pattern::Compressible: {
+        std::mt19937_64 gen(kRandomSeed);
+        for (size_t block = 0; block < size; block += kCompressibleBlock) {
+            const size_t len = std::min(kCompressibleBlock, size - block);
+            const size_t random_len = std::min(kCompressibleBlock / 2, len);
+            for (size_t k = 0; k < random_len; k += sizeof(uint64_t)) {
+                uint64_t v = gen();
+                std::memcpy(data + block + k, &v, std::min(sizeof(v), random_len - k));
+            }
+            std::memset(data + block + random_len, 0, len - random_len);
+        }
+        break;
+    }
+    case Pattern::File: {
+        const size_t n = std::min(file_data_.size(), size);
+        std::memcpy(data, file_data_.data(), n);
+        replicate(data, n, size);
+        break;
+    }
+    }
+}
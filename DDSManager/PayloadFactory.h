@@ -0,0 +1,75 @@
+﻿// PayloadFactory.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 负载模板缓存：DDSManager_Bytes 与 DDSManager_ZeroCopyBytes 共用。
+ *
+ * 按 m_payloadPattern 一次性生成负载模板，之后准备样本时只需 memcpy，发送时只改写包头。
+ * 模板第 i 字节只与下标 i 有关（与序列号、包长无关），因此较小的包直接取较大模板的前缀，
+ * 接收端也可据此校验内容。
+ *
+ * 支持的模式：
+ *  - "incrementing"：i % 255（默认，与旧版填充一致）
+ *  - "constant"    ：固定字节 0xA5
+ *  - "random"      ：固定种子的伪随机字节（不可压缩）
+ *  - "compressible"：每 64 字节前半随机、后半为 0（约 50% 可压缩）
+ *  - "file:<路径>" ：读取文件内容并循环铺满
+ */
+class PayloadFactory {
+public:
+    enum class Pattern {
+        Incrementing,
+        Constant,
+        Random,
+        Compressible,
+        File
+    };
+
+    static PayloadFactory& instance();
+
+    /**
+     * @brief 选择负载模式；模式未变化时保留已生成的缓存
+     * @param spec 模式字符串，无法识别或文件读取失败时回退为 incrementing 并返回 false
+     */
+    bool configure(const std::string& spec);
+
+    /**
+     * @brief 把模板的 [begin, end) 区间拷贝到 buffer 的相同区间
+     */
+    bool fill(uint8_t* buffer, size_t begin, size_t end);
+
+    /**
+     * @brief 获取至少覆盖 size 字节的只读模板快照
+     *
+     * 快照在模板重建后依然有效，接收端校验时可长期持有，热路径上无需加锁。
+     */
+    std::shared_ptr<const std::vector<uint8_t>> snapshot(size_t size);
+
+    Pattern pattern() const { return pattern_; }
+    std::string describe() const;
+
+    PayloadFactory(const PayloadFactory&) = delete;
+    PayloadFactory& operator=(const PayloadFactory&) = delete;
+
+private:
+    PayloadFactory() = default;
+
+    // 确保缓存至少覆盖 size 字节（调用方持有 mtx_）
+    void ensureCapacity(size_t size);
+    void build(std::vector<uint8_t>& cache) const;
+
+    static constexpr size_t kMinCacheSize = 64 * 1024;
+
+    std::mutex mtx_;
+    std::string spec_ = "incrementing";
+    Pattern pattern_ = Pattern::Incrementing;
+    std::vector<uint8_t> file_data_;
+    std::shared_ptr<std::vector<uint8_t>> cache_;
+};
@@ -0,0 +1,370 @@
+﻿// ReceiveDispatcher.cpp
+#include "ReceiveDispatcher.h"
+#include "GloMemPool.h"
+#include "Logger.h"
+#include "ResourceUtilization.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
+namespace {
+    // 队列空时先让出若干次再休眠，兼顾交接时延与 CPU 占用
+    constexpr int kSpinBeforeSleep = 256;
+    constexpr auto kIdleSleep = std::chrono::microseconds(50);
+    // 槽位区上限，超出时缩小队列容量而不是按样本临时分配
+    constexpr size_t kMaxSlotArenaBytes = 256u * 1024u * 1024u;
+
+    inline uint64_t steady_now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    inline size_t round_up_pow2(size_t v) {
+        size_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    inline size_t bucket_for(uint64_t ns) {
+        size_t b = 0;
+        while (ns > 1 && b + 1 < 64) {
+            ns >>= 1;
+            ++b;
+        }
+        return b;
+    }
+
+    inline void update_max(std::atomic<uint64_t>& target, uint64_t value) {
+        uint64_t cur = target.load(std::memory_order_relaxed);
+        while (value > cur && !target.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+std::string formatDispatchStats(const DispatchStats& s) {
+    std::ostringstream oss;
+    oss << "分发: " << s.dispatched
+        << " | 处理: " << s.executed
+        << " | 队列满等待: " << s.full_waits
+        << " | 超大样本: " << s.oversize
+        << " | 窃取: " << s.steals
+        << " | 队列深度 平均/最大: " << s.avg_depth << "/" << s.max_depth
+        << " | 交接时延(us) 平均/P50/P99/最大: "
+        << s.handoff_avg_ns / 1000.0 << "/"
+        << s.handoff_p50_ns / 1000.0 << "/"
+        << s.handoff_p99_ns / 1000.0 << "/"
+        << s.handoff_max_ns / 1000.0;
+    return oss.str();
+}
+
+ReceiveDispatcher::Mode ReceiveDispatcher::parseMode(const std::string& name) {
+    if (name == "spsc") return Mode::Spsc;
+    if (name == "pool") return Mode::WorkStealing;
+    if (!name.empty() && name != "inline") {
+        Logger::getInstance().logAndPrint("[ReceiveDispatcher] 未知的 m_dispatchMode '" + name + "'，使用 inline");
+    }
+    return Mode::Inline;
+}
+
+const char* ReceiveDispatcher::modeName(Mode mode) {
+    switch (mode) {
+    case Mode::Spsc:         return "spsc";
+    case Mode::WorkStealing: return "pool";
+    default:                 return "inline";
+    }
+}
+
+ReceiveDispatcher::ReceiveDispatcher(Mode mode, int worker_num, int queue_capacity, size_t slot_bytes)
+    : mode_(mode)
+    , worker_num_(mode == Mode::WorkStealing ? std::max(worker_num, 1) : 1)
+    , capacity_(round_up_pow2(static_cast<size_t>(std::max(queue_capacity, 2))))
+    , slot_bytes_(std::max<size_t>(slot_bytes, 1)) {
+}
+
+ReceiveDispatcher::~ReceiveDispatcher() {
+    stop();
+}
+
+bool ReceiveDispatcher::start(Handler handler) {
+    handler_ = std::move(handler);
+    stop_flag_.store(false, std::memory_order_release);
+
+    if (mode_ != Mode::Inline) {
+        if (capacity_ * slot_bytes_ > kMaxSlotArenaBytes) {
+            size_t fitted = capacity_;
+            while (fitted > 2 && fitted * slot_bytes_ > kMaxSlotArenaBytes) {
+                fitted >>= 1;
+            }
+            Logger::getInstance().logAndPrint(
+                "[ReceiveDispatcher] 槽位区超过上限，队列容量由 " + std::to_string(capacity_) +
+                " 缩小为 " + std::to_string(fitted));
+            capacity_ = fitted;
+        }
+        slots_ = static_cast<DDS_Octet*>(GloMemPool::allocate(capacity_ * slot_bytes_, __FILE__, __LINE__));
+        if (!slots_) {
+            Logger::getInstance().error("[ReceiveDispatcher] 槽位区分配失败，大小: " + std::to_string(capacity_ * slot_bytes_));
+            return false;
+        }
+    }
+
+    if (mode_ == Mode::Spsc) {
+        ring_.assign(capacity_, Task{});
+        threads_.emplace_back(&ReceiveDispatcher::spscLoop, this);
+    }
+    else if (mode_ == Mode::WorkStealing) {
+        free_slots_.clear();
+        free_slots_.reserve(capacity_);
+        for (size_t i = capacity_; i > 0; --i) {
+            free_slots_.push_back(static_cast<uint32_t>(i - 1));
+        }
+        for (int i = 0; i < worker_num_; ++i) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (int i = 0; i < worker_num_; ++i) {
+            threads_.emplace_back(&ReceiveDispatcher::poolLoop, this, static_cast<size_t>(i));
+        }
+    }
+
+    Logger::getInstance().logAndPrint(
+        std::string("[ReceiveDispatcher] 接收分发模式: ") + modeName(mode_) +
+        (mode_ == Mode::Inline ? "" :
+            " | 工作线程: " + std::to_string(worker_num_) + " | 队列容量: " + std::to_string(capacity_) +
+            " | 槽位大小: " + std::to_string(slot_bytes_)));
+    return true;
+}
+
+void ReceiveDispatcher::dispatch(const DDS::Bytes& sample, const DDS::SampleInfo& info) {
+    if (mode_ == Mode::Inline) {
+        dispatched_.fetch_add(1, std::memory_order_relaxed);
+        handler_(sample, info);
+        executed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const DDS_ULong length = sample.value.length();
+    if (length > slot_bytes_) {
+        // 放不进槽位：排空后在接收线程直接处理，保持与已入队样本的先后顺序
+        oversize_.fetch_add(1, std::memory_order_relaxed);
+        drain();
+        dispatched_.fetch_add(1, std::memory_order_relaxed);
+        handler_(sample, info);
+        executed_.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    // 队列深度按未处理样本数计（含正在处理的），两种模式口径一致
+    const uint64_t depth = dispatched_.load(std::memory_order_relaxed) - executed_.load(std::memory_order_acquire);
+    if (depth >= capacity_) {
+        full_waits_.fetch_add(1, std::memory_order_relaxed);
+        while (dispatched_.load(std::memory_order_relaxed) - executed_.load(std::memory_order_acquire) >= capacity_) {
+            std::this_thread::yield();
+        }
+    }
+    recordDepth(depth);
+
+    // 深度 < capacity_ 时必有空闲槽位：槽位在 executed_ 递增之前归还
+    Task task;
+    task.slot = acquireSlot(tail_.load(std::memory_order_relaxed));
+    task.length = length;
+    task.info = info;
+    std::memcpy(slots_ + static_cast<size_t>(task.slot) * slot_bytes_, sample.value.get_contiguous_buffer(), length);
+
+    task.enqueue_ns = steady_now_ns();
+    if (mode_ == Mode::Spsc) {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        while (tail - head_.load(std::memory_order_acquire) >= capacity_) {
+            std::this_thread::yield();
+        }
+        ring_[tail & (capacity_ - 1)] = task;
+        dispatched_.fetch_add(1, std::memory_order_relaxed);
+        tail_.store(tail + 1, std::memory_order_release);
+        return;
+    }
+
+    WorkerQueue& q = *queues_[next_queue_];
+    next_queue_ = (next_queue_ + 1) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back(task);
+    }
+    dispatched_.fetch_add(1, std::memory_order_relaxed);
+    if (sleeping_.load(std::memory_order_acquire) > 0) {
+        idle_cv_.notify_one();
+    }
+}
+
+void ReceiveDispatcher::drain() {
+    if (mode_ == Mode::Inline) return;
+    while (executed_.load(std::memory_order_acquire) < dispatched_.load(std::memory_order_relaxed)) {
+        std::this_thread::yield();
+    }
+}
+
+void ReceiveDispatcher::stop() {
+    if (threads_.empty()) return;
+
+    drain();
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        stop_flag_.store(true, std::memory_order_release);
+    }
+    idle_cv_.notify_all();
+    for (std::thread& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+    threads_.clear();
+    queues_.clear();
+    ring_.clear();
+    free_slots_.clear();
+    if (slots_) {
+        GloMemPool::deallocate(slots_);
+        slots_ = nullptr;
+    }
+}
+
+DispatchStats ReceiveDispatcher::snapshot() const {
+    DispatchStats s;
+    s.dispatched = dispatched_.load(std::memory_order_relaxed);
+    s.executed = executed_.load(std::memory_order_relaxed);
+    s.full_waits = full_waits_.load(std::memory_order_relaxed);
+    s.oversize = oversize_.load(std::memory_order_relaxed);
+    s.steals = steals_.load(std::memory_order_relaxed);
+    s.max_depth = max_depth_.load(std::memory_order_relaxed);
+    s.avg_depth = s.dispatched > 0 ? static_cast<double>(depth_sum_.load(std::memory_order_relaxed)) / s.dispatched : 0.0;
+    s.handoff_max_ns = handoff_max_ns_.load(std::memory_order_relaxed);
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < kHandoffBuckets; ++i) {
+        total += handoff_buckets_[i].load(std::memory_order_relaxed);
+    }
+    if (total > 0) {
+        s.handoff_avg_ns = handoff_sum_ns_.load(std::memory_order_relaxed) / total;
+        const uint64_t p50_rank = (total + 1) / 2;
+        const uint64_t p99_rank = std::max<uint64_t>(1, (total * 99 + 99) / 100);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kHandoffBuckets; ++i) {
+            seen += handoff_buckets_[i].load(std::memory_order_relaxed);
+            const uint64_t upper = std::min<uint64_t>(2ull << i, s.handoff_max_ns);
+            if (s.handoff_p50_ns == 0 && seen >= p50_rank) s.handoff_p50_ns = upper;
+            if (seen >= p99_rank) {
+                s.handoff_p99_ns = upper;
+                break;
+            }
+        }
+    }
+    return s;
+}
+
+uint32_t ReceiveDispatcher::acquireSlot(uint64_t tail) {
+    // spsc 按环形队列位置取槽位：位置 tail 之前的 capacity_ 个样本中已无在处理的
+    if (mode_ == Mode::Spsc) {
+        return static_cast<uint32_t>(tail & (capacity_ - 1));
+    }
+    std::lock_guard<std::mutex> lock(free_mutex_);
+    const uint32_t slot = free_slots_.back();
+    free_slots_.pop_back();
+    return slot;
+}
+
+void ReceiveDispatcher::execute(Task& task) {
+    const uint64_t handoff = steady_now_ns() - task.enqueue_ns;
+    handoff_sum_ns_.fetch_add(handoff, std::memory_order_relaxed);
+    handoff_buckets_[bucket_for(handoff)].fetch_add(1, std::memory_order_relaxed);
+    update_max(handoff_max_ns_, handoff);
+
+    // 槽位以租借方式挂到临时样本上，回调结束后归还槽位
+    DDS_Octet* data = slots_ + static_cast<size_t>(task.slot) * slot_bytes_;
+    DDS::Bytes sample;
+    DDS_OctetSeq_initialize(&sample.value);
+    if (DDS_OctetSeq_loan_contiguous(&sample.value, data, task.length, static_cast<DDS_ULong>(slot_bytes_))) {
+        sample.value._length = task.length;
+        handler_(sample, task.info);
+    }
+    DDS_OctetSeq_finalize(&sample.value);
+    if (mode_ == Mode::WorkStealing) {
+        std::lock_guard<std::mutex> lock(free_mutex_);
+        free_slots_.push_back(task.slot);
+    }
+
+    executed_.fetch_add(1, std::memory_order_release);
+}
+
+void ReceiveDispatcher::recordDepth(uint64_t depth) {
+    depth_sum_.fetch_add(depth, std::memory_order_relaxed);
+    update_max(max_depth_, depth);
+}
+
+void ReceiveDispatcher::spscLoop() {
+    ResourceUtilization::instance().registerCurrentThread("dispatch_worker");
+
+    int idle_spins = 0;
+    for (;;) {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            if (stop_flag_.load(std::memory_order_acquire)) break;
+            if (++idle_spins < kSpinBeforeSleep) {
+                std::this_thread::yield();
+            }
+            else {
+                std::this_thread::sleep_for(kIdleSleep);
+            }
+            continue;
+        }
+        idle_spins = 0;
+
+        Task task = ring_[head & (capacity_ - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        execute(task);
+    }
+}
+
+bool ReceiveDispatcher::popOrSteal(size_t index, Task& task) {
+    {
+        WorkerQueue& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    // 自己的队列为空：从其他队列尾部窃取，与队列主人从头部取数错开
+    for (size_t k = 1; k < queues_.size(); ++k) {
+        WorkerQueue& victim = *queues_[(index + k) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReceiveDispatcher::poolLoop(size_t index) {
+    ResourceUtilization::instance().registerCurrentThread("dispatch_worker_" + std::to_string(index));
+
+    int idle_spins = 0;
+    Task task;
+    for (;;) {
+        if (popOrSteal(index, task)) {
+            idle_spins = 0;
+            execute(task);
+            continue;
+        }
+        if (stop_flag_.load(std::memory_order_acquire)) break;
+
+        if (++idle_spins < kSpinBeforeSleep) {
+            std::this_thread::yield();
+            continue;
+        }
+        // 带超时的等待：生产者只在有线程休眠时才 notify，超时兜底防止错过唤醒
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        sleeping_.fetch_add(1, std::memory_order_acq_rel);
+        idle_cv_.wait_for(lock, std::chrono::milliseconds(1));
+        sleeping_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
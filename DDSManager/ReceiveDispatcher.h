@@ -0,0 +1,163 @@
+﻿// ReceiveDispatcher.h
+#pragma once
+
+#include "ZRBuiltinTypes.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 接收分发统计快照（由 ReceiveDispatcher::snapshot() 返回）
+ */
+struct DispatchStats {
+    uint64_t dispatched = 0;        // 交给执行器的样本数
+    uint64_t executed = 0;          // 工作线程已处理的样本数
+    uint64_t full_waits = 0;        // 队列已满、DDS 接收线程被迫等待的次数
+    uint64_t oversize = 0;          // 超过槽位大小、退回接收线程直接处理的样本数
+    uint64_t steals = 0;            // 工作窃取次数（仅 pool）
+    uint64_t max_depth = 0;         // 分发时观测到的最大队列深度
+    double   avg_depth = 0.0;       // 分发时的平均队列深度
+    uint64_t handoff_avg_ns = 0;    // 入队到开始处理的平均时延
+    uint64_t handoff_p50_ns = 0;    // 按 2 的幂分桶估计的分位数（桶上界）
+    uint64_t handoff_p99_ns = 0;
+    uint64_t handoff_max_ns = 0;
+};
+
+/**
+ * @brief 将分发统计格式化为单行日志文本
+ */
+std::string formatDispatchStats(const DispatchStats& stats);
+
+/**
+ * @brief DDS 接收线程与上层回调之间的分发层（m_dispatchMode）。
+ *
+ *  - "inline"：在 DDS 接收线程中直接调用回调（原有行为）
+ *  - "spsc"  ：样本拷贝后经无锁单生产者单消费者环形队列交给一个工作线程
+ *  - "pool"  ：m_dispatchWorkers 个工作线程，轮转入队，空闲线程从其他队列尾部窃取
+ *
+ * 非 inline 模式下样本负载拷贝到 start() 时一次性分配的槽位区（队列容量 × 槽位大小），
+ * 热路径上不再分配内存；槽位在 spsc 下随环形队列位置复用，pool 下经空闲槽位队列归还。
+ * 回调拿到的 DDS::Bytes 只在回调期间有效。超过槽位大小的样本先排空队列再在接收线程直接处理。
+ * 队列满时 dispatch() 在 DDS 接收线程中让出等待，即反压传回中间件，等待次数计入 full_waits。
+ *
+ * 约定：dispatch()/drain() 只由同一 Reader 的接收线程调用（ZRDDS 对同一 Reader 的回调是串行的）。
+ * pool 模式下回调会被多个线程并发调用，且处理顺序不再与到达顺序一致。
+ */
+class ReceiveDispatcher {
+public:
+    enum class Mode {
+        Inline,
+        Spsc,
+        WorkStealing
+    };
+
+    using Handler = std::function<void(const DDS::Bytes&, const DDS::SampleInfo&)>;
+
+    /**
+     * @brief 解析模式字符串，无法识别时回退为 inline
+     */
+    static Mode parseMode(const std::string& name);
+    static const char* modeName(Mode mode);
+
+    /**
+     * @param slot_bytes 单个槽位大小，取本次测试的最大样本长度
+     */
+    ReceiveDispatcher(Mode mode, int worker_num, int queue_capacity, size_t slot_bytes);
+    ~ReceiveDispatcher();
+
+    ReceiveDispatcher(const ReceiveDispatcher&) = delete;
+    ReceiveDispatcher& operator=(const ReceiveDispatcher&) = delete;
+
+    /**
+     * @brief 分配槽位区并启动工作线程
+     */
+    bool start(Handler handler);
+
+    /**
+     * @brief 分发一个数据样本（inline 直接调用，其他模式拷贝后入队）
+     */
+    void dispatch(const DDS::Bytes& sample, const DDS::SampleInfo& info);
+
+    /**
+     * @brief 等待已分发的样本全部处理完；结束包到达时调用，保证结束回调晚于所有数据回调
+     */
+    void drain();
+
+    /**
+     * @brief 处理完剩余样本后停止工作线程
+     */
+    void stop();
+
+    Mode mode() const { return mode_; }
+
+    DispatchStats snapshot() const;
+
+private:
+    struct Task {
+        uint32_t slot = 0;
+        DDS_ULong length = 0;
+        DDS::SampleInfo info;
+        uint64_t enqueue_ns = 0;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    static constexpr size_t kHandoffBuckets = 64;
+
+    uint32_t acquireSlot(uint64_t tail);
+    void execute(Task& task);
+    void recordDepth(uint64_t depth);
+
+    void spscLoop();
+    void poolLoop(size_t index);
+    bool popOrSteal(size_t index, Task& task);
+
+    Mode mode_;
+    int worker_num_;
+    size_t capacity_;
+    size_t slot_bytes_;
+    Handler handler_;
+
+    // 槽位区：capacity_ 个 slot_bytes_ 大小的槽位，start() 分配、stop() 释放
+    DDS_Octet* slots_ = nullptr;
+
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stop_flag_{ false };
+
+    // spsc：head_ 由消费者推进，tail_ 由生产者推进，分开缓存行避免伪共享
+    std::vector<Task> ring_;
+    alignas(64) std::atomic<uint64_t> head_{ 0 };
+    alignas(64) std::atomic<uint64_t> tail_{ 0 };
+
+    // pool：每个工作线程一个队列
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    size_t next_queue_ = 0;                 // 仅生产者访问
+    std::mutex free_mutex_;                 // 空闲槽位队列：工作线程归还、生产者取用
+    std::vector<uint32_t> free_slots_;
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    std::atomic<int> sleeping_{ 0 };
+
+    // 统计
+    alignas(64) std::atomic<uint64_t> dispatched_{ 0 };
+    alignas(64) std::atomic<uint64_t> executed_{ 0 };
+    std::atomic<uint64_t> full_waits_{ 0 };
+    std::atomic<uint64_t> oversize_{ 0 };
+    std::atomic<uint64_t> steals_{ 0 };
+    std::atomic<uint64_t> max_depth_{ 0 };
+    std::atomic<uint64_t> depth_sum_{ 0 };
+    std::atomic<uint64_t> handoff_sum_ns_{ 0 };
+    std::atomic<uint64_t> handoff_max_ns_{ 0 };
+    std::atomic<uint64_t> handoff_buckets_[kHandoffBuckets] = {};
+};
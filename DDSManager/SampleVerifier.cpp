@@ -0,0 +1,62 @@
+﻿// SampleVerifier.cpp
+#include "SampleVerifier.h"
+#include "PayloadFactory.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+void SampleVerifier::reset() {
+    checked_.store(0, std::memory_order_relaxed);
+    corrupt_.store(0, std::memory_order_relaxed);
+    truncated_.store(0, std::memory_order_relaxed);
+    verify_ns_.store(0, std::memory_order_relaxed);
+    std::atomic_store(&pattern_, std::shared_ptr<const std::vector<uint8_t>>()); // 负载模式可能已变化，下次校验时重新获取模板
+}
+
+bool SampleVerifier::verify(const uint8_t* data, size_t length, size_t payload_offset) {
+    const auto begin = std::chrono::steady_clock::now();
+
+    if (!data || length < payload_offset) {
+        add(truncated_, 1);
+        return false;
+    }
+    // 样本超出模板快照时重新获取（仅首次或包长增大时发生）；原子读写以支持 pool 分发下的并发校验
+    std::shared_ptr<const std::vector<uint8_t>> pattern = std::atomic_load(&pattern_);
+    if (!pattern || pattern->size() < length) {
+        pattern = PayloadFactory::instance().snapshot(length);
+        std::atomic_store(&pattern_, pattern);
+    }
+    const bool ok = std::memcmp(data + payload_offset, pattern->data() + payload_offset,
+        length - payload_offset) == 0;
+
+    add(checked_, 1);
+    if (!ok) {
+        add(corrupt_, 1);
+    }
+    add(verify_ns_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count()));
+    return ok;
+}
+
+IntegrityStats SampleVerifier::snapshot() const {
+    IntegrityStats s;
+    s.checked = checked_.load(std::memory_order_relaxed);
+    s.corrupt = corrupt_.load(std::memory_order_relaxed);
+    s.truncated = truncated_.load(std::memory_order_relaxed);
+    s.verify_ns = verify_ns_.load(std::memory_order_relaxed);
+    return s;
+}
+
+std::string formatIntegrityStats(const IntegrityStats& stats) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "完整性校验 | 校验: " << stats.checked
+        << " | 损坏: " << stats.corrupt
+        << " | 截断: " << stats.truncated
+        << " | 校验耗时: " << stats.verify_ns / 1e6 << " ms"
+        << " (平均 " << (stats.checked > 0 ? static_cast<double>(stats.verify_ns) / stats.checked : 0.0)
+        << " ns/样本)";
+    return oss.str();
+}
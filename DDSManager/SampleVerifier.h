@@ -0,0 +1,80 @@
+﻿// SampleVerifier.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 样本完整性统计快照（由 SampleVerifier::snapshot() 返回）
+ */
+struct IntegrityStats {
+    uint64_t checked = 0;       // 已校验的数据样本数
+    uint64_t corrupt = 0;       // payload 与模板不一致的样本数
+    uint64_t truncated = 0;     // 长度不足包头或缓冲区为空的样本数
+    uint64_t verify_ns = 0;     // 校验本身累计耗时（纳秒）
+};
+
+/**
+ * @brief 将完整性统计格式化为单行日志文本
+ */
+std::string formatIntegrityStats(const IntegrityStats& stats);
+
+/**
+ * @brief 接收端样本完整性校验（m_checkSample）。
+ *
+ * 发送端 payload 来自 PayloadFactory 模板，接收端用同一模板对 [包头, 样本末尾) 做 memcmp
+ * （由 CRT 向量化实现），因此两端需配置相同的 m_payloadPattern。
+ * 每次校验单独计时，结果中的校验耗时可用于评估常开校验对吞吐的影响。
+ *
+ * 约定：verify()/recordTruncated() 可由 DDS 监听线程或接收分发工作线程并发调用；
+ * 统计使用原子变量，可随时 snapshot()。
+ * reset() 在 DDSManager 每轮初始化时调用。
+ */
+class SampleVerifier {
+public:
+    SampleVerifier() = default;
+
+    SampleVerifier(const SampleVerifier&) = delete;
+    SampleVerifier& operator=(const SampleVerifier&) = delete;
+
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool enabled() const { return enabled_; }
+
+    /**
+     * @brief 清空统计，开始新一轮
+     */
+    void reset();
+
+    /**
+     * @brief 校验一个数据样本
+     * @param data 样本起始地址（含包头）
+     * @param length 样本长度
+     * @param payload_offset payload 起始偏移（包头长度）
+     * @return true 内容一致
+     */
+    bool verify(const uint8_t* data, size_t length, size_t payload_offset);
+
+    /**
+     * @brief 记录一个截断（过短或无缓冲区）的样本
+     */
+    void recordTruncated() { add(truncated_, 1); }
+
+    IntegrityStats snapshot() const;
+
+private:
+    static void add(std::atomic<uint64_t>& counter, uint64_t n) {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    bool enabled_ = false;
+    std::shared_ptr<const std::vector<uint8_t>> pattern_;   // 通过 std::atomic_load/atomic_store 访问
+
+    std::atomic<uint64_t> checked_{ 0 };
+    std::atomic<uint64_t> corrupt_{ 0 };
+    std::atomic<uint64_t> truncated_{ 0 };
+    std::atomic<uint64_t> verify_ns_{ 0 };
+};
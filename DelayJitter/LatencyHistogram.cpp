@@ -0,0 +1,183 @@
+﻿// LatencyHistogram.cpp
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+    // 返回最高有效位的下标（value 必须非 0）
+    inline int highest_bit(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long idx = 0;
+        _BitScanReverse64(&idx, value);
+        return static_cast<int>(idx);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    void update_min(std::atomic<uint64_t>& target, uint64_t value) {
+        uint64_t cur = target.load(std::memory_order_relaxed);
+        while (value < cur && !target.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+    }
+
+    void update_max(std::atomic<uint64_t>& target, uint64_t value) {
+        uint64_t cur = target.load(std::memory_order_relaxed);
+        while (value > cur && !target.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+    }
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(new std::atomic<uint64_t>[kBucketCount])
+{
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::indexFor(uint64_t value) {
+    if (value < kSubBucketCount) {
+        return static_cast<size_t>(value);
+    }
+    // 将 value 右移到 [1024, 2048) 区间，shift 即所在的 2 的幂区间
+    int shift = highest_bit(value) - (kSubBucketBits - 1);
+    uint64_t sub = (value >> shift) - kSubBucketHalf;
+    return static_cast<size_t>(kSubBucketCount + (shift - 1) * kSubBucketHalf + sub);
+}
+
+uint64_t LatencyHistogram::highestEquivalentValue(size_t index) {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    uint64_t k = index - kSubBucketCount;
+    int shift = static_cast<int>(k / kSubBucketHalf) + 1;
+    uint64_t lowest = (k % kSubBucketHalf + kSubBucketHalf) << shift;
+    return lowest + (1ull << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value_ns) {
+    if (value_ns > kMaxTrackableValue) {
+        overflow_count_.fetch_add(1, std::memory_order_relaxed);
+        value_ns = kMaxTrackableValue;
+    }
+    counts_[indexFor(value_ns)].fetch_add(1, std::memory_order_relaxed);
+    total_count_.fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+    update_min(min_value_, value_ns);
+    update_max(max_value_, value_ns);
+}
+
+void LatencyHistogram::reset() {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+    total_count_.store(0, std::memory_order_relaxed);
+    overflow_count_.store(0, std::memory_order_relaxed);
+    sum_ns_.store(0, std::memory_order_relaxed);
+    min_value_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_value_.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.count() == 0) return;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        uint64_t c = other.counts_[i].load(std::memory_order_relaxed);
+        if (c) counts_[i].fetch_add(c, std::memory_order_relaxed);
+    }
+    total_count_.fetch_add(other.count(), std::memory_order_relaxed);
+    overflow_count_.fetch_add(other.overflowCount(), std::memory_order_relaxed);
+    sum_ns_.fetch_add(other.sum_ns_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    update_min(min_value_, other.min_value_.load(std::memory_order_relaxed));
+    update_max(max_value_, other.maxValue());
+}
+
+uint64_t LatencyHistogram::minValue() const {
+    return count() == 0 ? 0 : min_value_.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n == 0 ? 0.0 : static_cast<double>(sum_ns_.load(std::memory_order_relaxed)) / n;
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const {
+    uint64_t total = count();
+    if (total == 0) return 0;
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 100.0) percentile = 100.0;
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total)));
+    if (target == 0) target = 1;
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        cumulative += counts_[i].load(std::memory_order_relaxed);
+        if (cumulative >= target) {
+            uint64_t value = highestEquivalentValue(i);
+            uint64_t max_v = maxValue();
+            return value < max_v ? value : max_v;
+        }
+    }
+    return maxValue();
+}
+
+LatencyHistogram::IntervalPercentiles LatencyHistogram::intervalSince(IntervalCursor& cursor) const {
+    if (cursor.last_counts.size() != kBucketCount) {
+        cursor.last_counts.assign(kBucketCount, 0);
+        cursor.delta.assign(kBucketCount, 0);
+    }
+
+    IntervalPercentiles result;
+    size_t highest = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        const uint64_t c = counts_[i].load(std::memory_order_relaxed);
+        // c 小于上次读数说明中途 reset 过，此时整桶视为新增
+        const uint64_t d = c >= cursor.last_counts[i] ? c - cursor.last_counts[i] : c;
+        cursor.last_counts[i] = c;
+        cursor.delta[i] = d;
+        if (d) {
+            result.count += d;
+            highest = i;
+        }
+    }
+    if (result.count == 0) return result;
+
+    auto at = [&](double percentile) {
+        uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(result.count)));
+        if (target == 0) target = 1;
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i <= highest; ++i) {
+            cumulative += cursor.delta[i];
+            if (cumulative >= target) return highestEquivalentValue(i);
+        }
+        return highestEquivalentValue(highest);
+    };
+    const uint64_t max_v = maxValue();
+    result.max_ns = std::min(highestEquivalentValue(highest), max_v);
+    result.p50_ns = std::min(at(50.0), result.max_ns);
+    result.p99_ns = std::min(at(99.0), result.max_ns);
+    return result;
+}
+
+std::string LatencyHistogram::percentileSummary() const {
+    auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "Min: " << us(minValue()) << " μs | "
+        << "Avg: " << mean() / 1000.0 << " μs | "
+        << "P50: " << us(valueAtPercentile(50.0)) << " μs | "
+        << "P90: " << us(valueAtPercentile(90.0)) << " μs | "
+        << "P99: " << us(valueAtPercentile(99.0)) << " μs | "
+        << "P99.9: " << us(valueAtPercentile(99.9)) << " μs | "
+        << "P99.99: " << us(valueAtPercentile(99.99)) << " μs | "
+        << "Max: " << us(maxValue()) << " μs";
+    return oss.str();
+}
@@ -0,0 +1,103 @@
+﻿// LatencyHistogram.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 固定内存的 HDR 风格时延直方图（纳秒精度）。
+ *
+ * 桶按"对数-线性"划分：< 2048ns 的值精确记录，之后每个 2 的幂区间均分为 1024 个子桶，
+ * 相对误差约 0.1%。可记录范围 [0, 2^36) ns（约 68.7 秒），超出部分计入最后一个桶并单独计数。
+ *
+ * record() 为无锁、无内存分配的操作，可在 DDS 监听线程中直接调用；
+ * reset()/merge() 不应与 record() 并发调用。
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 11;                              // 子桶精度位数
+    static constexpr int kMaxValueBits = 36;                               // 最大可记录值位数
+    static constexpr uint64_t kSubBucketCount = 1ull << kSubBucketBits;   // 2048
+    static constexpr uint64_t kSubBucketHalf = kSubBucketCount >> 1;      // 1024
+    static constexpr uint64_t kMaxTrackableValue = (1ull << kMaxValueBits) - 1;
+    static constexpr size_t kBucketCount =
+        static_cast<size_t>(kSubBucketCount + (kMaxValueBits - kSubBucketBits) * kSubBucketHalf);
+
+    LatencyHistogram();
+    ~LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief 记录一个时延值（线程安全，无锁）
+     * @param value_ns 时延（纳秒）
+     */
+    void record(uint64_t value_ns);
+
+    /**
+     * @brief 清空所有计数
+     */
+    void reset();
+
+    /**
+     * @brief 将另一个直方图的计数累加到本直方图（用于跨轮次汇总）
+     */
+    void merge(const LatencyHistogram& other);
+
+    uint64_t count() const { return total_count_.load(std::memory_order_relaxed); }
+    uint64_t overflowCount() const { return overflow_count_.load(std::memory_order_relaxed); }
+    uint64_t minValue() const;
+    uint64_t maxValue() const { return max_value_.load(std::memory_order_relaxed); }
+    double mean() const;
+
+    /**
+     * @brief 获取指定百分位的时延值（桶内最高等价值，不超过实际最大值）
+     * @param percentile 百分位，范围 [0, 100]
+     * @return 纳秒；直方图为空时返回 0
+     */
+    uint64_t valueAtPercentile(double percentile) const;
+
+    /**
+     * @brief 生成 p50/p90/p99/p99.9/p99.99/max 摘要字符串（单位：微秒）
+     */
+    std::string percentileSummary() const;
+
+    /**
+     * @brief 区间游标：保存上一次读取时的桶计数，用于计算区间内新增样本的分位数
+     */
+    struct IntervalCursor {
+        std::vector<uint64_t> last_counts;
+        std::vector<uint64_t> delta;
+    };
+
+    struct IntervalPercentiles {
+        uint64_t count = 0;
+        uint64_t p50_ns = 0;
+        uint64_t p99_ns = 0;
+        uint64_t max_ns = 0;
+    };
+
+    /**
+     * @brief 计算自游标上次读取以来新增样本的 p50 / p99 / max，并推进游标
+     *
+     * 可与 record() 并发调用（结果为近似快照）；每次遍历全部桶，适合百毫秒级的区间采样。
+     * reset() 后应同时清空游标（cursor = {}）。
+     */
+    IntervalPercentiles intervalSince(IntervalCursor& cursor) const;
+
+private:
+    static size_t indexFor(uint64_t value);
+    static uint64_t highestEquivalentValue(size_t index);
+
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+    std::atomic<uint64_t> total_count_{ 0 };
+    std::atomic<uint64_t> overflow_count_{ 0 };
+    std::atomic<uint64_t> sum_ns_{ 0 };
+    std::atomic<uint64_t> min_value_{ UINT64_MAX };
+    std::atomic<uint64_t> max_value_{ 0 };
+};
@@ -3,10 +3,9 @@
 
 #include "DDSManager_Bytes.h"
 #include "TestRoundResult.h" // 包含 TestRoundResult 定义
+#include "PingPongEngine.h"
 #include <functional>
-#include <vector>
-#include <set>
-#include <chrono>
+#include <memory>
 
 // 前向声明
 class DDSManager_Bytes;
@@ -62,38 +61,13 @@ public:
 
 private:
     // --- 私有实现细节 ---
-    struct Impl; // PIMPL 模式，隐藏内部实现
+    struct Impl; // PIMPL 模式，隐藏内部实现（可复用的 Ping / Pong 样本）
     std::unique_ptr<Impl> p_impl_;
 
     // --- 依赖 ---
     DDSManager_Bytes& dds_manager_;
     ResultCallback result_callback_;
 
-    // --- 状态 ---
-    std::chrono::steady_clock::time_point start_time_;
-    std::chrono::steady_clock::time_point end_time_;
-    std::vector<double> rtt_times_us_;      // 存储每次测得的RTT（微秒）
-    std::set<uint32_t> received_sequences_; // 记录收到的Pong序列号，用于计算丢包
-
-    // --- 内部方法 ---
-
-    /**
-     * @brief 同步等待 Responder 上线并匹配成功
-     * @param timeout 超时时间
-     * @return true 成功，false 超时或失败
-     */
-    bool waitForResponderReady(const std::chrono::seconds& timeout);
-
-    /**
-     * @brief 收到结束包时的回调
-     */
-    void onEndOfRound();
-
-    /**
-     * @brief 报告本轮测试结果
-     * @param round_index 轮次索引
-     * @param expected_count 预期发送数量
-     * @param avg_packet_size 平均包大小
-     */
-    void report_results(int round_index, int expected_count, int avg_packet_size);
+    // 收发流程与 RTT 统计（与零拷贝版本共用）
+    PingPongEngine engine_;
 };
@@ -0,0 +1,168 @@
+﻿// LatencyTest_ZeroCopyBytes.cpp
+#include "LatencyTest_ZeroCopyBytes.h"
+#include "Logger.h"
+#include "GloMemPool.h"
+#include "PacketHeader.h"
+#include "ZRDDSDataWriter.h"
+#include "ZRDDSDataReader.h"
+#include "ZRBuiltinTypes.h"
+#include <algorithm>
+
+using namespace DDS;
+using namespace std;
+
+struct LatencyTest_ZeroCopyBytes::Impl {
+    // 可复用样本：缓冲区归 DDSManager_ZeroCopyBytes 所有，这里只保存字段绑定
+    // Ping 由发送线程独占，Pong 由 DDS 监听线程独占
+    DDS_ZeroCopyBytes ping_sample_{};
+    DDS_ZeroCopyBytes pong_sample_{};
+    int pong_capacity_ = 0;
+    uint64_t pong_generation_ = 0;                  // 绑定时的 DDSManager 缓冲区代次
+};
+
+LatencyTest_ZeroCopyBytes::LatencyTest_ZeroCopyBytes(DDSManager_ZeroCopyBytes& dds_manager, ResultCallback callback)
+    : p_impl_(std::make_unique<Impl>())
+    , dds_manager_(dds_manager)
+    , result_callback_(std::move(callback))
+    , engine_("LatencyTest_ZeroCopyBytes", "零拷贝时延测试")
+{
+}
+
+LatencyTest_ZeroCopyBytes::~LatencyTest_ZeroCopyBytes() = default;
+
+// ========================
+// Responder 回调
+// ========================
+
+void LatencyTest_ZeroCopyBytes::onDataReceived(const DDS_ZeroCopyBytes& sample, const DDS::SampleInfo& info) {
+    if (!info.valid_data || !sample.userBuffer || sample.userLength < sizeof(PacketHeader)) return;
+    const PacketHeader* hdr = reinterpret_cast<const PacketHeader*>(sample.userBuffer);
+
+    size_t allocs_before = GloMemPool::getThreadAllocCount();
+    const int reply_size = static_cast<int>(sample.userLength);
+    DDS_ZeroCopyBytes& pong = p_impl_->pong_sample_;
+    if (reply_size > p_impl_->pong_capacity_ || p_impl_->pong_generation_ != dds_manager_.buffer_generation()) {
+        // 首次收到、超出容量或全局缓冲区已重建：在监听线程上重新绑定，预热分配不计入热路径
+        const int capacity = std::max(reply_size, engine_.pongCapacityHint());
+        if (!dds_manager_.ensureBufferSize(static_cast<size_t>(capacity)) ||
+            !dds_manager_.prepareReusableZeroCopyData(pong, capacity)) {
+            Logger::getInstance().error("LatencyTest_ZeroCopyBytes: 构建可复用 Pong 样本失败");
+            return;
+        }
+        p_impl_->pong_capacity_ = capacity;
+        p_impl_->pong_generation_ = dds_manager_.buffer_generation();
+        allocs_before = GloMemPool::getThreadAllocCount();
+    }
+
+    PacketHeader* out_hdr = reinterpret_cast<PacketHeader*>(pong.userBuffer);
+    out_hdr->sequence = hdr->sequence;
+    out_hdr->timestamp = hdr->timestamp;
+    out_hdr->packet_type = 0;
+    pong.userLength = static_cast<DDS_ULong>(reply_size);
+
+    DDSManager_ZeroCopyBytes::ZCWriter* pong_writer = dds_manager_.get_Pong_typed_writer();
+    if (pong_writer) {
+        ReturnCode_t ret = pong_writer->write(pong, DDS_HANDLE_NIL_NATIVE);
+        if (ret != RETCODE_OK) {
+            Logger::getInstance().error("Pong write failed: " + to_string(ret));
+        }
+    }
+    size_t allocs = GloMemPool::getThreadAllocCount() - allocs_before;
+    if (allocs > 0) {
+        engine_.addHotPathAllocs(allocs);
+    }
+    engine_.countPong();
+}
+
+void LatencyTest_ZeroCopyBytes::onEndOfRound() {
+    Logger::getInstance().logAndPrint("[onEndOfRound] 收到结束信号，回复 Pong 结束包并退出本轮");
+
+    DDS_ZeroCopyBytes pong_end_sample{};
+    if (dds_manager_.prepareEndZeroCopyData(pong_end_sample)) {
+        DDSManager_ZeroCopyBytes::ZCWriter* pong_writer = dds_manager_.get_Pong_typed_writer();
+        if (pong_writer) {
+            ReturnCode_t ret = pong_writer->write(pong_end_sample, DDS_HANDLE_NIL_NATIVE);
+            if (ret != RETCODE_OK) {
+                Logger::getInstance().error("Pong End write failed: " + to_string(ret));
+            }
+        }
+    }
+    engine_.signalEndOfRound();
+}
+
+// ========================
+// runPublisher - Initiator: 发送 Ping 并接收 Pong
+// ========================
+
+int LatencyTest_ZeroCopyBytes::runPublisher(const ConfigData& config) {
+    DDSManager_ZeroCopyBytes::ZCWriter* ping_writer = dds_manager_.get_Ping_typed_writer();
+    if (!ping_writer) {
+        Logger::getInstance().error("LatencyTest_ZeroCopyBytes: Ping DataWriter 为空");
+        return -1;
+    }
+
+    PingPongEngine::Transport transport;
+    // 全局缓冲区按本轮最大包长扩容，Ping 样本绑定后只改写包头
+    transport.preparePing = [this](int max_size) -> PacketHeader* {
+        const int header_size = static_cast<int>(sizeof(PacketHeader));
+        if (!dds_manager_.ensureBufferSize(static_cast<size_t>(std::max(max_size, header_size))) ||
+            !dds_manager_.prepareReusableZeroCopyData(p_impl_->ping_sample_, max_size)) {
+            return nullptr;
+        }
+        return reinterpret_cast<PacketHeader*>(p_impl_->ping_sample_.userBuffer);
+    };
+    transport.writePing = [this, ping_writer](int length) {
+        p_impl_->ping_sample_.userLength = static_cast<DDS_ULong>(length);
+        return ping_writer->write(p_impl_->ping_sample_, DDS_HANDLE_NIL_NATIVE);
+    };
+    // 结束包由 DDSManager 写在独立缓冲区中，不改写可能仍被借用的 Ping 缓冲区
+    transport.writeEnd = [this, ping_writer]() -> ReturnCode_t {
+        DDS_ZeroCopyBytes end_sample{};
+        if (!dds_manager_.prepareEndZeroCopyData(end_sample)) {
+            return RETCODE_ERROR;
+        }
+        return ping_writer->write(end_sample, DDS_HANDLE_NIL_NATIVE);
+    };
+
+    TestRoundResult round_result;
+    if (engine_.runInitiator(config, dds_manager_.match_tracker(), dds_manager_.get_Ping_data_writer(),
+        transport, round_result) != 0) {
+        return -1;
+    }
+    round_result.perf.time_to_match_ms = dds_manager_.match_tracker().lastTimeToMatchMs();
+    if (dds_manager_.sample_verifier().enabled()) {
+        Logger::getInstance().logAndPrint("Pong " + formatIntegrityStats(dds_manager_.sample_verifier().snapshot()));
+    }
+    if (result_callback_) {
+        result_callback_(round_result);
+    }
+    return 0;
+}
+
+// ========================
+// handlePongReceived - Initiator 处理 Pong（结束包已被 DDSManager 的监听器拦截）
+// ========================
+
+void LatencyTest_ZeroCopyBytes::handlePongReceived(const DDS_ZeroCopyBytes& sample, const DDS::SampleInfo& info) {
+    if (!info.valid_data || !sample.userBuffer || sample.userLength < sizeof(PacketHeader)) return;
+    engine_.onPong(*reinterpret_cast<const PacketHeader*>(sample.userBuffer));
+}
+
+// ========================
+// runSubscriber - Responder: 接收 Ping 并回 Pong（回包在监听线程内完成）
+// ========================
+
+int LatencyTest_ZeroCopyBytes::runSubscriber(const ConfigData& config) {
+    DDS::DataReader* ping_reader = dds_manager_.get_Ping_data_reader();
+    if (!ping_reader) {
+        Logger::getInstance().error("LatencyTest_ZeroCopyBytes: Ping DataReader 为空");
+        return -1;
+    }
+    if (engine_.runResponder(config, dds_manager_.match_tracker(), ping_reader) != 0) {
+        return -1;
+    }
+    if (dds_manager_.sample_verifier().enabled()) {
+        Logger::getInstance().logAndPrint("Ping " + formatIntegrityStats(dds_manager_.sample_verifier().snapshot()));
+    }
+    return 0;
+}
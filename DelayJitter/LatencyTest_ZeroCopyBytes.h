@@ -0,0 +1,72 @@
+﻿// LatencyTest_ZeroCopyBytes.h
+#pragma once
+
+#include "DDSManager_ZeroCopyBytes.h"
+#include "TestRoundResult.h"
+#include "PingPongEngine.h"
+#include <functional>
+#include <memory>
+
+/**
+ * @brief 零拷贝时延测试类，用于测量 DDS_ZeroCopyBytes 的 PING-PONG RTT。
+ *
+ * 与 LatencyTest_Bytes 的统计口径与输出格式一致（直方图、开环修正、同步闭环），
+ * 区别在于 Ping/Pong 样本直接绑定 DDSManager_ZeroCopyBytes 的全局缓冲区，发送时只改写包头。
+ */
+class LatencyTest_ZeroCopyBytes {
+public:
+    using ResultCallback = std::function<void(const TestRoundResult&)>;
+
+    /**
+     * @brief 构造函数
+     * @param dds_manager 引用一个已配置的 DDSManager_ZeroCopyBytes 实例
+     * @param callback 测试结果回调函数
+     */
+    LatencyTest_ZeroCopyBytes(DDSManager_ZeroCopyBytes& dds_manager, ResultCallback callback);
+
+    ~LatencyTest_ZeroCopyBytes();
+
+    // --- 主要功能接口 ---
+
+    /**
+     * @brief 运行作为 Initiator (发送 Ping)
+     * @param config 当前轮次的配置
+     * @return 0 成功，非0 失败
+     */
+    int runPublisher(const ConfigData& config);
+
+    /**
+     * @brief 运行作为 Responder (接收 Ping 并回复 Pong)
+     * @param config 当前轮次的配置
+     * @return 0 成功，非0 失败
+     */
+    int runSubscriber(const ConfigData& config);
+
+    /**
+     * @brief 收到 Pong 数据包时的回调（Initiator）
+     */
+    void handlePongReceived(const DDS_ZeroCopyBytes& sample, const DDS::SampleInfo& info);
+
+    /**
+     * @brief 收到 Ping 数据包时的回调（Responder）
+     */
+    void onDataReceived(const DDS_ZeroCopyBytes& sample, const DDS::SampleInfo& info);
+
+    /**
+     * @brief 收到 Ping 结束包时的回调（Responder）：回复 Pong 结束包并结束本轮
+     *
+     * DDSManager_ZeroCopyBytes 的监听器会拦截结束包，因此需作为 end_callback 传入 initialize_latency。
+     */
+    void onEndOfRound();
+
+private:
+    struct Impl; // PIMPL 模式，隐藏内部实现（可复用的 Ping / Pong 样本绑定）
+    std::unique_ptr<Impl> p_impl_;
+
+    // --- 依赖 ---
+    DDSManager_ZeroCopyBytes& dds_manager_;
+    ResultCallback result_callback_;
+
+    // 收发流程与 RTT 统计（与 LatencyTest_Bytes 共用）
+    PingPongEngine engine_;
+};
@@ -0,0 +1,364 @@
+﻿// PingPongEngine.cpp
+#include "PingPongEngine.h"
+#include "Logger.h"
+#include "ResourceUtilization.h"
+#include "SysMetrics.h"
+#include "RateController.h"
+#include "IntervalRecorder.h"
+#include "GloMemPool.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace {
+    constexpr auto kSyncPongTimeout = std::chrono::seconds(1);    // 同步模式单个 Pong 等待超时
+    constexpr auto kDrainPongTimeout = std::chrono::seconds(5);   // 发送结束后等待剩余 Pong 的上限
+    constexpr auto kEndOfRoundTimeout = std::chrono::seconds(30); // Responder 等待结束包的上限
+    constexpr size_t kSizeTableSize = 4096;                       // 预抽样包大小表长度（2 的幂）
+    constexpr uint64_t kPongPrintGap = 10000;                     // Responder 回包进度打印间隔
+
+    inline uint64_t steady_now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+PingPongEngine::PingPongEngine(std::string log_tag, std::string title)
+    : log_tag_(std::move(log_tag))
+    , title_(std::move(title))
+    , send_slots_(new SendSlot[kSendSlotCount])
+{
+}
+
+// ========================
+// Initiator
+// ========================
+
+bool PingPongEngine::waitForResponder(MatchTracker& matches, DDS::DataWriter* ping_writer, const std::chrono::seconds& timeout) {
+    Logger::getInstance().logAndPrint(log_tag_ + ": 等待 Responder 上线...");
+
+    // Ping Writer 挂有 MatchTracker 的匹配监听器，Responder 匹配即唤醒
+    if (!matches.waitForWriters({ ping_writer }, timeout)) {
+        Logger::getInstance().logAndPrint("等待 Responder 上线超时 (" + std::to_string(timeout.count()) + "s)");
+        return false;
+    }
+    Logger::getInstance().logAndPrint(formatTimeToMatch("Responder", matches.lastTimeToMatchMs()));
+    return true;
+}
+
+int PingPongEngine::runInitiator(const ConfigData& config, MatchTracker& matches, DDS::DataWriter* ping_writer,
+    const Transport& transport, TestRoundResult& result) {
+    const int round_index = config.m_activeLoop;
+    const int min_size = config.m_minSize[round_index];
+    const int max_size = config.m_maxSize[round_index];
+    const int send_count = config.m_sendCount[round_index];
+    const int print_gap = config.m_sendPrintGap[round_index];
+
+    if (!waitForResponder(matches, ping_writer, std::chrono::seconds(config.m_matchTimeoutSec))) {
+        Logger::getInstance().logAndPrint(log_tag_ + ": 等待 Responder 上线失败");
+        return -1;
+    }
+
+    std::ostringstream oss;
+    oss << "第 " << (round_index + 1) << " 轮" << title_ << "（Initiator）| 发送: " << send_count
+        << " 次 | 数据大小: [" << min_size << ", " << max_size << "]";
+    Logger::getInstance().logAndPrint(oss.str());
+
+    // === 发送节奏：按 m_sendDelay / m_sendDelayCount 控制；开环模式按计划发送时刻计时 ===
+    RateController rate(config, round_index);
+    const bool open_loop = (config.m_latencyMode == "ol");
+    const bool sync_mode = config.m_useSyncDelay;
+    if (sync_mode && open_loop) {
+        Logger::getInstance().logAndPrint("警告：m_useSyncDelay 与开环模式互斥，按同步闭环模式运行");
+    }
+    if (sync_mode) {
+        Logger::getInstance().logAndPrint("同步闭环模式：每次仅 1 个 Ping 在途，收到对应 Pong 后再发送下一个");
+    }
+    if (open_loop && !sync_mode && !rate.enabled()) {
+        Logger::getInstance().logAndPrint("警告：开环模式未配置 m_sendDelay，将按饱和速率发送，修正值与未修正值相同");
+    }
+    if ((open_loop && !sync_mode) || rate.enabled()) {
+        Logger::getInstance().logAndPrint(std::string(open_loop && !sync_mode ? "开环模式 | " : "闭环模式 | ") + rate.describe());
+    }
+
+    // === 计时窗口外准备：可复用 Ping 样本（按本轮最大包长）与包大小表 ===
+    PacketHeader* ping_hdr = transport.preparePing(max_size);
+    if (!ping_hdr) {
+        Logger::getInstance().error(log_tag_ + ": 构建可复用 Ping 样本失败");
+        return -1;
+    }
+    const int header_size = static_cast<int>(sizeof(PacketHeader));
+    if (min_size != max_size) {
+        std::mt19937 gen(std::random_device{}());
+        std::uniform_int_distribution<int> dis(min_size, max_size);
+        size_table_.resize(kSizeTableSize);
+        for (auto& s : size_table_) {
+            s = std::max(dis(gen), header_size);
+        }
+    }
+    const int fixed_size = std::max(min_size, header_size);
+
+    auto& resUtil = ResourceUtilization::instance();
+    resUtil.registerCurrentThread("sender");
+    SysMetrics start_metrics = resUtil.collectCurrentMetrics();
+    const auto start_time = std::chrono::steady_clock::now();
+    rtt_hist_.reset();
+    rtt_uncorrected_hist_.reset();
+    received_count_.store(0);
+
+    // 区间采样：Pong 接收数 + 区间 RTT 分位（基于 rtt_hist_ 的桶差分，采样线程独占游标）
+    const uint64_t avg_payload = static_cast<uint64_t>((min_size + max_size) / 2);
+    auto rtt_cursor = std::make_shared<LatencyHistogram::IntervalCursor>();
+    IntervalRecorder recorder(config.m_sampleIntervalMs);
+    recorder.start(
+        [this, avg_payload] {
+            IntervalRecorder::Counters c;
+            c.messages = received_count_.load(std::memory_order_relaxed);
+            c.bytes = c.messages * avg_payload;
+            return c;
+        },
+        [this, rtt_cursor](IntervalSample& s) {
+            const LatencyHistogram::IntervalPercentiles p = rtt_hist_.intervalSince(*rtt_cursor);
+            s.latency_count = p.count;
+            s.latency_p50_us = p.p50_ns / 1000.0;
+            s.latency_p99_us = p.p99_ns / 1000.0;
+            s.latency_max_us = p.max_ns / 1000.0;
+        });
+    for (uint32_t k = 0; k < kSendSlotCount; ++k) {
+        send_slots_[k].sequence.store(UINT32_MAX, std::memory_order_relaxed);
+    }
+    open_loop_.store(open_loop && !sync_mode);
+    sync_mode_.store(sync_mode);
+    last_pong_seq_.store(UINT32_MAX);
+    expected_pongs_.store(UINT64_MAX);
+
+    const size_t allocs_before = GloMemPool::getThreadAllocCount();
+    rate.start();
+    int sent = 0;
+    int sync_timeouts = 0;
+    for (int i = 0; i < send_count; ++i) {
+        // 开环模式下时间戳取计划发送时刻：发送端阻塞造成的排队时延会计入结果（协调遗漏修正）
+        auto scheduled = rate.waitNext();
+        const uint64_t send_timestamp_ns = open_loop_.load(std::memory_order_relaxed)
+            ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(scheduled.time_since_epoch()).count())
+            : steady_now_ns();
+        ping_hdr->sequence = static_cast<uint32_t>(i);
+        ping_hdr->timestamp = send_timestamp_ns;
+        ping_hdr->packet_type = 0; // DATA_PACKET
+
+        if (open_loop_.load(std::memory_order_relaxed)) {
+            SendSlot& slot = send_slots_[static_cast<uint32_t>(i) & (kSendSlotCount - 1)];
+            slot.send_ns.store(steady_now_ns(), std::memory_order_relaxed);
+            slot.sequence.store(static_cast<uint32_t>(i), std::memory_order_release);
+        }
+
+        const DDS::ReturnCode_t ret = transport.writePing(
+            min_size == max_size ? fixed_size : size_table_[static_cast<size_t>(i) & (kSizeTableSize - 1)]);
+        if (ret == DDS::RETCODE_OK) {
+            ++sent;
+            if (print_gap > 0 && sent % print_gap == 0) {
+                Logger::getInstance().logAndPrint("已发送 " + std::to_string(sent) + " 个 Ping");
+            }
+        }
+        else {
+            Logger::getInstance().error("Ping write failed: " + std::to_string(ret));
+        }
+
+        // 同步模式：等待本序列号的 Pong 返回（超时视为丢失，继续下一个）
+        if (sync_mode && ret == DDS::RETCODE_OK) {
+            const uint32_t seq = static_cast<uint32_t>(i);
+            std::unique_lock<std::mutex> lock(pong_mtx_);
+            if (!pong_cv_.wait_for(lock, kSyncPongTimeout, [this, seq] {
+                return last_pong_seq_.load() == seq;
+                })) {
+                if (++sync_timeouts <= 10) {
+                    Logger::getInstance().logAndPrint("警告：等待 Pong 超时 | seq=" + std::to_string(seq));
+                }
+            }
+        }
+    }
+    if (rate.enabled()) {
+        Logger::getInstance().logAndPrint(rate.summary(static_cast<uint64_t>(sent)));
+    }
+    const size_t hot_allocs = GloMemPool::getThreadAllocCount() - allocs_before;
+    if (hot_allocs != 0) {
+        Logger::getInstance().error("断言失败：Ping 发送热路径发生 " + std::to_string(hot_allocs) + " 次内存池分配");
+    }
+    else {
+        Logger::getInstance().logAndPrint("Ping 发送热路径内存池分配: 0");
+    }
+    if (sync_timeouts > 0) {
+        Logger::getInstance().logAndPrint("同步模式 Pong 超时次数: " + std::to_string(sync_timeouts));
+    }
+
+    // 发送结束包（通知 Responder 本轮结束）
+    const DDS::ReturnCode_t end_ret = transport.writeEnd();
+    if (end_ret == DDS::RETCODE_OK) {
+        Logger::getInstance().logAndPrint("已发送结束包，通知 Responder 本轮结束");
+    }
+    else {
+        Logger::getInstance().error("发送结束包失败: " + std::to_string(end_ret));
+    }
+
+    // 等待所有回复：全部 Pong 返回后立即结束，最多等待 kDrainPongTimeout
+    {
+        std::unique_lock<std::mutex> lock(pong_mtx_);
+        expected_pongs_.store(static_cast<uint64_t>(sent));
+        if (!pong_cv_.wait_for(lock, kDrainPongTimeout, [this, sent] {
+            return received_count_.load() >= static_cast<uint64_t>(sent);
+            })) {
+            Logger::getInstance().logAndPrint("等待剩余 Pong 超时，已收到 " +
+                std::to_string(received_count_.load()) + "/" + std::to_string(sent));
+        }
+    }
+    const double round_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    recorder.stopInto(result);
+    result.round_index = round_index + 1;
+    result.start_metrics = start_metrics;
+    result.end_metrics = resUtil.collectCurrentMetrics();
+
+    reportResults(round_index, static_cast<uint64_t>(sent));
+    fillPerformance(result.perf, static_cast<uint64_t>(sent), (min_size + max_size) / 2, round_seconds);
+    return 0;
+}
+
+void PingPongEngine::onPong(const PacketHeader& hdr) {
+    const uint64_t recv_time_ns = steady_now_ns();
+    const int64_t rtt = static_cast<int64_t>(recv_time_ns - hdr.timestamp);
+    if (rtt > 0) {
+        rtt_hist_.record(static_cast<uint64_t>(rtt)); // 无锁、无分配
+    }
+    if (open_loop_.load(std::memory_order_relaxed)) {
+        // 未修正值：从实际发送时刻起算
+        const SendSlot& slot = send_slots_[hdr.sequence & (kSendSlotCount - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) == hdr.sequence) {
+            const int64_t raw = static_cast<int64_t>(recv_time_ns - slot.send_ns.load(std::memory_order_relaxed));
+            if (raw > 0) {
+                rtt_uncorrected_hist_.record(static_cast<uint64_t>(raw));
+            }
+        }
+    }
+    const uint64_t received = received_count_.fetch_add(1) + 1;
+
+    // 唤醒等待中的发送线程（同步模式每个 Pong 唤醒一次；其他模式仅在全部收齐时唤醒）
+    if (sync_mode_.load(std::memory_order_relaxed) || received >= expected_pongs_.load()) {
+        {
+            std::lock_guard<std::mutex> lock(pong_mtx_);
+            last_pong_seq_.store(hdr.sequence);
+        }
+        pong_cv_.notify_one();
+    }
+}
+
+void PingPongEngine::reportResults(int round_index, uint64_t sent_count) {
+    const uint64_t received = received_count_.load();
+    const uint64_t lost = sent_count > received ? sent_count - received : 0;
+    const double loss_rate = sent_count > 0 ? static_cast<double>(lost) / sent_count * 100.0 : 0.0;
+    if (rtt_hist_.count() == 0) {
+        Logger::getInstance().logAndPrint("警告：未收到任何 Pong 回包");
+        return;
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << title_ << "结果 | 第 " << (round_index + 1) << " 轮 | "
+        << "发送: " << sent_count << " | "
+        << "收到: " << received << " | "
+        << "丢包: " << lost << " (" << loss_rate << "%) | "
+        << (open_loop_.load() ? "RTT(修正) " : "RTT ") << rtt_hist_.percentileSummary();
+    Logger::getInstance().logAndPrint(oss.str());
+    if (open_loop_.load() && rtt_uncorrected_hist_.count() > 0) {
+        Logger::getInstance().logAndPrint(title_ + "结果 | 第 " + std::to_string(round_index + 1) +
+            " 轮 | RTT(未修正) " + rtt_uncorrected_hist_.percentileSummary());
+    }
+    if (rtt_hist_.overflowCount() > 0) {
+        Logger::getInstance().logAndPrint("警告：" + std::to_string(rtt_hist_.overflowCount()) +
+            " 个 RTT 超出直方图量程，已按最大值计入");
+    }
+
+    // 汇总到跨轮次直方图
+    total_rtt_hist_.merge(rtt_hist_);
+    ++completed_rounds_;
+    Logger::getInstance().logAndPrint(title_ + "累计结果 | 共 " + std::to_string(completed_rounds_) + " 轮 | 样本: " +
+        std::to_string(total_rtt_hist_.count()) + " | RTT " + total_rtt_hist_.percentileSummary());
+}
+
+void PingPongEngine::fillPerformance(RoundPerformance& perf, uint64_t sent, int payload_bytes, double round_seconds) const {
+    perf.role = "initiator";
+    perf.payload_bytes = payload_bytes;
+    perf.sent = sent;
+    perf.received = received_count_.load();
+    perf.lost = perf.sent > perf.received ? perf.sent - perf.received : 0;
+    perf.loss_rate_percent = sent > 0 ? static_cast<double>(perf.lost) / sent * 100.0 : 0.0;
+    perf.duration_ms = round_seconds * 1000.0;
+    if (round_seconds > 0) {
+        perf.msgs_per_sec = perf.received / round_seconds;
+        perf.mb_per_sec = perf.received * static_cast<double>(perf.payload_bytes) / round_seconds / (1024.0 * 1024.0);
+    }
+    perf.latency_count = rtt_hist_.count();
+    perf.latency_min_us = rtt_hist_.minValue() / 1000.0;
+    perf.latency_mean_us = rtt_hist_.mean() / 1000.0;
+    perf.latency_p50_us = rtt_hist_.valueAtPercentile(50.0) / 1000.0;
+    perf.latency_p90_us = rtt_hist_.valueAtPercentile(90.0) / 1000.0;
+    perf.latency_p99_us = rtt_hist_.valueAtPercentile(99.0) / 1000.0;
+    perf.latency_p999_us = rtt_hist_.valueAtPercentile(99.9) / 1000.0;
+    perf.latency_max_us = rtt_hist_.maxValue() / 1000.0;
+}
+
+// ========================
+// Responder
+// ========================
+
+int PingPongEngine::runResponder(const ConfigData& config, MatchTracker& matches, DDS::DataReader* ping_reader) {
+    const int round_index = config.m_activeLoop;
+
+    // 在可能收到数据前重置本轮状态；Pong 样本按本轮最大包长预分配（由监听线程在首个 Ping 时构建）
+    pong_capacity_hint_.store(config.m_maxSize[round_index]);
+    hot_path_allocs_.store(0);
+    pong_count_.store(0);
+    end_of_round_received_.store(false);
+
+    Logger::getInstance().logAndPrint(log_tag_ + ": 等待 Initiator 上线...");
+    if (!matches.waitForReaders({ ping_reader }, std::chrono::seconds(config.m_matchTimeoutSec))) {
+        Logger::getInstance().logAndPrint(log_tag_ + ": 等待 Initiator 上线超时");
+        return -1;
+    }
+    Logger::getInstance().logAndPrint(formatTimeToMatch("Initiator", matches.lastTimeToMatchMs()));
+
+    Logger::getInstance().logAndPrint("第 " + std::to_string(round_index + 1) + " 轮" + title_ + "开始（Responder 模式）");
+    {
+        std::unique_lock<std::mutex> lock(end_mtx_);
+        if (end_cv_.wait_for(lock, kEndOfRoundTimeout, [this] { return end_of_round_received_.load(); })) {
+            Logger::getInstance().logAndPrint("成功收到结束包，本轮 Responder 正常退出 | 已回复 Pong: " +
+                std::to_string(pong_count_.load()));
+        }
+        else {
+            Logger::getInstance().logAndPrint("等待结束包超时，强制退出本轮");
+        }
+    }
+
+    const uint64_t hot_allocs = hot_path_allocs_.load();
+    if (hot_allocs != 0) {
+        Logger::getInstance().error("断言失败：Pong 回复热路径发生 " + std::to_string(hot_allocs) + " 次内存池分配");
+    }
+    else {
+        Logger::getInstance().logAndPrint("Pong 回复热路径内存池分配: 0");
+    }
+    return 0;
+}
+
+void PingPongEngine::countPong() {
+    const uint64_t count = pong_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (count % kPongPrintGap == 0) {
+        Logger::getInstance().logAndPrint("已回复 " + std::to_string(count) + " 个 Pong");
+    }
+}
+
+void PingPongEngine::signalEndOfRound() {
+    {
+        std::lock_guard<std::mutex> lock(end_mtx_);
+        end_of_round_received_.store(true);
+    }
+    end_cv_.notify_one();
+}
@@ -0,0 +1,121 @@
+﻿// PingPongEngine.h
+#pragma once
+
+#include "ConfigData.h"
+#include "TestRoundResult.h"
+#include "LatencyHistogram.h"
+#include "MatchTracker.h"
+#include "PacketHeader.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief PING-PONG 时延测试引擎：LatencyTest_Bytes / LatencyTest_ZeroCopyBytes 共用的收发流程与统计。
+ *
+ * Initiator：等待 Responder 匹配 → 按 RateController 发送 Ping（同步闭环 / 开环修正）→ 发送结束包 →
+ * 等待剩余 Pong → 输出本轮与累计 RTT 并填写 RoundPerformance。
+ * Responder：等待 Initiator 匹配 → 等待结束包（回包在 DDS 监听线程内由调用方完成）→ 检查热路径分配。
+ *
+ * 引擎不接触样本类型：绑定可复用样本、写出 Ping / 结束包由调用方通过 Transport 提供，
+ * 收到 Pong / Ping 后调用方解析包头再交给 onPong() / countPong()。
+ */
+class PingPongEngine {
+public:
+    /**
+     * @brief Initiator 的样本操作（均在发送线程调用）
+     */
+    struct Transport {
+        // 计时窗口外按本轮最大包长准备可复用 Ping 样本，返回其包头（失败返回 nullptr）
+        std::function<PacketHeader*(int max_size)> preparePing;
+        // 设置 Ping 长度并写出；热路径，不得分配内存
+        std::function<DDS::ReturnCode_t(int length)> writePing;
+        // 写出本轮结束包（不得与在途 Ping 共用缓冲区）
+        std::function<DDS::ReturnCode_t()> writeEnd;
+    };
+
+    /**
+     * @param log_tag 日志前缀（类名）
+     * @param title 结果行标题，如 "时延测试" / "零拷贝时延测试"
+     */
+    PingPongEngine(std::string log_tag, std::string title);
+
+    PingPongEngine(const PingPongEngine&) = delete;
+    PingPongEngine& operator=(const PingPongEngine&) = delete;
+
+    // --- Initiator ---
+
+    /**
+     * @brief 运行一轮 Initiator；Responder 匹配等待上限为 m_matchTimeoutSec
+     * @param result 本轮区间采样、资源与性能汇总（time_to_match 与回调由调用方处理）
+     * @return 0 成功，非0 失败
+     */
+    int runInitiator(const ConfigData& config, MatchTracker& matches, DDS::DataWriter* ping_writer,
+        const Transport& transport, TestRoundResult& result);
+
+    /**
+     * @brief 收到 Pong 数据包（Pong 监听线程调用，结束包由调用方过滤）
+     */
+    void onPong(const PacketHeader& hdr);
+
+    // --- Responder ---
+
+    /**
+     * @brief 运行一轮 Responder：等待 Initiator 匹配后阻塞到 signalEndOfRound() 或超时
+     * @return 0 成功，非0 失败
+     */
+    int runResponder(const ConfigData& config, MatchTracker& matches, DDS::DataReader* ping_reader);
+
+    // 以下由回包的 DDS 监听线程调用
+    int pongCapacityHint() const { return pong_capacity_hint_.load(std::memory_order_relaxed); }
+    void addHotPathAllocs(size_t allocs) { hot_path_allocs_.fetch_add(allocs, std::memory_order_relaxed); }
+    void countPong();
+    void signalEndOfRound();
+
+private:
+    bool waitForResponder(MatchTracker& matches, DDS::DataWriter* ping_writer, const std::chrono::seconds& timeout);
+    void reportResults(int round_index, uint64_t sent_count);
+    void fillPerformance(RoundPerformance& perf, uint64_t sent, int payload_bytes, double round_seconds) const;
+
+    std::string log_tag_;
+    std::string title_;
+
+    // --- Initiator 状态 ---
+    LatencyHistogram rtt_hist_;             // 本轮 RTT 直方图（纳秒，固定内存）；开环模式下为修正后的时延
+    LatencyHistogram total_rtt_hist_;       // 跨轮次累计 RTT 直方图
+    LatencyHistogram rtt_uncorrected_hist_; // 开环模式：按实际发送时刻计算的（未修正）RTT
+
+    // 开环模式下记录每个 Ping 的实际发送时刻（按序列号取模的环形槽位）
+    struct SendSlot {
+        std::atomic<uint32_t> sequence{ UINT32_MAX };
+        std::atomic<uint64_t> send_ns{ 0 };
+    };
+    static constexpr uint32_t kSendSlotCount = 1u << 14;
+    std::unique_ptr<SendSlot[]> send_slots_;
+    std::atomic<bool> open_loop_{ false };          // 本轮是否为开环模式 (m_latencyMode == "ol")
+    std::atomic<uint64_t> received_count_{ 0 };     // 本轮收到的 Pong 数量，用于计算丢包
+    int completed_rounds_ = 0;                      // 已汇总到 total_rtt_hist_ 的轮数
+    std::vector<int> size_table_;                   // min != max 时预先抽样的包大小
+
+    // Initiator 等待 Pong：同步模式等待单个序列号，结束时等待全部回包
+    std::mutex pong_mtx_;
+    std::condition_variable pong_cv_;
+    std::atomic<uint32_t> last_pong_seq_{ UINT32_MAX };    // 最近收到的 Pong 序列号
+    std::atomic<uint64_t> expected_pongs_{ UINT64_MAX };   // 发送结束后置为实际发送数
+    std::atomic<bool> sync_mode_{ false };                  // m_useSyncDelay：同一时刻只有一个 Ping 在途
+
+    // --- Responder 状态 ---
+    std::atomic<bool> end_of_round_received_{ false };
+    std::mutex end_mtx_;
+    std::condition_variable end_cv_;
+    std::atomic<int> pong_capacity_hint_{ 0 };      // 按本轮最大包长给出的 Pong 预分配大小
+    std::atomic<uint64_t> hot_path_allocs_{ 0 };    // 稳态回包过程中的内存池分配次数
+    std::atomic<uint64_t> pong_count_{ 0 };         // 本轮已回复的 Pong 数
+};
@@ -0,0 +1,444 @@
+﻿// TrafficTest.cpp
+#include "TrafficTest.h"
+#include "Config.h"
+#include "TestRoundResult.h"
+#include "Logger.h"
+#include "ResourceUtilization.h"
+#include "PacketHeader.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+
+using namespace DDS;
+
+namespace {
+    constexpr const char* kDefaultTopicName = "traffic_topic";
+
+    // 按 Domain 下标取值：数组不足时沿用最后一个，为空时返回默认值
+    template <typename T>
+    T valueAt(const std::vector<T>& vec, size_t index, const T& default_value) {
+        if (vec.empty()) return default_value;
+        return vec[std::min(index, vec.size() - 1)];
+    }
+
+    std::string topicOf(const ConfigData& profile) {
+        return profile.m_topicName.empty() ? std::string(kDefaultTopicName) : profile.m_topicName;
+    }
+}
+
+TrafficTest::TrafficTest(DDSManager_Scale& manager, ResultCallback callback)
+    : manager_(manager)
+    , result_callback_(std::move(callback))
+{
+}
+
+TrafficTest::~TrafficTest() = default;
+
+bool TrafficTest::loadProfiles(const Config& config, const ConfigData& traffic_config) {
+    auto load = [&config](const std::vector<std::string>& names, std::vector<ConfigData>& out, const char* kind) {
+        out.clear();
+        for (const auto& name : names) {
+            ConfigData profile;
+            if (!config.findConfig(name, profile)) {
+                Logger::getInstance().error("TrafficTest: 未找到" + std::string(kind) + "端点配置: " + name);
+                return false;
+            }
+            if (profile.m_typeName == "DDS::ZeroCopyBytes") {
+                Logger::getInstance().logAndPrint("[Warning] traffic:: 模式仅支持 DDS::Bytes，端点配置 " + name + " 按 Bytes 运行");
+            }
+            out.push_back(std::move(profile));
+        }
+        return true;
+        };
+
+    if (!load(traffic_config.m_writerConfigs, writer_profiles_, "Writer ") ||
+        !load(traffic_config.m_readerConfigs, reader_profiles_, "Reader ")) {
+        return false;
+    }
+    if (!traffic_config.m_pubNum.empty() || !traffic_config.m_subNum.empty()) {
+        Logger::getInstance().logAndPrint("TrafficTest: Writer / Reader 挂在 Participant 的隐式 Publisher / Subscriber 上，"
+            "m_pubNum / m_subNum 及对应 QoS 仅作记录");
+    }
+    Logger::getInstance().logAndPrint("TrafficTest: 已加载 Writer 端点配置 " + std::to_string(writer_profiles_.size()) +
+        " 个，Reader 端点配置 " + std::to_string(reader_profiles_.size()) + " 个");
+    return true;
+}
+
+int TrafficTest::profileRound(const ConfigData& profile, int round_index) const {
+    return std::max(0, std::min(round_index, profile.m_loopNum - 1));
+}
+
+int TrafficTest::domainIndexOf(int participant_index) const {
+    if (participant_index < 0 || participant_index >= static_cast<int>(participant_domain_index_.size())) return 0;
+    return participant_domain_index_[participant_index];
+}
+
+EntityPlan TrafficTest::prepareRound(const ConfigData& config) {
+    std::vector<int> domain_ids = config.m_domainIds;
+    if (domain_ids.empty()) {
+        domain_ids.push_back(config.m_domainId);
+    }
+
+    EntityPlan plan;
+    participant_domain_index_.clear();
+    std::vector<const ConfigData*> reader_profile_of;
+    std::vector<size_t> reader_expected_writers;
+    for (size_t k = 0; k < domain_ids.size(); ++k) {
+        const int dp_num = std::max(valueAt(config.m_dpNum, k, 1), 0);
+        const int writer_num = writer_profiles_.empty() ? 0 : std::max(valueAt(config.m_writerNum, k, 0), 0);
+        const int reader_num = reader_profiles_.empty() ? 0 : std::max(valueAt(config.m_readerNum, k, 0), 0);
+        for (int d = 0; d < dp_num; ++d) {
+            ParticipantPlan participant;
+            participant.domain_id = domain_ids[k];
+            participant.qos_name = valueAt(config.m_dpQosNames, k, std::string());
+            for (int w = 0; w < writer_num; ++w) {
+                const int flow = w % static_cast<int>(writer_profiles_.size());
+                const ConfigData& profile = writer_profiles_[flow];
+                participant.writers.push_back({ flow, topicOf(profile), profile.m_writerQosName });
+            }
+            for (int r = 0; r < reader_num; ++r) {
+                const int flow = r % static_cast<int>(reader_profiles_.size());
+                const ConfigData& profile = reader_profiles_[flow];
+                participant.readers.push_back({ flow, topicOf(profile), profile.m_readerQosName });
+                reader_profile_of.push_back(&profile);
+                reader_expected_writers.push_back(static_cast<size_t>(std::max(valueAt(config.m_remoteWriterNum, k, 1), 1)));
+            }
+            participant_domain_index_.push_back(static_cast<int>(k));
+            plan.push_back(std::move(participant));
+        }
+    }
+
+    // 接收统计须在 Reader 创建（监听器可能立即回调）之前就绪；下标与 DDSManager_Scale::readers() 一致
+    size_t writer_count = 0;
+    for (const auto& p : plan) writer_count += p.writers.size();
+    reader_flow_count_ = reader_profile_of.size();
+    reader_flows_.reset(reader_flow_count_ > 0 ? new ReaderFlow[reader_flow_count_] : nullptr);
+    for (size_t i = 0; i < reader_flow_count_; ++i) {
+        const ConfigData& profile = *reader_profile_of[i];
+        const int round = profileRound(profile, config.m_activeLoop);
+        reader_flows_[i].deadline_ns = profile.m_checkDeadLine > 0 ? static_cast<uint64_t>(profile.m_checkDeadLine) * 1000 : 0;
+        reader_flows_[i].print_gap = round < static_cast<int>(profile.m_recvPrintGap.size()) && profile.m_recvPrintGap[round] > 0
+            ? static_cast<uint64_t>(profile.m_recvPrintGap[round]) : 0;
+    }
+    writer_flows_.assign(writer_count, WriterSendStats{});
+    end_tracker_.reset(reader_expected_writers);
+    // 结束包按 Writer 标识去重：随机起点避免与其他进程的 Writer 标识冲突
+    std::mt19937 gen(std::random_device{}());
+    source_base_ = static_cast<uint32_t>(gen());
+
+    ResourceUtilization::instance().initialize();
+    return plan;
+}
+
+// ========================
+// 回调（DDS 监听线程）
+// ========================
+
+void TrafficTest::onDataReceived(size_t reader_index, const DDS::Bytes& sample, const DDS::SampleInfo&) {
+    if (reader_index >= reader_flow_count_) return;
+    ReaderFlow& f = reader_flows_[reader_index];
+    const uint64_t now = steadyNowNs();
+    const PacketHeader* hdr = reinterpret_cast<const PacketHeader*>(sample.value.get_contiguous_buffer());
+
+    const uint64_t received = f.received.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (received == 1) {
+        f.first_ns.store(now, std::memory_order_relaxed);
+    }
+    else if (f.deadline_ns > 0) {
+        const uint64_t last = f.last_ns.load(std::memory_order_relaxed);
+        const uint64_t gap = now > last ? now - last : 0;
+        if (gap > f.deadline_ns) {
+            f.deadline_misses.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (gap > f.max_gap_ns.load(std::memory_order_relaxed)) {
+            f.max_gap_ns.store(gap, std::memory_order_relaxed);
+        }
+    }
+    f.last_ns.store(now, std::memory_order_relaxed);
+    f.bytes.fetch_add(sample.value.length(), std::memory_order_relaxed);
+    if (hdr->timestamp > 0 && now >= hdr->timestamp) {
+        f.latency.record(now - hdr->timestamp);
+    }
+
+    if (f.print_gap > 0 && received % f.print_gap == 0) {
+        Logger::getInstance().logAndPrint("TrafficTest: Reader[" + std::to_string(reader_index) + "] 已接收 " + std::to_string(received));
+    }
+}
+
+void TrafficTest::onEndOfRound(size_t reader_index, uint32_t source) {
+    end_tracker_.onEnd(reader_index, source);
+}
+
+// ========================
+// 匹配等待：Writer 需匹配 m_remoteReaderNum 个 Reader，Reader 需匹配 m_remoteWriterNum 个 Writer
+// ========================
+
+bool TrafficTest::waitForMatch(const ConfigData& config, const std::chrono::seconds& timeout) {
+    std::vector<DataWriter*> writers;
+    std::vector<int32_t> writer_expected;
+    writers.reserve(manager_.writers().size());
+    writer_expected.reserve(manager_.writers().size());
+    for (const auto& w : manager_.writers()) {
+        writers.push_back(w.writer);
+        writer_expected.push_back(std::max(valueAt(config.m_remoteReaderNum, domainIndexOf(w.participant), 1), 1));
+    }
+    std::vector<DataReader*> readers;
+    std::vector<int32_t> reader_expected;
+    readers.reserve(manager_.readers().size());
+    reader_expected.reserve(manager_.readers().size());
+    for (const auto& r : manager_.readers()) {
+        readers.push_back(r.reader);
+        reader_expected.push_back(std::max(valueAt(config.m_remoteWriterNum, domainIndexOf(r.participant), 1), 1));
+    }
+    if (writers.empty() && readers.empty()) {
+        return true;
+    }
+
+    Logger::getInstance().logAndPrint("TrafficTest: 等待匹配 | Writer: " + std::to_string(writers.size()) +
+        " | Reader: " + std::to_string(readers.size()));
+    MatchTracker& matches = manager_.match_tracker();
+    if (!matches.waitForEndpoints(writers, writer_expected, readers, reader_expected, timeout)) {
+        return false;
+    }
+    Logger::getInstance().logAndPrint(formatTimeToMatch("TrafficTest", matches.lastTimeToMatchMs()));
+    return true;
+}
+
+// ========================
+// 发送线程：每个 Writer 一个，按其端点配置的大小与速率发送
+// ========================
+
+void TrafficTest::senderLoop(size_t writer_index, int round_index) {
+    const ConfigData& profile = writer_profiles_[manager_.writers()[writer_index].topic];
+    runScaleSender(manager_, { writer_index }, profile, profileRound(profile, round_index), source_base_,
+        writer_flows_, "TrafficTest");
+}
+
+// ========================
+// runRound
+// ========================
+
+int TrafficTest::runRound(const ConfigData& config) {
+    const int round_index = config.m_activeLoop;
+    if (manager_.writers().size() != writer_flows_.size() || manager_.readers().size() != reader_flow_count_) {
+        Logger::getInstance().error("TrafficTest: 实体数量与计划不一致，请先调用 prepareRound 再初始化 DDSManager_Scale");
+        return -1;
+    }
+
+    Logger::getInstance().logAndPrint("第 " + std::to_string(round_index + 1) + " 轮混合负载测试 | Participant: " +
+        std::to_string(manager_.participant_count()) + " | Writer: " + std::to_string(manager_.writers().size()) +
+        " | Reader: " + std::to_string(reader_flow_count_));
+    if (!waitForMatch(config, std::chrono::seconds(config.m_matchTimeoutSec))) {
+        Logger::getInstance().logAndPrint("TrafficTest: 等待匹配超时，按已匹配实体继续");
+    }
+
+    auto& resUtil = ResourceUtilization::instance();
+    SysMetrics start_metrics = resUtil.collectCurrentMetrics();
+
+    std::vector<std::thread> senders;
+    senders.reserve(manager_.writers().size());
+    for (size_t i = 0; i < manager_.writers().size(); ++i) {
+        senders.emplace_back(&TrafficTest::senderLoop, this, i, round_index);
+    }
+    for (auto& t : senders) {
+        t.join();
+    }
+
+    if (reader_flow_count_ > 0) {
+        end_tracker_.wait([this] {
+            uint64_t total = 0;
+            for (size_t i = 0; i < reader_flow_count_; ++i) {
+                total += reader_flows_[i].received.load(std::memory_order_relaxed);
+            }
+            return total;
+            }, "TrafficTest");
+    }
+
+    SysMetrics end_metrics = resUtil.collectCurrentMetrics();
+    TestRoundResult round_result{ round_index + 1, start_metrics, end_metrics };
+    report(config, start_metrics, end_metrics, round_result.perf);
+    round_result.perf.time_to_match_ms = manager_.match_tracker().lastTimeToMatchMs();
+    if (result_callback_) {
+        result_callback_(round_result);
+    }
+    return 0;
+}
+
+// ========================
+// 报告：逐实体 + 按端点配置（流）汇总
+// ========================
+
+void TrafficTest::report(const ConfigData& config, const SysMetrics& start_metrics, const SysMetrics& end_metrics, RoundPerformance& perf) {
+    const int round_index = config.m_activeLoop;
+    const auto& writers = manager_.writers();
+    const auto& readers = manager_.readers();
+
+    // --- Writer ---
+    std::vector<uint64_t> flow_sent(writer_profiles_.size(), 0);
+    std::vector<uint64_t> flow_failed(writer_profiles_.size(), 0);
+    std::vector<double> flow_rate(writer_profiles_.size(), 0.0);
+    std::vector<size_t> flow_writers(writer_profiles_.size(), 0);
+    for (size_t i = 0; i < writers.size(); ++i) {
+        const WriterSendStats& w = writer_flows_[i];
+        const size_t flow = static_cast<size_t>(writers[i].topic);
+        flow_sent[flow] += w.sent;
+        flow_failed[flow] += w.failed;
+        flow_rate[flow] += w.seconds > 0 ? w.sent / w.seconds : 0.0;
+        ++flow_writers[flow];
+        if (i < kScaleMaxEntityLines) {
+            Logger::getInstance().logAndPrint("  Writer[" + std::to_string(i) + "] dp=" + std::to_string(writers[i].participant) +
+                " flow=" + std::to_string(flow) + " | 发送: " + std::to_string(w.sent) + " | 失败: " + std::to_string(w.failed) +
+                " | " + w.rate_summary);
+        }
+    }
+    if (writers.size() > kScaleMaxEntityLines) {
+        Logger::getInstance().logAndPrint("  ... 其余 " + std::to_string(writers.size() - kScaleMaxEntityLines) + " 个 Writer 已省略");
+    }
+
+    // --- Reader ---
+    std::vector<std::unique_ptr<LatencyHistogram>> flow_latency(reader_profiles_.size());
+    std::vector<uint64_t> flow_received(reader_profiles_.size(), 0);
+    std::vector<uint64_t> flow_expected(reader_profiles_.size(), 0);
+    std::vector<uint64_t> flow_bytes(reader_profiles_.size(), 0);
+    std::vector<uint64_t> flow_misses(reader_profiles_.size(), 0);
+    std::vector<double> flow_pps(reader_profiles_.size(), 0.0);
+    std::vector<size_t> flow_readers(reader_profiles_.size(), 0);
+    LatencyHistogram all_latency;
+    uint64_t first_ns = UINT64_MAX;
+    uint64_t last_ns = 0;
+    for (size_t i = 0; i < reader_flow_count_; ++i) {
+        const ReaderFlow& r = reader_flows_[i];
+        const size_t flow = static_cast<size_t>(readers[i].topic);
+        const ConfigData& profile = reader_profiles_[flow];
+        const int round = profileRound(profile, round_index);
+        const uint64_t expected = static_cast<uint64_t>(profile.m_sendCount[round]) *
+            static_cast<uint64_t>(std::max(valueAt(config.m_remoteWriterNum, domainIndexOf(readers[i].participant), 1), 1));
+        const uint64_t received = r.received.load();
+        const uint64_t f = r.first_ns.load();
+        const uint64_t l = r.last_ns.load();
+        const double seconds = (received > 1 && l > f) ? (l - f) / 1e9 : 0.0;
+        const double pps = seconds > 0 ? received / seconds : 0.0;
+
+        if (!flow_latency[flow]) {
+            flow_latency[flow] = std::make_unique<LatencyHistogram>();
+        }
+        flow_latency[flow]->merge(r.latency);
+        all_latency.merge(r.latency);
+        if (received > 0) {
+            first_ns = std::min(first_ns, f);
+            last_ns = std::max(last_ns, l);
+        }
+        flow_received[flow] += received;
+        flow_expected[flow] += expected;
+        flow_bytes[flow] += r.bytes.load();
+        flow_misses[flow] += r.deadline_misses.load();
+        flow_pps[flow] += pps;
+        ++flow_readers[flow];
+
+        if (i < kScaleMaxEntityLines) {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(2)
+                << "  Reader[" << i << "] dp=" << readers[i].participant << " flow=" << flow
+                << " | 接收: " << received
+                << " | 丢失: " << (expected > received ? expected - received : 0)
+                << " | 吞吐: " << pps << " pps"
+                << " | 时延: " << r.latency.percentileSummary();
+            if (r.deadline_ns > 0) {
+                oss << " | 超期: " << r.deadline_misses.load() << " (最大间隔 " << r.max_gap_ns.load() / 1000.0 << " us)";
+            }
+            if (!end_tracker_.ended(i)) {
+                oss << " | 结束包: " << end_tracker_.endedWriters(i) << "/" << end_tracker_.expectedWriters(i);
+            }
+            Logger::getInstance().logAndPrint(oss.str());
+        }
+    }
+    if (reader_flow_count_ > kScaleMaxEntityLines) {
+        Logger::getInstance().logAndPrint("  ... 其余 " + std::to_string(reader_flow_count_ - kScaleMaxEntityLines) + " 个 Reader 已省略");
+    }
+
+    // --- 按流汇总 ---
+    for (size_t flow = 0; flow < writer_profiles_.size(); ++flow) {
+        if (flow_writers[flow] == 0) continue;
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2)
+            << "发送流[" << flow << "] " << writer_profiles_[flow].name
+            << " | Topic: " << topicOf(writer_profiles_[flow])
+            << " | Writer: " << flow_writers[flow]
+            << " | 发送: " << flow_sent[flow] << " (失败 " << flow_failed[flow] << ")"
+            << " | 发送速率: " << flow_rate[flow] << " msg/s";
+        Logger::getInstance().logAndPrint(oss.str());
+    }
+    for (size_t flow = 0; flow < reader_profiles_.size(); ++flow) {
+        if (flow_readers[flow] == 0) continue;
+        const uint64_t expected = flow_expected[flow];
+        const uint64_t received = flow_received[flow];
+        const double mbps = flow_pps[flow] > 0 && received > 0
+            ? flow_pps[flow] * (static_cast<double>(flow_bytes[flow]) / received) * 8.0 / (1024.0 * 1024.0) : 0.0;
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2)
+            << "接收流[" << flow << "] " << reader_profiles_[flow].name
+            << " | Topic: " << topicOf(reader_profiles_[flow])
+            << " | Reader: " << flow_readers[flow]
+            << " | 接收: " << received
+            << " | 丢包率: " << (expected > received ? (expected - received) * 100.0 / expected : 0.0) << "%"
+            << " | 吞吐: " << flow_pps[flow] << " pps"
+            << " | 带宽: " << mbps << " Mbps"
+            << " | 单向时延: " << flow_latency[flow]->percentileSummary();
+        if (reader_profiles_[flow].m_checkDeadLine > 0) {
+            oss << " | 超期(" << reader_profiles_[flow].m_checkDeadLine << " us): " << flow_misses[flow];
+        }
+        Logger::getInstance().logAndPrint(oss.str());
+    }
+
+    // --- 结果文件：全部流合计（接收端口径；无 Reader 时按发送端口径）---
+    uint64_t total_sent = 0;
+    for (uint64_t n : flow_sent) total_sent += n;
+    uint64_t total_received = 0;
+    uint64_t total_expected = 0;
+    uint64_t total_bytes = 0;
+    for (size_t flow = 0; flow < reader_profiles_.size(); ++flow) {
+        total_received += flow_received[flow];
+        total_expected += flow_expected[flow];
+        total_bytes += flow_bytes[flow];
+    }
+    perf.role = "traffic";
+    perf.sent = total_sent;
+    if (reader_flow_count_ > 0) {
+        const double recv_seconds = (last_ns > first_ns && first_ns != UINT64_MAX) ? (last_ns - first_ns) / 1e9 : 0.0;
+        perf.payload_bytes = total_received > 0 ? static_cast<int>(total_bytes / total_received) : 0;
+        perf.received = total_received;
+        perf.lost = total_expected > total_received ? total_expected - total_received : 0;
+        perf.loss_rate_percent = total_expected > 0 ? perf.lost * 100.0 / total_expected : 0.0;
+        perf.duration_ms = recv_seconds * 1000.0;
+        if (recv_seconds > 0) {
+            perf.msgs_per_sec = total_received / recv_seconds;
+            perf.mb_per_sec = total_bytes / recv_seconds / (1024.0 * 1024.0);
+        }
+        perf.latency_count = all_latency.count();
+        perf.latency_min_us = all_latency.minValue() / 1000.0;
+        perf.latency_mean_us = all_latency.mean() / 1000.0;
+        perf.latency_p50_us = all_latency.valueAtPercentile(50.0) / 1000.0;
+        perf.latency_p90_us = all_latency.valueAtPercentile(90.0) / 1000.0;
+        perf.latency_p99_us = all_latency.valueAtPercentile(99.0) / 1000.0;
+        perf.latency_p999_us = all_latency.valueAtPercentile(99.9) / 1000.0;
+        perf.latency_max_us = all_latency.maxValue() / 1000.0;
+    }
+    else {
+        double total_rate = 0.0;
+        for (double rate : flow_rate) total_rate += rate;
+        perf.msgs_per_sec = total_rate;
+    }
+
+    std::ostringstream res;
+    res << std::fixed << std::setprecision(2)
+        << "混合负载资源 | CPU 峰值: " << end_metrics.cpu_usage_percent_peak << "%"
+        << " | 工作集: " << end_metrics.system_working_set_kb << " KB"
+        << " (峰值 " << end_metrics.system_peak_working_set_kb << " KB)"
+        << " | 内存池: " << end_metrics.memory_current_kb << " KB"
+        << " | 测试期间工作集变化: " << (static_cast<long long>(end_metrics.system_working_set_kb) -
+            static_cast<long long>(start_metrics.system_working_set_kb)) << " KB";
+    Logger::getInstance().logAndPrint(res.str());
+}
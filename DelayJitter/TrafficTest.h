@@ -0,0 +1,95 @@
+﻿// TrafficTest.h
+#pragma once
+
+#include "DDSManager_Scale.h"
+#include "LatencyHistogram.h"
+#include "ScaleRound.h"
+#include "SysMetrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Config;
+struct TestRoundResult;
+struct RoundPerformance;
+
+/**
+ * @brief traffic:: 混合负载测试：在单进程内按配置搭建多 Domain 拓扑，每个端点按各自的端点配置收发。
+ *
+ * 拓扑：m_domainIds 中第 k 个 Domain 创建 m_dpNum[k] 个 Participant（QoS 取 m_dpQosNames[k]），
+ * 每个 Participant 创建 m_writerNum[k] 个 Writer、m_readerNum[k] 个 Reader；第 i 个 Writer / Reader
+ * 使用 m_writerConfigs / m_readerConfigs 中第 i % size 个端点配置（Topic、QoS、包大小、数量、速率）。
+ * 按 Domain 对齐的数组不足时沿用最后一个。
+ *
+ * 每个 Writer 一个发送线程，按端点配置的 RateController 独立限速；包头携带发送时刻（steady_clock），
+ * Reader 据此统计单向时延（同机跨进程同样有效）。m_checkDeadLine 非 0 时统计到达间隔超限次数。
+ * 结果按端点配置（流）汇总吞吐、丢包与时延分布。
+ */
+class TrafficTest {
+public:
+    using ResultCallback = std::function<void(const TestRoundResult&)>;
+
+    explicit TrafficTest(DDSManager_Scale& manager, ResultCallback callback = nullptr);
+    ~TrafficTest();
+
+    TrafficTest(const TrafficTest&) = delete;
+    TrafficTest& operator=(const TrafficTest&) = delete;
+
+    /**
+     * @brief 解析 m_writerConfigs / m_readerConfigs 引用的端点配置（首轮前调用一次）
+     * @return 有端点配置缺失时返回 false
+     */
+    bool loadProfiles(const Config& config, const ConfigData& traffic_config);
+
+    /**
+     * @brief 在 DDSManager_Scale::initialize() 之前调用，返回本轮实体计划
+     */
+    EntityPlan prepareRound(const ConfigData& config);
+
+    /**
+     * @brief 运行单轮混合负载测试
+     * @return 0 成功，非0 失败
+     */
+    int runRound(const ConfigData& config);
+
+    void onDataReceived(size_t reader_index, const DDS::Bytes& sample, const DDS::SampleInfo& info);
+    void onEndOfRound(size_t reader_index, uint32_t source);
+
+private:
+    struct ReaderFlow {
+        std::atomic<uint64_t> received{ 0 };
+        std::atomic<uint64_t> bytes{ 0 };
+        std::atomic<uint64_t> first_ns{ 0 };
+        std::atomic<uint64_t> last_ns{ 0 };
+        std::atomic<uint64_t> deadline_misses{ 0 };
+        std::atomic<uint64_t> max_gap_ns{ 0 };
+        LatencyHistogram latency;
+        uint64_t deadline_ns = 0;
+        uint64_t print_gap = 0;
+    };
+
+    int profileRound(const ConfigData& profile, int round_index) const;
+    int domainIndexOf(int participant_index) const;
+    bool waitForMatch(const ConfigData& config, const std::chrono::seconds& timeout);
+    void senderLoop(size_t writer_index, int round_index);
+    // 输出逐实体与按流汇总结果，并把全部流的合计写入 perf（结果文件的一行）
+    void report(const ConfigData& config, const SysMetrics& start_metrics, const SysMetrics& end_metrics, RoundPerformance& perf);
+
+    DDSManager_Scale& manager_;
+    ResultCallback result_callback_;
+
+    std::vector<ConfigData> writer_profiles_;
+    std::vector<ConfigData> reader_profiles_;
+
+    std::vector<int> participant_domain_index_;      // Participant 序号 -> m_domainIds 下标
+    std::unique_ptr<ReaderFlow[]> reader_flows_;
+    size_t reader_flow_count_ = 0;
+    std::vector<WriterSendStats> writer_flows_;       // 每个元素只由对应的发送线程写入
+    uint32_t source_base_ = 0;                        // 本轮 Writer 标识起点（随机），Writer i 的标识为 source_base_ + i
+    EndOfRoundTracker end_tracker_;                   // 每个 Reader 收齐 m_remoteWriterNum 个 Writer 的结束包才算结束
+};
@@ -7,6 +7,10 @@ GloMemPool::Stats GloMemPool::s_stats;
 std::unordered_map<void*, size_t> GloMemPool::s_alloc_map;
 #endif
 
+namespace {
+    thread_local size_t t_alloc_count = 0;
+}
+
 bool GloMemPool::initialize() {
     ZRInitialGlobalMemPool();
     s_pool = nullptr;// 默认全局池（可选）
@@ -28,6 +32,7 @@ void* GloMemPool::allocate(size_t size, const char* file, int line) {
 #endif
 
     if (ptr) {
+        ++t_alloc_count;
         s_stats.total_allocated += size;
         s_stats.alloc_count++;
         s_stats.current_blocks++;
@@ -70,6 +75,10 @@ GloMemPool::Stats GloMemPool::getStats() {
     return s_stats;
 }
 
+size_t GloMemPool::getThreadAllocCount() {
+    return t_alloc_count;
+}
+
 bool GloMemPool::hasPotentialLeak() {
     return s_stats.alloc_count > s_stats.dealloc_count;
 }
@@ -43,6 +43,9 @@ public:
 
     static Stats getStats();
 
+    // 当前线程累计的 allocate 次数（无锁，用于断言热路径零分配）
+    static size_t getThreadAllocCount();
+
     static bool hasPotentialLeak();
     static size_t getOutstandingAllocations();
     static size_t getCurrentBlocks();
@@ -5,32 +5,98 @@
 #include <string>
 #include <filesystem>
 #include <mutex>
-#include <queue>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <thread>
-#include <condition_variable>
 #include <atomic>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
 #include <ctime>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 
 // Logger 的内部实现类
+//
+// 日志路径上的线程（DDS 监听、发送循环）只做一次定长拷贝：
+// 消息写入预分配的多生产者单消费者环（每槽一个定长二进制记录 + 槽序号），
+// 时间戳只取原始时钟值，格式化、控制台输出与落盘都由后台线程批量完成。
+// 环满时直接丢弃并计数，生产者永不阻塞。
+// 关闭时后台线程封住 tail_ 并写完所有已占用的槽；close 之后无法入环的 logAndPrint / error 改为同步输出。
 class Logger::Impl {
 public:
+    // 记录类型，决定后台线程输出时的前缀
+    enum class RecordKind : uint8_t {
+        Raw,        // 原样输出（日志头）
+        Log,        // "[LOG] 时间 消息"
+        Trace,      // "[TRACE] 时间 消息"
+        Debug,      // "[DEBUG] 时间 消息"
+        Info,       // "[INFO] 时间 消息"
+        Warn,       // "[WARN] 时间 消息"
+        Error,      // "[ERROR] 时间 消息"
+        Config,     // "\n=== 测试配置 ===\n消息"
+        Result      // "\n=== 测试结果 ===\n消息"
+    };
+
+    static constexpr size_t kRingCapacity = 8192;           // 槽数（2 的幂）
+    static constexpr size_t kInlineTextSize = 224;          // 槽内联文本长度，超长消息转存堆上
+    static constexpr size_t kMaxBatch = 256;                // 后台线程单批最多处理的记录数
+    static constexpr auto kIdleSleep = std::chrono::milliseconds(1);
+
+    struct Record {
+        RecordKind kind;
+        bool print;                  // 是否同时输出到控制台
+        uint16_t length;             // 内联文本长度
+        int64_t wall_ticks;          // system_clock 原始计数，后台线程再格式化
+        std::string* overflow;       // 超长消息（非空时忽略内联文本）
+        char text[kInlineTextSize];
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq{ 0 };
+        Record rec;
+    };
+
     std::ofstream file_;                             // 日志文件流
     std::string log_directory_;                      // 日志目录
     std::string log_file_prefix_ = "log_";          // 日志文件名前缀
     std::string log_file_suffix_ = ".log";          // 日志文件名后缀
-    bool isInitialized_ = false;                     // 是否已初始化
+    std::atomic<bool> isInitialized_{ false };       // 是否已初始化
     mutable std::atomic<int> file_counter_{ 0 };    // 用于生成唯一文件名的原子计数器
 
-    // 日志队列，用于异步写入
-    std::queue<std::string> log_queue_;
-    std::mutex queue_mutex_;                        // 保护日志队列的互斥锁
-    std::condition_variable cv_;                    // 条件变量，用于通知写入线程
+    // 日志环：tail_ 由生产者 CAS 推进，head_ 仅后台线程访问
+    // 停止时后台线程在 tail_ 上置 kClosedBit，此后生产者的 CAS 必然失败
+    static constexpr uint64_t kClosedBit = uint64_t(1) << 63;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> tail_{ 0 };
+    alignas(64) uint64_t head_ = 0;
+    std::atomic<uint64_t> dropped_{ 0 };            // 环满丢弃的记录数
+    uint64_t dropped_reported_ = 0;                 // 已写入日志的丢弃数（仅后台线程）
+
     std::atomic<bool> stop_{ false };               // 停止标志
     std::thread writer_thread_;                     // 后台写入线程
 
+    // 运行期级别：configureLevels 每次构造一张新表再整体发布，任意线程只读已发布的不可变表。
+    // suite 模式每个配置都会重新设置，此时 DDS 与日志线程仍在运行；
+    // 旧表保留到进程结束（每个配置最多一张），读者无需加锁或引用计数
+    static constexpr size_t kMaxModuleLevels = 32;
+    struct ModuleLevel {
+        std::string module;
+        int level;
+    };
+    struct LevelTable {
+        int global_level = static_cast<int>(LogLevel::Info);
+        size_t count = 0;
+        ModuleLevel modules[kMaxModuleLevels];
+    };
+    std::atomic<const LevelTable*> level_table_{ nullptr };     // nullptr 表示全局 Info、无模块覆盖
+    std::mutex level_mtx_;                                       // 保护 level_tables_
+    std::vector<std::unique_ptr<LevelTable>> level_tables_;     // 已发布的全部级别表
+
     // 结构体，用于处理和格式化时间戳
     struct LogTimestamp {
         int year, month, day, hour, minute, second, millisecond;
@@ -75,9 +141,9 @@ public:
         }
     };
 
-    // 获取当前时间戳
-    LogTimestamp getLogTimestamp() const {
-        auto now = std::chrono::system_clock::now();
+    // 获取时间戳（默认为当前时刻）
+    LogTimestamp getLogTimestamp(
+        std::chrono::system_clock::time_point now = std::chrono::system_clock::now()) const {
         auto ms = std::chrono::time_point_cast<std::chrono::milliseconds>(now);
         auto time_t = std::chrono::system_clock::to_time_t(now);
 
@@ -121,49 +187,176 @@ public:
         return (std::filesystem::path(log_directory_) / oss.str()).string();
     }
 
+    // 入环：成功返回 true；环满时丢弃并计数，不阻塞（配置 / 结果记录除外）；环已封住时返回 false
+    bool pushRecord(RecordKind kind, bool print, const std::string& message) {
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            if (pos & kClosedBit) return false;
+            slot = &slots_[pos & (kRingCapacity - 1)];
+            const uint64_t seq = slot->seq.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                // 配置与结果只在主线程的轮次边界写入，不能丢，等待后台线程腾出槽位
+                if (kind == RecordKind::Config || kind == RecordKind::Result) {
+                    std::this_thread::yield();
+                    pos = tail_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        Record& rec = slot->rec;
+        rec.kind = kind;
+        rec.print = print;
+        rec.wall_ticks = std::chrono::system_clock::now().time_since_epoch().count();
+        if (message.size() <= kInlineTextSize) {
+            std::memcpy(rec.text, message.data(), message.size());
+            rec.length = static_cast<uint16_t>(message.size());
+            rec.overflow = nullptr;
+        }
+        else {
+            // 配置、结果等长文本不在热路径上，允许一次堆分配
+            rec.length = 0;
+            rec.overflow = new std::string(message);
+        }
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 把一条记录格式化追加到文件 / 控制台批缓冲
+    void formatRecord(const Record& rec, std::string& fileBatch, std::string& consoleBatch) const {
+        const char* text = rec.overflow ? rec.overflow->data() : rec.text;
+        const size_t length = rec.overflow ? rec.overflow->size() : rec.length;
+
+        switch (rec.kind) {
+        case RecordKind::Raw:
+            break;
+        case RecordKind::Log:
+            fileBatch += "[LOG] ";
+            break;
+        case RecordKind::Trace:
+            fileBatch += "[TRACE] ";
+            break;
+        case RecordKind::Debug:
+            fileBatch += "[DEBUG] ";
+            break;
+        case RecordKind::Info:
+            fileBatch += "[INFO] ";
+            break;
+        case RecordKind::Warn:
+            fileBatch += "[WARN] ";
+            break;
+        case RecordKind::Error:
+            fileBatch += "[ERROR] ";
+            break;
+        case RecordKind::Config:
+            fileBatch += "\n=== 测试配置 ===\n";
+            break;
+        case RecordKind::Result:
+            fileBatch += "\n=== 测试结果 ===\n";
+            break;
+        }
+        if (rec.kind != RecordKind::Raw && rec.kind != RecordKind::Config && rec.kind != RecordKind::Result) {
+            const std::chrono::system_clock::time_point tp{
+                std::chrono::system_clock::duration(rec.wall_ticks) };
+            fileBatch += getLogTimestamp(tp).formatTimeWithMs();
+            fileBatch += ' ';
+        }
+        fileBatch.append(text, length);
+        fileBatch += '\n';
+
+        if (rec.print) {
+            consoleBatch.append(text, length);
+            consoleBatch += '\n';
+        }
+    }
+
+    // 取出至多 kMaxBatch 条记录并批量输出，返回处理的条数
+    size_t drainBatch(std::string& fileBatch, std::string& consoleBatch) {
+        size_t count = 0;
+        while (count < kMaxBatch) {
+            Slot& slot = slots_[head_ & (kRingCapacity - 1)];
+            if (slot.seq.load(std::memory_order_acquire) != head_ + 1) break;
+
+            formatRecord(slot.rec, fileBatch, consoleBatch);
+            delete slot.rec.overflow;
+            slot.rec.overflow = nullptr;
+            slot.seq.store(head_ + kRingCapacity, std::memory_order_release);
+            ++head_;
+            ++count;
+        }
+
+        const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != dropped_reported_) {
+            fileBatch += "[LOG] " + getCurrentTimeStr() + " [Logger] 日志环已满，累计丢弃 " +
+                std::to_string(dropped) + " 条\n";
+            dropped_reported_ = dropped;
+        }
+
+        if (!consoleBatch.empty()) {
+            std::cout.write(consoleBatch.data(), static_cast<std::streamsize>(consoleBatch.size()));
+            std::cout.flush();
+            consoleBatch.clear();
+        }
+        if (!fileBatch.empty()) {
+            if (file_.is_open()) {
+                file_.write(fileBatch.data(), static_cast<std::streamsize>(fileBatch.size()));
+                file_.flush(); // 每批刷新一次，而不是每行
+            }
+            fileBatch.clear();
+        }
+        return count;
+    }
+
     // 后台写入线程函数
     void backgroundWrite() {
-        while (true) {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            // 等待队列非空或收到停止信号
-            cv_.wait(lock, [this] { return !log_queue_.empty() || stop_.load(); });
-
-            // 如果收到停止信号且队列为空，则退出循环
-            if (stop_.load() && log_queue_.empty()) {
-                break;
+#ifndef _WIN32
+        // 命名写入线程，便于 ResourceUtilization 按线程归因 CPU
+        pthread_setname_np(pthread_self(), "zrdds_logger");
+#endif
+        std::string fileBatch;
+        std::string consoleBatch;
+        fileBatch.reserve(64 * 1024);
+        consoleBatch.reserve(16 * 1024);
+
+        // 生产者从不通知，空闲时短暂休眠
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (drainBatch(fileBatch, consoleBatch) == 0) {
+                std::this_thread::sleep_for(kIdleSleep);
             }
+        }
 
-            // 取出队列头部的日志行
-            std::string logLine = std::move(log_queue_.front());
-            log_queue_.pop();
-            lock.unlock(); // 释放锁，以便其他线程可以继续入队
-
-            // 写入文件
-            if (isInitialized_ && file_.is_open()) {
-                file_ << logLine << '\n';
-                file_.flush(); // 确保立即写入磁盘
+        // 停止后封住 tail_：之后不再有新槽被占用；已占用但尚未发布的槽（生产者正在拷贝）
+        // 必须等到发布后写出，否则记录丢失且超长消息泄漏
+        const uint64_t end = tail_.fetch_or(kClosedBit, std::memory_order_acq_rel) & ~kClosedBit;
+        while (head_ != end) {
+            if (drainBatch(fileBatch, consoleBatch) == 0) {
+                std::this_thread::yield();
             }
         }
 
         // 线程退出前，写入结束标记并关闭文件
         if (isInitialized_ && file_.is_open()) {
             file_ << "[" << getCurrentTimeStr() << "] === ZRDDS-Perf-Bench Log Finished ===\n";
+            const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (dropped > 0) {
+                file_ << "[Logger] 日志环满共丢弃 " << dropped << " 条记录\n";
+            }
             file_.flush();
             file_.close();
             isInitialized_ = false;
         }
     }
 
-    // 将日志行加入队列
-    void pushLog(const std::string& logLine) {
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            if (stop_.load()) return; // 如果已停止，则不入队
-            log_queue_.push(logLine);
-        }
-        cv_.notify_one(); // 通知后台线程有新日志
-    }
-
     // 初始化日志系统
     bool initialize(
         const std::string& logDirectory,
@@ -198,7 +391,7 @@ public:
         std::string header = "[" + getCurrentTimeStr() + "] === ZRDDS-Perf-Bench Log Started ===\n"
             "Log File: " + logFileName + "\n"
             "----------------------------------------";
-        pushLog(header);
+        pushRecord(RecordKind::Raw, false, header);
 
         isInitialized_ = true;
         std::cout << "[Logger] 日志系统已启动\n";
@@ -206,14 +399,22 @@ public:
         return true;
     }
 
-    // 关闭日志系统
+    // 关闭日志系统：后台线程写完剩余记录后退出
     void close() {
-        if (stop_.exchange(true)) return; // 原子地设置停止标志，如果已停止则直接返回
-        cv_.notify_all(); // 唤醒所有等待的线程（主要是后台写入线程）
+        stop_.store(true, std::memory_order_release);
+    }
+
+    // close 之后入环失败（已封住或收尾时环满）的需输出消息改为调用方同步写控制台
+    bool closed() const {
+        return stop_.load(std::memory_order_acquire);
     }
 
-    // 构造函数：启动后台写入线程
-    Impl() {
+    // 构造函数：预分配日志环并启动后台写入线程
+    Impl() : slots_(new Slot[kRingCapacity]) {
+        for (size_t i = 0; i < kRingCapacity; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+            slots_[i].rec.overflow = nullptr;
+        }
         writer_thread_ = std::thread(&Impl::backgroundWrite, this);
     }
 
@@ -262,36 +463,34 @@ void Logger::setupLogger(const std::string& logDirectory,
 // 公共接口：记录普通日志
 void Logger::log(const std::string& msg) {
     if (pImpl_->isInitialized_) {
-        std::string line = "[LOG] " + pImpl_->getCurrentTimeStr() + " " + msg;
-        pImpl_->pushLog(line);
+        pImpl_->pushRecord(Impl::RecordKind::Log, false, msg);
     }
 }
 
 // 公共接口：记录 Info 日志
 void Logger::info(const std::string& msg) {
     if (pImpl_->isInitialized_) {
-        std::string line = "[INFO] " + pImpl_->getCurrentTimeStr() + " " + msg;
-        pImpl_->pushLog(line);
+        pImpl_->pushRecord(Impl::RecordKind::Info, false, msg);
     }
 }
 
 // 公共接口：记录 Error 日志
 void Logger::error(const std::string& msg) {
-    std::string line = "[ERROR] " + pImpl_->getCurrentTimeStr() + " " + msg;
     if (!pImpl_->isInitialized_) {
         // 如果日志未初始化，至少打印到标准错误
-        std::cerr << line << " [Warning] (日志未启用)\n";
+        std::cerr << "[ERROR] " << pImpl_->getCurrentTimeStr() << " " << msg << " [Warning] (日志未启用)\n";
         return;
     }
-    pImpl_->pushLog(line);
+    if (!pImpl_->pushRecord(Impl::RecordKind::Error, false, msg) && pImpl_->closed()) {
+        // 日志已关闭：错误不能悄悄丢弃
+        std::cerr << "[ERROR] " << pImpl_->getCurrentTimeStr() << " " << msg << " [Warning] (日志已关闭)\n";
+    }
 }
 
 // 公共接口：记录配置信息
 void Logger::logConfig(const std::string& configInfo) {
-    std::ostringstream oss;
-    oss << "\n=== 测试配置 ===\n" << configInfo;
     if (pImpl_->isInitialized_) {
-        pImpl_->pushLog(oss.str());
+        pImpl_->pushRecord(Impl::RecordKind::Config, false, configInfo);
     }
     else {
         std::cerr << "[WARNING] 尝试写入配置日志，但日志未初始化\n" << configInfo << std::endl;
@@ -300,26 +499,135 @@ void Logger::logConfig(const std::string& configInfo) {
 
 // 公共接口：记录结果信息
 void Logger::logResult(const std::string& result) {
-    std::ostringstream oss;
-    oss << "\n=== 测试结果 ===\n" << result;
     if (pImpl_->isInitialized_) {
-        pImpl_->pushLog(oss.str());
+        pImpl_->pushRecord(Impl::RecordKind::Result, false, result);
     }
     else {
         std::cerr << "[WARNING] 尝试写入结果日志，但日志未初始化\n" << result << std::endl;
     }
 }
 
-// 公共接口：记录并打印
+// 公共接口：记录并打印（控制台输出同样由后台线程完成，调用方不做同步 IO）
 void Logger::logAndPrint(const std::string& msg) {
-    std::cout << msg << std::endl; // 先打印到控制台
     if (pImpl_->isInitialized_) {
-        std::string line = "[LOG] " + pImpl_->getCurrentTimeStr() + " " + msg;
-        pImpl_->pushLog(line); // 再加入日志队列
+        if (pImpl_->pushRecord(Impl::RecordKind::Log, true, msg) || !pImpl_->closed()) return;
     }
+    std::cout << msg << std::endl; // 日志未启用或已关闭（后台线程可能已退出）时直接打印
+}
+
+// 解析级别名（不区分大小写），失败返回 -1
+static int parse_log_level(std::string name) {
+    std::transform(name.begin(), name.end(), name.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (name == "trace") return static_cast<int>(LogLevel::Trace);
+    if (name == "debug") return static_cast<int>(LogLevel::Debug);
+    if (name == "info") return static_cast<int>(LogLevel::Info);
+    if (name == "warn" || name == "warning") return static_cast<int>(LogLevel::Warn);
+    if (name == "error") return static_cast<int>(LogLevel::Error);
+    if (name == "off") return static_cast<int>(LogLevel::Off);
+    return -1;
+}
+
+static std::string trim_copy(const std::string& s) {
+    const size_t b = s.find_first_not_of(" \t");
+    if (b == std::string::npos) return std::string();
+    const size_t e = s.find_last_not_of(" \t");
+    return s.substr(b, e - b + 1);
+}
+
+// 公共接口：设置运行期级别与模块覆盖
+bool Logger::configureLevels(const std::string& spec) {
+    bool ok = true;
+    auto table = std::make_unique<Impl::LevelTable>();
+
+    std::istringstream iss(spec);
+    std::string token;
+    while (std::getline(iss, token, ';')) {
+        token = trim_copy(token);
+        if (token.empty()) continue;
+
+        const size_t colon = token.find(':');
+        if (colon == std::string::npos) {
+            const int level = parse_log_level(token);
+            if (level < 0) { ok = false; continue; }
+            table->global_level = level;
+            continue;
+        }
+
+        const std::string module = trim_copy(token.substr(0, colon));
+        const int level = parse_log_level(trim_copy(token.substr(colon + 1)));
+        if (module.empty() || level < 0 || table->count >= Impl::kMaxModuleLevels) { ok = false; continue; }
+        table->modules[table->count].module = module;
+        table->modules[table->count].level = level;
+        ++table->count;
+    }
+
+    int min_level = table->global_level;
+    for (size_t i = 0; i < table->count; ++i) {
+        min_level = std::min(min_level, table->modules[i].level);
+    }
+    {
+        std::lock_guard<std::mutex> lock(pImpl_->level_mtx_);
+        pImpl_->level_table_.store(table.get(), std::memory_order_release);
+        pImpl_->level_tables_.push_back(std::move(table));
+    }
+    // 快速路径与表之间短暂不一致只影响切换瞬间的个别日志，不影响读取安全
+    min_level_.store(min_level, std::memory_order_relaxed);
+
+    if (!ok) {
+        error("[Logger] 日志级别配置无法完全解析: " + spec);
+    }
+    return ok;
+}
+
+bool Logger::isEnabledSlow(LogLevel level, const char* module) const {
+    const int lv = static_cast<int>(level);
+    const Impl::LevelTable* table = pImpl_->level_table_.load(std::memory_order_acquire);
+    if (!table) {
+        return lv >= static_cast<int>(LogLevel::Info);
+    }
+    if (module) {
+        for (size_t i = 0; i < table->count; ++i) {
+            if (table->modules[i].module == module) {
+                return lv >= table->modules[i].level;
+            }
+        }
+    }
+    return lv >= table->global_level;
+}
+
+// 公共接口：带级别写入（级别判断已由调用方完成）
+void Logger::write(LogLevel level, const std::string& message) {
+    if (!pImpl_->isInitialized_) {
+        std::cout << message << std::endl;
+        return;
+    }
+    Impl::RecordKind kind = Impl::RecordKind::Info;
+    switch (level) {
+    case LogLevel::Trace: kind = Impl::RecordKind::Trace; break;
+    case LogLevel::Debug: kind = Impl::RecordKind::Debug; break;
+    case LogLevel::Warn:  kind = Impl::RecordKind::Warn; break;
+    case LogLevel::Error: kind = Impl::RecordKind::Error; break;
+    default: break;
+    }
+    if (!pImpl_->pushRecord(kind, true, message) && pImpl_->closed()) {
+        std::cout << message << std::endl; // 日志已关闭：同步打印
+    }
+}
+
+// 公共接口：日志环满丢弃的记录数
+uint64_t Logger::droppedCount() const {
+    return pImpl_->dropped_.load(std::memory_order_relaxed);
 }
 
 // 公共接口：关闭日志
 void Logger::close() {
     pImpl_->close(); // 调用 Impl 的 close 方法
+}
+
+std::thread::native_handle_type Logger::writerThreadHandle() {
+    if (!pImpl_->writer_thread_.joinable()) {
+        return std::thread::native_handle_type{};
+    }
+    return pImpl_->writer_thread_.native_handle();
 }
\ No newline at end of file
@@ -1,9 +1,32 @@
 // Logger.h
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <sstream>
 #include <thread>
 
+// 日志级别（数值越大越重要）
+enum class LogLevel : int {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+    Off = 5
+};
+
+// 编译期最低级别：低于该级别的 ZR_LOG_* 整句展开为空，参数不会求值。
+// 基准构建（定义 NDEBUG）默认只保留 Info 及以上，可在工程中定义 ZRDDS_LOG_COMPILE_LEVEL 覆盖
+#ifndef ZRDDS_LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define ZRDDS_LOG_COMPILE_LEVEL 2
+#else
+#define ZRDDS_LOG_COMPILE_LEVEL 0
+#endif
+#endif
+
 // 日志记录器类 (单例模式)
 class Logger {
 public:
@@ -37,7 +60,7 @@ public:
     void logConfig(const std::string& configInfo);
     // 记录结果信息
     void logResult(const std::string& result);
-    // 记录日志信息并同时打印到控制台
+    // 记录日志信息并同时打印到控制台（控制台输出由后台线程完成）
     void logAndPrint(const std::string& message);
     // 记录 Info 级别信息
     void info(const std::string& msg);
@@ -45,6 +68,21 @@ public:
     void error(const std::string& msg);
     // 关闭日志系统
     void close();
+    // 日志环已满而被丢弃的记录数（记录路径从不阻塞）
+    uint64_t droppedCount() const;
+    // 设置运行期级别，格式 "info" 或 "info;ResourceUtilization:debug;DDSManager_ZeroCopyBytes:trace"
+    // 第一项为全局级别，其余为按模块覆盖；可在其他线程记录日志时调用（整表替换）。无法解析时返回 false
+    bool configureLevels(const std::string& spec);
+    // 判断某模块的某级别是否开启；低于所有已配置级别时只需一次原子读
+    bool isEnabled(LogLevel level, const char* module) const {
+        if (static_cast<int>(level) < min_level_.load(std::memory_order_relaxed)) return false;
+        return isEnabledSlow(level, module);
+    }
+    // 写入一条带级别的日志（由 ZR_LOG_* 宏在级别开启后调用），同时打印到控制台
+    void write(LogLevel level, const std::string& message);
+
+    // 后台写入线程句柄（供 RealtimeProfile 绑核），未初始化时为默认值
+    std::thread::native_handle_type writerThreadHandle();
 
 private:
     // 私有构造函数和析构函数，防止外部实例化
@@ -55,4 +93,48 @@ private:
     // 将具体实现细节隐藏在 Impl 类中
     class Impl;
     std::unique_ptr<Impl> pImpl_;
-};
\ No newline at end of file
+
+    // 全局与各模块级别中的最小值，isEnabled 的快速路径
+    std::atomic<int> min_level_{ static_cast<int>(LogLevel::Info) };
+    bool isEnabledSlow(LogLevel level, const char* module) const;
+};
+
+// 带级别的日志宏：expr 为流式表达式，仅在级别开启时才格式化，例如
+//   ZR_LOG_DEBUG("ResourceUtilization", "峰值 CPU: " << peak << "%");
+#define ZR_LOG_AT(level, module, expr) \
+    do { \
+        Logger& zr_logger_ = Logger::getInstance(); \
+        if (zr_logger_.isEnabled(level, module)) { \
+            std::ostringstream zr_log_oss_; \
+            zr_log_oss_ << expr; \
+            zr_logger_.write(level, zr_log_oss_.str()); \
+        } \
+    } while (0)
+
+#define ZR_LOG_DISABLED(module, expr) do {} while (0)
+
+#if ZRDDS_LOG_COMPILE_LEVEL <= 0
+#define ZR_LOG_TRACE(module, expr) ZR_LOG_AT(LogLevel::Trace, module, expr)
+#else
+#define ZR_LOG_TRACE(module, expr) ZR_LOG_DISABLED(module, expr)
+#endif
+
+#if ZRDDS_LOG_COMPILE_LEVEL <= 1
+#define ZR_LOG_DEBUG(module, expr) ZR_LOG_AT(LogLevel::Debug, module, expr)
+#else
+#define ZR_LOG_DEBUG(module, expr) ZR_LOG_DISABLED(module, expr)
+#endif
+
+#if ZRDDS_LOG_COMPILE_LEVEL <= 2
+#define ZR_LOG_INFO(module, expr) ZR_LOG_AT(LogLevel::Info, module, expr)
+#else
+#define ZR_LOG_INFO(module, expr) ZR_LOG_DISABLED(module, expr)
+#endif
+
+#if ZRDDS_LOG_COMPILE_LEVEL <= 3
+#define ZR_LOG_WARN(module, expr) ZR_LOG_AT(LogLevel::Warn, module, expr)
+#else
+#define ZR_LOG_WARN(module, expr) ZR_LOG_DISABLED(module, expr)
+#endif
+
+#define ZR_LOG_ERROR(module, expr) ZR_LOG_AT(LogLevel::Error, module, expr)
\ No newline at end of file
@@ -20,9 +20,16 @@
 #include "Throughput_Bytes.h"
 #include "Throughput_ZeroCopyBytes.h"  
 #include "LatencyTest_Bytes.h"
+#include "LatencyTest_ZeroCopyBytes.h"
+#include "DDSManager_Scale.h"
+#include "ScaleTest.h"
+#include "TrafficTest.h"
 #include "MetricsReport.h"
+#include "ResultWriter.h"
+#include "BaselineStore.h"
 #include "TestRoundResult.h"
 #include "ResourceUtilization.h"
+#include "RealtimeProfile.h"
 
 namespace {
     std::string json_file_path = GlobalConfig::DEFAULT_JSON_CONFIG_PATH;
@@ -32,306 +39,693 @@ namespace {
     std::string logSuffix = GlobalConfig::LOG_FILE_SUFFIX;
     std::string resultDir = GlobalConfig::DEFAULT_RESULT_PATH;
     bool loggingEnabled = true;
-}
+    bool interactive = true;    // 无命令行配置参数时保持原有的交互式选择与退出前暂停
+
+    // 命令行选项（suite 模式）
+    struct CliOptions {
+        std::vector<std::string> configs;   // --config，可重复，名称或序号
+        std::string suite;                  // --suite：执行该配置条目的 "configs" 列表
+        std::string json_path;
+        std::string qos_path;
+        std::string result_dir;
+        bool stop_on_failure = false;
+        bool list_only = false;
+        bool show_help = false;
+    };
+
+    void printUsage() {
+        std::cout <<
+            "用法: ZRDDS_PerfBench [选项]\n"
+            "  (无参数)                  交互式选择配置\n"
+            "  -c, --config <名称|序号>  执行指定配置，可重复，按给出顺序执行\n"
+            "  -s, --suite <名称>        执行该配置条目 \"configs\" 列表中的全部配置\n"
+            "      --json <路径>         配置文件，默认 " << GlobalConfig::DEFAULT_JSON_CONFIG_PATH << "\n"
+            "      --qos <路径>          QoS 配置文件，默认 " << GlobalConfig::DEFAULT_QOS_XML_PATH << "\n"
+            "      --result-dir <目录>   结果输出目录，默认 " << GlobalConfig::DEFAULT_RESULT_PATH << "\n"
+            "      --stop-on-failure     任一配置失败后不再执行后续配置\n"
+            "  -l, --list                列出可用配置后退出\n"
+            "  -h, --help                显示本帮助\n"
+            "指定 --config / --suite / --list 时不读取标准输入，退出前不暂停。" << std::endl;
+    }
 
-int main() {
-    try {
-        // ================= 初始化全局内存池 =================
-        if (!GloMemPool::initialize()) {
-            std::cerr << "[Error] GloMemPool 初始化失败！" << std::endl;
-            std::cin.get(); // 等待用户按键，防止窗口关闭
-            return EXIT_FAILURE;
+    bool parseCommandLine(int argc, char* argv[], CliOptions& cli) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto value = [&](std::string& out) {
+                if (i + 1 >= argc) {
+                    std::cerr << "[Error] 参数 " << arg << " 缺少取值" << std::endl;
+                    return false;
+                }
+                out = argv[++i];
+                return true;
+                };
+
+            if (arg == "-c" || arg == "--config") {
+                std::string name;
+                if (!value(name)) return false;
+                cli.configs.push_back(name);
+            }
+            else if (arg == "-s" || arg == "--suite") {
+                if (!value(cli.suite)) return false;
+            }
+            else if (arg == "--json") {
+                if (!value(cli.json_path)) return false;
+            }
+            else if (arg == "--qos") {
+                if (!value(cli.qos_path)) return false;
+            }
+            else if (arg == "--result-dir") {
+                if (!value(cli.result_dir)) return false;
+            }
+            else if (arg == "--stop-on-failure") {
+                cli.stop_on_failure = true;
+            }
+            else if (arg == "-l" || arg == "--list") {
+                cli.list_only = true;
+            }
+            else if (arg == "-h" || arg == "--help") {
+                cli.show_help = true;
+            }
+            else {
+                std::cerr << "[Error] 未知参数: " << arg << std::endl;
+                return false;
+            }
         }
-        Logger::getInstance().logAndPrint("[Memory] 使用 GloMemPool 管理全局内存");
+        return true;
+    }
 
-        // ================= 初始化日志系统 =================
-        Logger::setupLogger(logDir, logPrefix, logSuffix);
+    // 展开 --suite 与 --config 为待执行的配置名列表（suite 在前），并校验每个配置都存在
+    bool expandSuite(const Config& config, const CliOptions& cli, std::vector<std::string>& names) {
+        const auto& all = config.getConfigs();
+        ConfigData entry;
 
-        // ================= 加载并选择配置 =================
-        Config config(json_file_path);
-        if (!config.promptAndSelectConfig(&Logger::getInstance())) {
-            Logger::getInstance().logAndPrint("用户取消选择或配置加载失败");
-            std::cin.get(); // 等待用户按键，防止窗口关闭
-            return EXIT_FAILURE;
+        if (!cli.suite.empty()) {
+            if (!config.findConfig(cli.suite, entry)) {
+                Logger::getInstance().error("[Suite] 未找到 suite 配置: " + cli.suite);
+                return false;
+            }
+            if (!entry.has_configs || entry.configs.empty()) {
+                Logger::getInstance().error("[Suite] 配置 " + cli.suite + " 没有 \"configs\" 列表");
+                return false;
+            }
+            names.insert(names.end(), entry.configs.begin(), entry.configs.end());
         }
 
-        const ConfigData& base_config = config.getCurrentConfig();
-        const int total_rounds = base_config.m_loopNum;
-
-        Logger::getInstance().logAndPrint("\n=== 当前选中的配置模板 ===");
-        std::ostringstream cfgStream;
-        config.printCurrentConfig(cfgStream);
-        Logger::getInstance().logAndPrint(cfgStream.str());
-
-        // ==================== 新增：解析测试类型（吞吐 or 时延）====================
-        std::string config_name = base_config.name;
-        bool is_throughput_test = false;
-        bool is_latency_test = false;
-
-        if (config_name.rfind("tp::", 0) == 0) {
-            is_throughput_test = true;
-            Logger::getInstance().logAndPrint("[Test Mode] 吞吐测试模式 (tp::)");
-        }
-        else if (config_name.rfind("delay::", 0) == 0) {
-            is_latency_test = true;
-            Logger::getInstance().logAndPrint("[Test Mode] 时延测试模式 (delay::)");
+        for (const std::string& item : cli.configs) {
+            const bool numeric = !item.empty() && item.find_first_not_of("0123456789") == std::string::npos;
+            if (numeric) {
+                const size_t index = static_cast<size_t>(std::stoull(item));
+                if (index >= all.size()) {
+                    Logger::getInstance().error("[Suite] 配置序号超出范围: " + item);
+                    return false;
+                }
+                names.push_back(all[index].name);
+            }
+            else {
+                names.push_back(item);
+            }
         }
-        else {
-            Logger::getInstance().error("[Test Mode] 配置名 '" + config_name + "' 必须以 'tp::' 或 'delay::' 开头！");
-            std::cin.get();
-            return EXIT_FAILURE;
+
+        for (const std::string& name : names) {
+            if (!config.findConfig(name, entry)) {
+                Logger::getInstance().error("[Suite] 未找到配置: " + name);
+                return false;
+            }
         }
+        return !names.empty();
+    }
 
-        if (total_rounds <= 0) {
-            Logger::getInstance().logAndPrint("[Error] m_loopNum 必须大于 0");
+    void waitForKeyIfInteractive() {
+        if (interactive) {
             std::cin.get();
-            return EXIT_FAILURE;
         }
+    }
+}
 
-        Logger::getInstance().logAndPrint("开始执行 " + std::to_string(total_rounds) + " 轮测试...");
-
-        // ==================== 根据传输模式选择 Bytes 或 ZeroCopy ====================
-        bool is_zero_copy_mode = (base_config.m_typeName == "DDS::ZeroCopyBytes");
-
-        // --- 定义所有可能需要的管理器和测试对象 ---
-        std::unique_ptr<DDSManager_Bytes> bytes_manager;
-        std::unique_ptr<DDSManager_ZeroCopyBytes> zc_manager;
+// ==================== 执行当前选中的配置（全部轮次）====================
+// 交互模式与 suite 模式共用；返回 EXIT_SUCCESS / EXIT_FAILURE。
+// DomainParticipantFactory 为进程级单例，连续执行多个配置时复用同一工厂与已加载的 QoS 库
+int runSelectedConfig(const Config& config) {
+    const ConfigData& base_config = config.getCurrentConfig();
+    const int total_rounds = base_config.m_loopNum;
+
+    Logger::getInstance().logAndPrint("\n=== 当前选中的配置模板 ===");
+    std::ostringstream cfgStream;
+    config.printCurrentConfig(cfgStream);
+    Logger::getInstance().logAndPrint(cfgStream.str());
+
+    // ==================== 新增：解析测试类型（吞吐 or 时延）====================
+    std::string config_name = base_config.name;
+    bool is_throughput_test = false;
+    bool is_latency_test = false;
+    bool is_scale_test = false;
+    bool is_traffic_test = false;
+
+    if (config_name.rfind("tp::", 0) == 0) {
+        is_throughput_test = true;
+        Logger::getInstance().logAndPrint("[Test Mode] 吞吐测试模式 (tp::)");
+    }
+    else if (config_name.rfind("delay::", 0) == 0) {
+        is_latency_test = true;
+        Logger::getInstance().logAndPrint("[Test Mode] 时延测试模式 (delay::)");
+    }
+    else if (config_name.rfind("scale::", 0) == 0) {
+        is_scale_test = true;
+        Logger::getInstance().logAndPrint("[Test Mode] 规模测试模式 (scale::)");
+    }
+    else if (config_name.rfind("traffic::", 0) == 0) {
+        is_traffic_test = true;
+        Logger::getInstance().logAndPrint("[Test Mode] 混合负载测试模式 (traffic::)");
+    }
+    else {
+        Logger::getInstance().error("[Test Mode] 配置名 '" + config_name + "' 必须以 'tp::'、'delay::'、'scale::' 或 'traffic::' 开头！");
+        return EXIT_FAILURE;
+    }
 
-        std::unique_ptr<Throughput_Bytes> throughput_bytes;
-        std::unique_ptr<Throughput_ZeroCopyBytes> throughput_zc;
+    if (total_rounds <= 0) {
+        Logger::getInstance().logAndPrint("[Error] m_loopNum 必须大于 0");
+        return EXIT_FAILURE;
+    }
 
-        std::unique_ptr<LatencyTest_Bytes> latency_test_bytes;
+    Logger::getInstance().logAndPrint("开始执行 " + std::to_string(total_rounds) + " 轮测试...");
 
-        MetricsReport metricsReport;
+    // 日志级别（suite 模式下按配置整表替换，上一配置遗留的线程仍可安全读取）；调试级别在 NDEBUG 构建中已整句编译剔除
+    Logger::getInstance().configureLevels(base_config.m_logLevel);
 
-        // ========== 主循环：多轮测试 ==========
-        int total_result = EXIT_SUCCESS;
+    // ==================== 实时执行配置（须在创建工作线程前设置，每进程只生效一次）====================
+    RealtimeProfile& rtProfile = RealtimeProfile::instance();
+    if (rtProfile.configure(base_config.m_cpuAffinity, base_config.m_rtPriority,
+        base_config.m_lockMemory, base_config.m_prefault) && rtProfile.enabled()) {
+        Logger::getInstance().logAndPrint(rtProfile.describe());
+        rtProfile.applyToThread(Logger::getInstance().writerThreadHandle(), "logger");
+        rtProfile.lockProcessMemory();
+    }
 
-        for (int round = 0; round < total_rounds; ++round) {
-            Logger::getInstance().logAndPrint(
-                "=== 第 " + std::to_string(round + 1) + "/" + std::to_string(total_rounds) +
-                " 轮测试开始 (m_activeLoop=" + std::to_string(round) + ") ==="
-            );
+    // ==================== 根据传输模式选择 Bytes 或 ZeroCopy ====================
+    bool is_zero_copy_mode = (base_config.m_typeName == "DDS::ZeroCopyBytes");
+    if (is_scale_test && is_zero_copy_mode) {
+        Logger::getInstance().logAndPrint("[Warning] scale:: 模式仅支持 DDS::Bytes，按 Bytes 运行");
+        is_zero_copy_mode = false;
+    }
 
-            // 创建本轮配置副本
-            ConfigData current_cfg = base_config;
-            current_cfg.m_activeLoop = round;
-
-            // 打印本轮参数
-            std::ostringstream roundCfgStream;
-            Config::printConfigToStream(current_cfg, roundCfgStream);
-            Logger::getInstance().logAndPrint(roundCfgStream.str());
-
-            // ------------------- 第一步：创建 DDSManager（如果尚未创建）-------------------
-            if (round == 0) {
-                if (is_zero_copy_mode) {
-                    zc_manager = std::make_unique<DDSManager_ZeroCopyBytes>(current_cfg, qos_file_path);
-                    if (is_throughput_test) {
-                        throughput_zc = std::make_unique<Throughput_ZeroCopyBytes>(
-                            *zc_manager,
-                            [&metricsReport](const TestRoundResult& result) {
-                                metricsReport.addResult(result);
-                            }
-                        );
-                    }
-                }
-                else {
-                    bytes_manager = std::make_unique<DDSManager_Bytes>(current_cfg, qos_file_path);
-                    if (is_throughput_test) {
-                        throughput_bytes = std::make_unique<Throughput_Bytes>(
-                            *bytes_manager,
-                            [&metricsReport](const TestRoundResult& result) {
-                                metricsReport.addResult(result);
-                            }
-                        );
-                    }
-                    else if (is_latency_test) {
-                        latency_test_bytes = std::make_unique<LatencyTest_Bytes>(
-                            *bytes_manager,
-                            [&metricsReport](const TestRoundResult& result) {
-                                metricsReport.addResult(result);
-                            }
-                        );
-                    }
-                }
+    // 实体复用：参与者 / Topic / 端点只在首轮创建、末轮后删除，轮次由结束包在带内划分。
+    // 时延 / 规模 / 混合负载模式每轮的实体布局或收发协议依赖重建，仍按每轮重建运行
+    const bool persistent_entities = base_config.m_persistentEntities && is_throughput_test;
+    if (base_config.m_persistentEntities && !persistent_entities) {
+        Logger::getInstance().logAndPrint("[Warning] m_persistentEntities 仅支持 tp:: 模式，按每轮重建运行");
+    }
 
-                // ==================== 初始化 ResourceUtilization（仅一次）====================
-                if (!ResourceUtilization::instance().initialize()) {
-                    Logger::getInstance().logAndPrint("[Warning] ResourceUtilization 初始化失败！CPU 监控可能无效。");
-                }
-                else {
-                    Logger::getInstance().logAndPrint("[Resource] ResourceUtilization 初始化成功");
+    // --- 定义所有可能需要的管理器和测试对象 ---
+    std::unique_ptr<DDSManager_Bytes> bytes_manager;
+    std::unique_ptr<DDSManager_ZeroCopyBytes> zc_manager;
+
+    std::unique_ptr<Throughput_Bytes> throughput_bytes;
+    std::unique_ptr<Throughput_ZeroCopyBytes> throughput_zc;
+
+    std::unique_ptr<LatencyTest_Bytes> latency_test_bytes;
+    std::unique_ptr<LatencyTest_ZeroCopyBytes> latency_test_zc;
+
+    std::unique_ptr<DDSManager_Scale> scale_manager;
+    std::unique_ptr<ScaleTest> scale_test;
+    std::unique_ptr<TrafficTest> traffic_test;
+
+    MetricsReport metricsReport;
+
+    // 机器可读结果：每轮一行写入 <结果目录>/<m_resultPath>.csv / .jsonl
+    ResultWriter resultWriter;
+    resultWriter.open(resultDir, base_config.m_resultPath);
+
+    // 基线记录 / 回归比较（m_baselineMode）
+    BaselineStore baselineStore;
+    baselineStore.configure((std::filesystem::path(resultDir) / "baseline").string(),
+        base_config.m_baselineMode, base_config.m_regressionThresholdPct);
+
+    ResultContext result_ctx;   // 每轮开始前更新
+    auto on_round_result = [&metricsReport, &resultWriter, &baselineStore, &result_ctx](const TestRoundResult& result) {
+        metricsReport.addResult(result);
+        resultWriter.append(result);
+        baselineStore.onRound(result_ctx, result);
+        };
+
+    // ========== 主循环：多轮测试 ==========
+    int total_result = EXIT_SUCCESS;
+    std::chrono::steady_clock::time_point setup_begin;   // 本轮准备阶段起点（上一轮第五步开始）
+    double total_setup_ms = 0.0;
+
+    for (int round = 0; round < total_rounds; ++round) {
+        Logger::getInstance().logAndPrint(
+            "=== 第 " + std::to_string(round + 1) + "/" + std::to_string(total_rounds) +
+            " 轮测试开始 (m_activeLoop=" + std::to_string(round) + ") ==="
+        );
+
+        // 创建本轮配置副本
+        ConfigData current_cfg = base_config;
+        current_cfg.m_activeLoop = round;
+
+        // 打印本轮参数
+        std::ostringstream roundCfgStream;
+        Config::printConfigToStream(current_cfg, roundCfgStream);
+        Logger::getInstance().logAndPrint(roundCfgStream.str());
+
+        result_ctx = ResultContext{};
+        result_ctx.config_name = current_cfg.name;
+        result_ctx.type_name = current_cfg.m_typeName;
+        result_ctx.dpf_qos = current_cfg.m_dpfQosName;
+        result_ctx.dp_qos = current_cfg.m_dpQosName;
+        result_ctx.writer_qos = current_cfg.m_writerQosName;
+        result_ctx.reader_qos = current_cfg.m_readerQosName;
+        if (round < static_cast<int>(current_cfg.m_sendCount.size())) {
+            result_ctx.send_count = current_cfg.m_sendCount[round];
+        }
+        if (round < static_cast<int>(current_cfg.m_minSize.size()) &&
+            round < static_cast<int>(current_cfg.m_maxSize.size())) {
+            result_ctx.min_size = current_cfg.m_minSize[round];
+            result_ctx.max_size = current_cfg.m_maxSize[round];
+        }
+        result_ctx.persistent_entities = persistent_entities;
+
+        // ------------------- 第一步：创建 DDSManager（如果尚未创建）-------------------
+        if (round == 0) {
+            if (is_scale_test) {
+                scale_manager = std::make_unique<DDSManager_Scale>(current_cfg, qos_file_path);
+                scale_test = std::make_unique<ScaleTest>(
+                    *scale_manager,
+                    on_round_result
+                );
+            }
+            else if (is_traffic_test) {
+                // 混合负载复用规模测试管理器，实体按端点配置逐个创建
+                scale_manager = std::make_unique<DDSManager_Scale>(current_cfg, qos_file_path);
+                traffic_test = std::make_unique<TrafficTest>(
+                    *scale_manager,
+                    on_round_result
+                );
+                if (!traffic_test->loadProfiles(config, current_cfg)) {
+                    total_result = EXIT_FAILURE;
+                    break;
                 }
             }
-
-            // ------------------- 第二步：重新初始化 DDSManager（每轮都要）-------------------
-            bool init_success = false;
-
-            if (is_throughput_test) {
-                if (is_zero_copy_mode) {
-                    if (current_cfg.m_isPositive) {
-                        init_success = zc_manager->initialize();
-                    }
-                    else {
-                        auto end_callback = [&]() { throughput_zc->onEndOfRound(); };
-                        init_success = zc_manager->initialize(
-                            [&](const DDS::ZeroCopyBytes& sample, const DDS::SampleInfo& info) {
-                                throughput_zc->onDataReceived(sample, info);
-                            },
-                            end_callback
-                        );
-                    }
+            else if (is_zero_copy_mode) {
+                zc_manager = std::make_unique<DDSManager_ZeroCopyBytes>(current_cfg, qos_file_path);
+                if (is_throughput_test) {
+                    throughput_zc = std::make_unique<Throughput_ZeroCopyBytes>(
+                        *zc_manager,
+                        on_round_result
+                    );
                 }
-                else {
-                    if (current_cfg.m_isPositive) {
-                        init_success = bytes_manager->initialize();
-                    }
-                    else {
-                        auto end_callback = [&]() { throughput_bytes->onEndOfRound(); };
-                        init_success = bytes_manager->initialize(
-                            [&](const DDS::Bytes& sample, const DDS::SampleInfo& info) {
-                                throughput_bytes->onDataReceived(sample, info);
-                            },
-                            end_callback
-                        );
-                    }
+                else if (is_latency_test) {
+                    latency_test_zc = std::make_unique<LatencyTest_ZeroCopyBytes>(
+                        *zc_manager,
+                        on_round_result
+                    );
                 }
             }
-            else if (is_latency_test) {
-                // 每一轮都必须重新初始化 DDSManager（时延模式）
-                if (is_zero_copy_mode) {
-                    // TODO: 支持 ZeroCopy 模式
-                    init_success = false;
-                }
-                else {
-                    if (current_cfg.m_isPositive) {
-                        // Initiator: 发送 Ping，接收 Pong
-                        init_success = bytes_manager->initialize_latency(
-                            nullptr, // 不接收 Ping
-                            [&latency_test_bytes](const DDS::Bytes& s, const DDS::SampleInfo& i) {
-                                latency_test_bytes->handlePongReceived(s, i); // 处理回包
-                            },
-                            nullptr // 不处理结束包
-                        );
-                    }
-                    else {
-                        // Responder: 接收 Ping，发送 Pong
-                        init_success = bytes_manager->initialize_latency(
-                            [&latency_test_bytes](const DDS::Bytes& s, const DDS::SampleInfo& i) {
-                                latency_test_bytes->onDataReceived(s, i); // 回复 Pong
-                            },
-                            nullptr, // 不接收 Pong
-                            nullptr  // 不处理结束包
-                        );
-                    }
+            else {
+                bytes_manager = std::make_unique<DDSManager_Bytes>(current_cfg, qos_file_path);
+                if (is_throughput_test) {
+                    throughput_bytes = std::make_unique<Throughput_Bytes>(
+                        *bytes_manager,
+                        on_round_result
+                    );
                 }
-
-                // 确保对象已创建
-                if (init_success && !latency_test_bytes && round == 0) {
+                else if (is_latency_test) {
                     latency_test_bytes = std::make_unique<LatencyTest_Bytes>(
                         *bytes_manager,
-                        [&metricsReport](const TestRoundResult& result) {
-                            metricsReport.addResult(result);
-                        }
+                        on_round_result
                     );
                 }
             }
 
-            if (!init_success && is_throughput_test) {
-                Logger::getInstance().logAndPrint("[Error] DDSManager 初始化失败（第 " + std::to_string(round + 1) + " 轮）");
-                total_result = EXIT_FAILURE;
-                break;
+            // ==================== 初始化 ResourceUtilization（仅一次）====================
+            if (!ResourceUtilization::instance().initialize()) {
+                Logger::getInstance().logAndPrint("[Warning] ResourceUtilization 初始化失败！CPU 监控可能无效。");
             }
+            else {
+                Logger::getInstance().logAndPrint("[Resource] ResourceUtilization 初始化成功");
+            }
+        }
 
-            // ------------------- 第三步：等待重连（Publisher 角色 + 非首轮回合）-------------------
-            if (current_cfg.m_isPositive && round > 0) {
-                Logger::getInstance().logAndPrint("等待订阅者重新上线...");
+        // ------------------- 第二步：重新初始化 DDSManager（每轮都要；实体复用时仅首轮）-------------------
+        bool init_success = false;
 
-                bool connected = false;
-                if (is_throughput_test) {
-                    connected = is_zero_copy_mode ?
-                        throughput_zc->waitForSubscriberReconnect(std::chrono::seconds(1)) :
-                        throughput_bytes->waitForSubscriberReconnect(std::chrono::seconds(1));
+        if (round == 0) {
+            setup_begin = std::chrono::steady_clock::now();
+        }
+
+        if (persistent_entities && round > 0) {
+            // 沿用首轮创建的实体；匹配计时从本轮开始，等待时重新查询已有匹配
+            if (zc_manager) {
+                zc_manager->match_tracker().reset();
+            }
+            if (bytes_manager) {
+                bytes_manager->match_tracker().reset();
+            }
+            init_success = true;
+        }
+        else if (is_scale_test) {
+            // 先按本轮布局准备接收计数，再创建实体（监听器可能立即回调）
+            ScaleLayout layout = scale_test->prepareRound(current_cfg);
+            init_success = scale_manager->initialize(
+                layout,
+                [&](size_t reader_index, const DDS::Bytes& sample, const DDS::SampleInfo& info) {
+                    scale_test->onDataReceived(reader_index, sample, info);
+                },
+                [&](size_t reader_index, uint32_t source) { scale_test->onEndOfRound(reader_index, source); }
+            );
+        }
+        else if (is_traffic_test) {
+            EntityPlan plan = traffic_test->prepareRound(current_cfg);
+            init_success = scale_manager->initialize(
+                plan,
+                [&](size_t reader_index, const DDS::Bytes& sample, const DDS::SampleInfo& info) {
+                    traffic_test->onDataReceived(reader_index, sample, info);
+                },
+                [&](size_t reader_index, uint32_t source) { traffic_test->onEndOfRound(reader_index, source); }
+            );
+        }
+        else if (is_throughput_test) {
+            if (is_zero_copy_mode) {
+                if (current_cfg.m_isPositive) {
+                    init_success = zc_manager->initialize();
                 }
-                // 时延模式不使用此机制（由 LatencyTest 自行处理连接）
-                if (!connected && is_throughput_test) {
-                    Logger::getInstance().logAndPrint("警告：未检测到订阅者重连，超时继续...");
+                else {
+                    auto end_callback = [&](uint32_t round) { throughput_zc->onEndOfRound(round); };
+                    init_success = zc_manager->initialize(
+                        [&](const DDS::ZeroCopyBytes& sample, const DDS::SampleInfo& info) {
+                            throughput_zc->onDataReceived(sample, info);
+                        },
+                        end_callback
+                    );
                 }
             }
-
-            // ------------------- 第四步：运行单轮测试 -------------------
-            int result = 0;
-
-            if (current_cfg.m_isPositive) {
-                if (is_throughput_test) {
-                    result = is_zero_copy_mode ?
-                        throughput_zc->runPublisher(current_cfg) :
-                        throughput_bytes->runPublisher(current_cfg);
+            else {
+                if (current_cfg.m_isPositive) {
+                    init_success = bytes_manager->initialize();
                 }
-                else if (is_latency_test) {
-                    result = is_zero_copy_mode ?
-                        /*latency_test_zc->runPublisher(current_cfg)*/ 0 :  // 未实现
-                        latency_test_bytes->runPublisher(current_cfg);
+                else {
+                    auto end_callback = [&](uint32_t round) { throughput_bytes->onEndOfRound(round); };
+                    init_success = bytes_manager->initialize(
+                        [&](const DDS::Bytes& sample, const DDS::SampleInfo& info) {
+                            throughput_bytes->onDataReceived(sample, info);
+                        },
+                        end_callback
+                    );
+                }
+            }
+        }
+        else if (is_latency_test) {
+            // 每一轮都必须重新初始化 DDSManager（时延模式）
+            if (is_zero_copy_mode) {
+                if (current_cfg.m_isPositive) {
+                    // Initiator: 发送 Ping，接收 Pong
+                    init_success = zc_manager->initialize_latency(
+                        nullptr,
+                        [&latency_test_zc](const DDS::ZeroCopyBytes& s, const DDS::SampleInfo& i) {
+                            latency_test_zc->handlePongReceived(s, i);
+                        },
+                        nullptr
+                    );
+                }
+                else {
+                    // Responder: 接收 Ping，发送 Pong；结束包被监听器拦截，需经 end_callback 回复
+                    init_success = zc_manager->initialize_latency(
+                        [&latency_test_zc](const DDS::ZeroCopyBytes& s, const DDS::SampleInfo& i) {
+                            latency_test_zc->onDataReceived(s, i);
+                        },
+                        nullptr,
+                        [&latency_test_zc](uint32_t) { latency_test_zc->onEndOfRound(); }
+                    );
                 }
             }
             else {
-                if (is_throughput_test) {
-                    result = is_zero_copy_mode ?
-                        throughput_zc->runSubscriber(current_cfg) :
-                        throughput_bytes->runSubscriber(current_cfg);
+                if (current_cfg.m_isPositive) {
+                    // Initiator: 发送 Ping，接收 Pong
+                    init_success = bytes_manager->initialize_latency(
+                        nullptr, // 不接收 Ping
+                        [&latency_test_bytes](const DDS::Bytes& s, const DDS::SampleInfo& i) {
+                            latency_test_bytes->handlePongReceived(s, i); // 处理回包
+                        },
+                        nullptr // 不处理结束包
+                    );
                 }
-                else if (is_latency_test) {
-                    result = is_zero_copy_mode ?
-                        /*latency_test_zc->runSubscriber(current_cfg)*/ 0 :
-                        latency_test_bytes->runSubscriber(current_cfg);
+                else {
+                    // Responder: 接收 Ping，发送 Pong
+                    init_success = bytes_manager->initialize_latency(
+                        [&latency_test_bytes](const DDS::Bytes& s, const DDS::SampleInfo& i) {
+                            latency_test_bytes->onDataReceived(s, i); // 回复 Pong
+                        },
+                        nullptr, // 不接收 Pong
+                        nullptr  // 不处理结束包
+                    );
                 }
             }
 
-            if (result == 0) {
-                Logger::getInstance().logAndPrint("第 " + std::to_string(round + 1) + " 轮测试完成。");
+            // 确保对象已创建
+            if (init_success && !is_zero_copy_mode && !latency_test_bytes && round == 0) {
+                latency_test_bytes = std::make_unique<LatencyTest_Bytes>(
+                    *bytes_manager,
+                    on_round_result
+                );
             }
-            else {
-                Logger::getInstance().logAndPrint("第 " + std::to_string(round + 1) + " 轮测试发生错误。");
-                total_result = EXIT_FAILURE;
+        }
+
+        if (!init_success) {
+            Logger::getInstance().logAndPrint("[Error] DDSManager 初始化失败（第 " + std::to_string(round + 1) + " 轮）");
+            total_result = EXIT_FAILURE;
+            break;
+        }
+
+        // ------------------- 第三步：等待重连（Publisher 角色 + 非首轮回合；实体复用时匹配一直保持）-------------------
+        if (current_cfg.m_isPositive && round > 0 && !is_scale_test && !is_traffic_test && !persistent_entities) {
+            Logger::getInstance().logAndPrint("等待订阅者重新上线...");
+
+            bool connected = false;
+            if (is_throughput_test) {
+                connected = is_zero_copy_mode ?
+                    throughput_zc->waitForSubscriberReconnect(std::chrono::seconds(1)) :
+                    throughput_bytes->waitForSubscriberReconnect(std::chrono::seconds(1));
             }
+            // 时延模式不使用此机制（由 LatencyTest 自行处理连接）
+            if (!connected && is_throughput_test) {
+                Logger::getInstance().logAndPrint("警告：未检测到订阅者重连，超时继续...");
+            }
+        }
+
+        // 准备耗时：上一轮清理 + 缓冲等待 + 本轮初始化 + 等待重连（首轮为首次创建实体）
+        const double setup_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - setup_begin).count();
+        total_setup_ms += setup_ms;
+        result_ctx.setup_ms = setup_ms;
+        resultWriter.setContext(result_ctx);
+        {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(1) << "第 " << (round + 1) << " 轮准备耗时: " << setup_ms
+                << " ms (" << (persistent_entities ? "实体复用" : "每轮重建") << ")";
+            Logger::getInstance().logAndPrint(oss.str());
+        }
+
+        // ------------------- 第四步：运行单轮测试 -------------------
+        int result = 0;
 
-            // ------------------- 第五步：清理本轮回合资源 -------------------
+        if (is_scale_test) {
+            // 规模测试按 Topic 区间同时承担收发，不区分角色
+            result = scale_test->runRound(current_cfg);
+        }
+        else if (is_traffic_test) {
+            result = traffic_test->runRound(current_cfg);
+        }
+        else if (current_cfg.m_isPositive) {
             if (is_throughput_test) {
-                if (is_zero_copy_mode) {
-                    zc_manager->shutdown();
-                }
-                else {
-                    bytes_manager->shutdown();
-                }
+                result = is_zero_copy_mode ?
+                    throughput_zc->runPublisher(current_cfg) :
+                    throughput_bytes->runPublisher(current_cfg);
             }
-            // 时延模式：也必须 shutdown（因为 LatencyTest 内部可能调用了 initialize_latency）
             else if (is_latency_test) {
-                if (is_zero_copy_mode && zc_manager) {
-                    zc_manager->shutdown();
-                }
-                else if (bytes_manager) {
-                    bytes_manager->shutdown();
-                }
+                result = is_zero_copy_mode ?
+                    latency_test_zc->runPublisher(current_cfg) :
+                    latency_test_bytes->runPublisher(current_cfg);
             }
+        }
+        else {
+            if (is_throughput_test) {
+                result = is_zero_copy_mode ?
+                    throughput_zc->runSubscriber(current_cfg) :
+                    throughput_bytes->runSubscriber(current_cfg);
+            }
+            else if (is_latency_test) {
+                result = is_zero_copy_mode ?
+                    latency_test_zc->runSubscriber(current_cfg) :
+                    latency_test_bytes->runSubscriber(current_cfg);
+            }
+        }
 
-            // 缓冲时间，防止端口冲突
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        if (result == 0) {
+            Logger::getInstance().logAndPrint("第 " + std::to_string(round + 1) + " 轮测试完成。");
+        }
+        else {
+            Logger::getInstance().logAndPrint("第 " + std::to_string(round + 1) + " 轮测试发生错误。");
+            total_result = EXIT_FAILURE;
         }
 
-        // ==================== 测试结束，生成报告 ====================
-        Logger::getInstance().logAndPrint("\n--- 开始生成系统资源使用报告 ---");
-        metricsReport.generateSummary();
+        // ------------------- 第五步：清理本轮回合资源 -------------------
+        setup_begin = std::chrono::steady_clock::now();
+
+        if (persistent_entities) {
+            // 实体保留到末轮结束；轮次由包头标记区分，订阅端仍在结算上一轮时新一轮数据在回调中等待
+            continue;
+        }
+
+        if (is_scale_test || is_traffic_test) {
+            scale_manager->shutdown();
+        }
+        else if (is_throughput_test) {
+            if (is_zero_copy_mode) {
+                zc_manager->shutdown();
+            }
+            else {
+                bytes_manager->shutdown();
+            }
+        }
+        // 时延模式：也必须 shutdown（因为 LatencyTest 内部可能调用了 initialize_latency）
+        else if (is_latency_test) {
+            if (is_zero_copy_mode && zc_manager) {
+                zc_manager->shutdown();
+            }
+            else if (bytes_manager) {
+                bytes_manager->shutdown();
+            }
+        }
 
-        // 关闭资源采集
+        // 缓冲时间，防止端口冲突
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+
+    // 实体复用模式在全部轮次结束后统一删除实体
+    if (persistent_entities) {
+        if (zc_manager) {
+            zc_manager->shutdown();
+        }
+        if (bytes_manager) {
+            bytes_manager->shutdown();
+        }
+    }
+
+    {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << "平均每轮准备耗时: " << total_setup_ms / total_rounds
+            << " ms (" << (persistent_entities ? "实体复用" : "每轮重建") << "，共 " << total_rounds << " 轮)";
+        Logger::getInstance().logAndPrint(oss.str());
+    }
+
+    // ==================== 测试结束，生成报告 ====================
+    Logger::getInstance().logAndPrint("\n--- 开始生成系统资源使用报告 ---");
+    metricsReport.generateSummary();
+    if (baselineStore.finish() > 0) {
+        total_result = EXIT_FAILURE;   // 回归以非零退出码上报，便于脚本判定
+    }
+
+    return total_result == EXIT_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ==================== suite 模式：按顺序执行配置列表，无任何交互 ====================
+// 任一配置失败（或配置列表无效）时返回 EXIT_FAILURE；资源清理由 main 统一完成
+int runSuite(Config& config, const CliOptions& cli) {
+    int total_result = EXIT_SUCCESS;
+    std::vector<std::string> names;
+    if (!expandSuite(config, cli, names)) {
+        return EXIT_FAILURE;
+    }
+    Logger::getInstance().logAndPrint("[Suite] 共 " + std::to_string(names.size()) + " 个配置，按顺序执行");
+
+    std::vector<std::pair<std::string, int>> outcomes;
+    for (size_t k = 0; k < names.size(); ++k) {
+        Logger::getInstance().logAndPrint("\n[Suite] (" + std::to_string(k + 1) + "/" +
+            std::to_string(names.size()) + ") " + names[k]);
+        int rc = EXIT_FAILURE;
+        try {
+            config.selectConfig(names[k]);
+            rc = runSelectedConfig(config);
+        }
+        catch (const std::exception& e) {
+            Logger::getInstance().error("[Suite] 配置 " + names[k] + " 执行异常: " + e.what());
+        }
+        outcomes.emplace_back(names[k], rc);
+        if (rc != EXIT_SUCCESS) {
+            total_result = EXIT_FAILURE;
+            if (cli.stop_on_failure) {
+                Logger::getInstance().logAndPrint("[Suite] --stop-on-failure：停止执行剩余配置");
+                break;
+            }
+        }
+    }
+
+    Logger::getInstance().logAndPrint("\n=== Suite 汇总 ===");
+    for (const auto& outcome : outcomes) {
+        Logger::getInstance().logAndPrint("  " + outcome.first + " : " +
+            (outcome.second == EXIT_SUCCESS ? "成功" : "失败"));
+    }
+    return total_result;
+}
+
+int main(int argc, char* argv[]) {
+    CliOptions cli;
+    if (!parseCommandLine(argc, argv, cli)) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    if (cli.show_help) {
+        printUsage();
+        return EXIT_SUCCESS;
+    }
+    json_file_path = cli.json_path.empty() ? json_file_path : cli.json_path;
+    qos_file_path = cli.qos_path.empty() ? qos_file_path : cli.qos_path;
+    resultDir = cli.result_dir.empty() ? resultDir : cli.result_dir;
+    interactive = cli.configs.empty() && cli.suite.empty() && !cli.list_only;
+
+    try {
+        // ================= 初始化全局内存池 =================
+        if (!GloMemPool::initialize()) {
+            std::cerr << "[Error] GloMemPool 初始化失败！" << std::endl;
+            waitForKeyIfInteractive(); // 等待用户按键，防止窗口关闭
+            return EXIT_FAILURE;
+        }
+        Logger::getInstance().logAndPrint("[Memory] 使用 GloMemPool 管理全局内存");
+
+        // ================= 初始化日志系统 =================
+        Logger::setupLogger(logDir, logPrefix, logSuffix);
+
+        // ================= 加载配置 =================
+        Config config(json_file_path);
+        int total_result = EXIT_SUCCESS;
+
+        if (cli.list_only) {
+            config.listAvailableConfigs();
+            GloMemPool::finalize();
+            return EXIT_SUCCESS;
+        }
+
+        if (!interactive) {
+            total_result = runSuite(config, cli);
+        }
+        else if (!config.promptAndSelectConfig(&Logger::getInstance())) {
+            Logger::getInstance().logAndPrint("用户取消选择或配置加载失败");
+            total_result = EXIT_FAILURE;
+        }
+        else {
+            total_result = runSelectedConfig(config);
+        }
+
+        // 统一清理（失败路径同样经过这里）：关闭资源采集、释放内存池，日志后台线程写完剩余记录后退出
         ResourceUtilization::instance().shutdown();
         GloMemPool::finalize();
+        Logger::getInstance().close();
 
         // --- 新增：程序结束前暂停，防止 cmd 窗口关闭 ---
-        std::cout << "\n程序执行完毕，按任意键退出..." << std::endl;
-        std::cin.get();
+        std::cout << "\n程序执行完毕" << (interactive ? "，按任意键退出..." : "") << std::endl;
+        waitForKeyIfInteractive();
         // --- 新增结束 ---
 
-        return total_result == EXIT_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+        return total_result;
 
     }
     catch (const std::exception& e) {
@@ -342,8 +736,10 @@ int main() {
         else {
             std::cerr << errorMsg << std::endl;
         }
-        std::cout << "\n程序因异常终止，按任意键退出..." << std::endl;
-        std::cin.get(); // 等待用户按键，防止窗口关闭
+        if (interactive) {
+            std::cout << "\n程序因异常终止，按任意键退出..." << std::endl;
+        }
+        waitForKeyIfInteractive(); // 等待用户按键，防止窗口关闭
         return EXIT_FAILURE;
     }
     catch (...) {
@@ -354,8 +750,10 @@ int main() {
         else {
             std::cerr << errorMsg << std::endl;
         }
-        std::cout << "\n程序因未捕获异常终止，按任意键退出..." << std::endl;
-        std::cin.get(); // 等待用户按键，防止窗口关闭
+        if (interactive) {
+            std::cout << "\n程序因未捕获异常终止，按任意键退出..." << std::endl;
+        }
+        waitForKeyIfInteractive(); // 等待用户按键，防止窗口关闭
         return EXIT_FAILURE;
     }
 }
\ No newline at end of file
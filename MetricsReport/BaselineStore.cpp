@@ -0,0 +1,383 @@
+﻿// BaselineStore.cpp
+#include "BaselineStore.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>   // GetComputerNameA
+#else
+#include <unistd.h>    // gethostname
+#endif
+
+namespace {
+
+    std::string hostName() {
+#ifdef _WIN32
+        char name[MAX_COMPUTERNAME_LENGTH + 1] = {};
+        DWORD size = sizeof(name);
+        if (GetComputerNameA(name, &size)) return std::string(name, size);
+#else
+        char name[256] = {};
+        if (gethostname(name, sizeof(name) - 1) == 0) return name;
+#endif
+        return "unknown";
+    }
+
+    // FNV-1a 64，取前 8 位十六进制作为文件名中的环境标识
+    std::string shortHash(const std::string& text) {
+        uint64_t h = 14695981039346656037ull;
+        for (unsigned char ch : text) {
+            h ^= ch;
+            h *= 1099511628211ull;
+        }
+        std::ostringstream oss;
+        oss << std::hex << std::setw(8) << std::setfill('0') << static_cast<uint32_t>(h >> 32);
+        return oss.str();
+    }
+
+    std::string sanitize(std::string name) {
+        for (char& ch : name) {
+            if (ch == ':' || ch == '\\' || ch == '/' || ch == '*' || ch == '?' ||
+                ch == '"' || ch == '<' || ch == '>' || ch == '|' || ch == ' ') {
+                ch = '-';
+            }
+        }
+        return name;
+    }
+
+    // v2：每轮一个值（区间中位数）；v1 为区间样本序列
+    const char* const kFileHeader = "# zrdds baseline v2";
+
+    double median(std::vector<double> values) {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        const size_t n = values.size();
+        return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+    }
+
+} // namespace
+
+bool BaselineStore::configure(const std::string& dir, const std::string& mode, int threshold_pct) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (mode == "record") {
+        mode_ = Mode::Record;
+    }
+    else if (mode == "compare") {
+        mode_ = Mode::Compare;
+    }
+    else {
+        if (!mode.empty() && mode != "off") {
+            Logger::getInstance().logAndPrint("[Baseline] 警告：未知的 m_baselineMode '" + mode + "'，按 off 处理");
+        }
+        mode_ = Mode::Off;
+        return true;
+    }
+
+    dir_ = dir;
+    threshold_pct_ = threshold_pct > 0 ? threshold_pct : 5;
+    env_ = environmentDescription();
+    env_hash_ = shortHash(env_);
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    if (ec) {
+        Logger::getInstance().logAndPrint("[Baseline] 警告：无法创建基线目录 " + dir_ + " (" + ec.message() + ")，基线功能关闭");
+        mode_ = Mode::Off;
+        return false;
+    }
+
+    Logger::getInstance().logAndPrint(std::string("[Baseline] 模式: ") + (mode_ == Mode::Record ? "record" : "compare") +
+        " | 目录: " + dir_ + " | 环境: " + env_ + " (" + env_hash_ + ")" +
+        " | 阈值: " + std::to_string(threshold_pct_) + "%");
+    return true;
+}
+
+std::string BaselineStore::environmentDescription() {
+    std::ostringstream oss;
+    oss << "host=" << hostName()
+        << ";cpus=" << std::thread::hardware_concurrency()
+#ifdef _WIN32
+        << ";os=windows"
+#else
+        << ";os=linux"
+#endif
+#ifdef NDEBUG
+        << ";build=release";
+#else
+        << ";build=debug";
+#endif
+    return oss.str();
+}
+
+// 每个指标只取一个值：本轮区间采样的中位数（区间之间自相关，不作为独立样本）
+std::vector<BaselineStore::Series> BaselineStore::extractSeries(const TestRoundResult& result) {
+    std::vector<Series> series;
+    const std::string& role = result.perf.role;
+    if (role == "publisher" || role == "subscriber") {
+        Series rate{ "msgs_per_sec", true, {} };
+        std::vector<double> intervals;
+        for (const auto& s : result.intervals) {
+            if (s.messages > 0) intervals.push_back(s.msgs_per_sec);
+        }
+        if (!intervals.empty()) {
+            rate.values.push_back(median(intervals));
+        }
+        else if (result.perf.msgs_per_sec > 0) {
+            rate.values.push_back(result.perf.msgs_per_sec);   // 未开启区间采样时退化为整轮值
+        }
+        series.push_back(std::move(rate));
+    }
+    else if (role == "initiator") {
+        Series p50{ "latency_p50_us", false, {} };
+        Series p99{ "latency_p99_us", false, {} };
+        std::vector<double> p50_intervals;
+        std::vector<double> p99_intervals;
+        for (const auto& s : result.intervals) {
+            if (s.latency_count > 0) {
+                p50_intervals.push_back(s.latency_p50_us);
+                p99_intervals.push_back(s.latency_p99_us);
+            }
+        }
+        if (!p50_intervals.empty()) {
+            p50.values.push_back(median(p50_intervals));
+            p99.values.push_back(median(p99_intervals));
+        }
+        else if (result.perf.latency_count > 0) {
+            p50.values.push_back(result.perf.latency_p50_us);
+            p99.values.push_back(result.perf.latency_p99_us);
+        }
+        series.push_back(std::move(p50));
+        series.push_back(std::move(p99));
+    }
+    return series;
+}
+
+// 同一键在本次运行中多轮出现时按指标追加各轮的值
+void BaselineStore::appendSeries(std::vector<Series>& stored, const std::vector<Series>& round) {
+    if (stored.empty()) {
+        stored = round;
+        return;
+    }
+    for (size_t i = 0; i < stored.size() && i < round.size(); ++i) {
+        stored[i].values.insert(stored[i].values.end(), round[i].values.begin(), round[i].values.end());
+    }
+}
+
+std::string BaselineStore::pathFor(const ResultContext& context, const TestRoundResult& result) const {
+    const std::string key = sanitize(context.config_name) + "-" + result.perf.role + "-" +
+        std::to_string(result.perf.payload_bytes) + "B-" + env_hash_;
+    return (std::filesystem::path(dir_) / (key + ".baseline")).string();
+}
+
+void BaselineStore::onRound(const ResultContext& context, const TestRoundResult& result) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (mode_ == Mode::Off) return;
+
+    std::vector<Series> current = extractSeries(result);
+    if (current.empty()) return;   // responder / scale / traffic 等角色不参与基线
+    const std::string path = pathFor(context, result);
+
+    if (mode_ == Mode::Record) {
+        // 本次运行的各轮结果整体覆盖旧基线
+        auto& stored = recorded_[path];
+        appendSeries(stored, current);
+        const std::string key = std::filesystem::path(path).stem().string();
+        if (save(path, key, stored)) {
+            Logger::getInstance().logAndPrint("[Baseline] 第 " + std::to_string(result.round_index) +
+                " 轮已记录为基线: " + path);
+        }
+        return;
+    }
+
+    // compare：本轮只打印与基线的对照，回归检验在 finish 中按轮进行
+    appendSeries(current_[path], current);
+    std::vector<Series> baseline;
+    if (!load(path, baseline)) {
+        Logger::getInstance().logAndPrint("[Baseline] 第 " + std::to_string(result.round_index) + " 轮无可用基线: " + path);
+        return;
+    }
+    for (const Series& cur : current) {
+        auto it = std::find_if(baseline.begin(), baseline.end(),
+            [&cur](const Series& s) { return s.name == cur.name; });
+        if (it == baseline.end() || it->values.empty() || cur.values.empty()) continue;
+        const double base_median = median(it->values);
+        const double change_pct = base_median != 0.0 ? (cur.values[0] - base_median) / base_median * 100.0 : 0.0;
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2)
+            << "[Baseline] 第 " << result.round_index << " 轮 | " << cur.name
+            << " | 本轮: " << cur.values[0]
+            << " | 基线各轮中位数: " << base_median << " (" << it->values.size() << " 轮)"
+            << " | 变化: " << (change_pct >= 0 ? "+" : "") << change_pct << "%";
+        Logger::getInstance().logAndPrint(oss.str());
+    }
+}
+
+void BaselineStore::compare(const std::string& path, const std::vector<Series>& current) {
+    const std::string key = std::filesystem::path(path).stem().string();
+    std::vector<Series> baseline;
+    if (!load(path, baseline)) {
+        ++missing_;
+        Logger::getInstance().logAndPrint("[Baseline] " + key + " | 无可用基线: " + path);
+        return;
+    }
+
+    for (const Series& cur : current) {
+        auto it = std::find_if(baseline.begin(), baseline.end(),
+            [&cur](const Series& s) { return s.name == cur.name; });
+        if (it == baseline.end() || it->values.empty() || cur.values.empty()) continue;
+
+        const double base_median = median(it->values);
+        const double cur_median = median(cur.values);
+        const double change_pct = base_median != 0.0 ? (cur_median - base_median) / base_median * 100.0 : 0.0;
+        const bool worse = cur.higher_is_better ? change_pct < -threshold_pct_ : change_pct > threshold_pct_;
+        const bool enough = it->values.size() >= kMinSamples && cur.values.size() >= kMinSamples;
+        const double p = mannWhitneyP(it->values, cur.values);
+        const bool regression = worse && enough && p < kSignificance;
+
+        ++compared_;
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2)
+            << "[Baseline] " << key << " | " << cur.name
+            << " | 基线各轮中位数: " << base_median << " (" << it->values.size() << " 轮)"
+            << " | 本次各轮中位数: " << cur_median << " (" << cur.values.size() << " 轮)"
+            << " | 变化: " << (change_pct >= 0 ? "+" : "") << change_pct << "%"
+            << " | Mann-Whitney p=" << std::setprecision(4) << p;
+        if (regression) {
+            ++regressions_;
+            oss << " | 回归";
+            Logger::getInstance().error(oss.str());
+            continue;
+        }
+        if (worse) {
+            oss << (enough ? " | 变差但不显著" : " | 变差但轮数不足");
+        }
+        else {
+            oss << " | 正常";
+        }
+        Logger::getInstance().logAndPrint(oss.str());
+    }
+}
+
+int BaselineStore::finish() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (mode_ != Mode::Compare) return 0;
+    for (const auto& entry : current_) {
+        compare(entry.first, entry.second);
+    }
+    std::ostringstream oss;
+    oss << "[Baseline] 回归检查汇总 | 比较指标: " << compared_
+        << " | 回归: " << regressions_
+        << " | 无基线: " << missing_;
+    if (regressions_ > 0) {
+        Logger::getInstance().error(oss.str());
+    }
+    else {
+        Logger::getInstance().logAndPrint(oss.str());
+    }
+    return regressions_;
+}
+
+double BaselineStore::mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b) {
+    const size_t n1 = a.size();
+    const size_t n2 = b.size();
+    if (n1 == 0 || n2 == 0) return 1.0;
+
+    // 合并排序并计算平均秩
+    std::vector<std::pair<double, int>> all;
+    all.reserve(n1 + n2);
+    for (double v : a) all.emplace_back(v, 0);
+    for (double v : b) all.emplace_back(v, 1);
+    std::sort(all.begin(), all.end(),
+        [](const std::pair<double, int>& x, const std::pair<double, int>& y) { return x.first < y.first; });
+
+    const double n = static_cast<double>(n1 + n2);
+    double rank_sum_a = 0.0;
+    double tie_term = 0.0;
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) ++j;
+        const double avg_rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+        const double t = static_cast<double>(j - i);
+        tie_term += t * t * t - t;
+        for (size_t k = i; k < j; ++k) {
+            if (all[k].second == 0) rank_sum_a += avg_rank;
+        }
+        i = j;
+    }
+
+    const double u = rank_sum_a - n1 * (n1 + 1) / 2.0;
+    const double mu = n1 * n2 / 2.0;
+    const double sigma2 = n1 * n2 / 12.0 * ((n + 1.0) - tie_term / (n * (n - 1.0)));
+    if (sigma2 <= 0.0) return 1.0;   // 全部取值相同
+
+    // 连续性校正后的正态近似，双侧
+    const double diff = std::fabs(u - mu) - 0.5;
+    const double z = (diff > 0.0 ? diff : 0.0) / std::sqrt(sigma2);
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+bool BaselineStore::load(const std::string& path, std::vector<Series>& series) const {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    if (!std::getline(in, line) || line != kFileHeader) {
+        // v1 基线保存的是区间样本，与按轮检验不可比，需要重新 record
+        Logger::getInstance().logAndPrint("[Baseline] 警告：基线格式不匹配（需重新 record）: " + path);
+        return false;
+    }
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        std::string tag;
+        std::string direction;
+        Series s;
+        if (!(iss >> tag >> s.name >> direction) || tag != "metric") continue;
+        s.higher_is_better = direction == "higher";
+        double v = 0.0;
+        while (iss >> v) s.values.push_back(v);
+        series.push_back(std::move(s));
+    }
+    return !series.empty();
+}
+
+bool BaselineStore::save(const std::string& path, const std::string& key, const std::vector<Series>& series) const {
+    // 先写临时文件再替换，避免中断时留下半个基线
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out) {
+            Logger::getInstance().logAndPrint("[Baseline] 警告：无法写入基线文件 " + tmp);
+            return false;
+        }
+        out << kFileHeader << "\n"
+            << "# key=" << key << "\n"
+            << "# env=" << env_ << "\n";
+        out << std::setprecision(10);
+        for (const Series& s : series) {
+            out << "metric " << s.name << ' ' << (s.higher_is_better ? "higher" : "lower");
+            for (double v : s.values) out << ' ' << v;
+            out << '\n';
+        }
+        out.flush();
+        if (!out) {
+            Logger::getInstance().logAndPrint("[Baseline] 警告：写入基线文件失败 " + tmp);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        Logger::getInstance().logAndPrint("[Baseline] 警告：替换基线文件失败 " + path + " (" + ec.message() + ")");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,89 @@
+﻿// BaselineStore.h
+#pragma once
+
+#include "ResultWriter.h"
+#include "TestRoundResult.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 本地基线结果库与回归比较（m_baselineMode）。
+ *
+ * 基线按 "配置名 - 角色 - 包长 - 环境指纹" 作为键，每个键一个文本文件，每轮保存一个值（该轮区间采样的中位数）：
+ *  - publisher / subscriber：区间 msg/s（越高越好）
+ *  - initiator：区间 RTT p50 / p99（越低越好）
+ * 无消息 / 无时延样本的区间不计入（匹配等待与结束包阶段）。
+ * 同一轮内相邻区间强相关，不能当作独立样本做检验，因此检验单位是轮而不是区间。
+ *
+ * record 模式下本次运行各轮的中位数覆盖写入基线；compare 模式下逐轮打印对照，运行结束（finish）时
+ * 将本次各轮中位数与基线各轮中位数做 Mann-Whitney U 双侧检验（正态近似 + 并列校正），
+ * 中位数变差超过 m_regressionThresholdPct 且 p < 0.05 时判定为回归。每侧不足 kMinSamples 轮时只报告不判定，
+ * 需要判定回归的配置应将 m_loopNum 设为不少于该值。
+ * 环境指纹包含主机名、逻辑核数、操作系统与构建类型，不同环境的结果互不比较。
+ */
+class BaselineStore {
+public:
+    enum class Mode { Off, Record, Compare };
+
+    static constexpr double kSignificance = 0.05;   // 显著性水平
+    static constexpr size_t kMinSamples = 5;        // 每侧最少轮数，不足时只报告不判定
+
+    /**
+     * @param dir 基线目录（<结果目录>/baseline）
+     * @param mode "off" / "record" / "compare"，无法识别时按 off 处理
+     */
+    bool configure(const std::string& dir, const std::string& mode, int threshold_pct);
+
+    Mode mode() const { return mode_; }
+
+    /**
+     * @brief 记录或比较一轮结果（线程安全）
+     */
+    void onRound(const ResultContext& context, const TestRoundResult& result);
+
+    /**
+     * @brief compare 模式：对本次运行累计的各轮结果做回归检验并输出汇总
+     * @return 判定为回归的指标数
+     */
+    int finish();
+
+    /**
+     * @brief Mann-Whitney U 双侧检验 p 值；任一侧为空时返回 1.0
+     */
+    static double mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b);
+
+    /**
+     * @brief 可读的环境描述，如 "host=bench01;cpus=16;os=windows;build=release"
+     */
+    static std::string environmentDescription();
+
+private:
+    struct Series {
+        std::string name;
+        bool higher_is_better = true;
+        std::vector<double> values;
+    };
+
+    static std::vector<Series> extractSeries(const TestRoundResult& result);
+    static void appendSeries(std::vector<Series>& stored, const std::vector<Series>& round);
+    std::string pathFor(const ResultContext& context, const TestRoundResult& result) const;
+    bool load(const std::string& path, std::vector<Series>& series) const;
+    bool save(const std::string& path, const std::string& key, const std::vector<Series>& series) const;
+    void compare(const std::string& path, const std::vector<Series>& current);
+
+    Mode mode_ = Mode::Off;
+    std::string dir_;
+    int threshold_pct_ = 5;
+    std::string env_;
+    std::string env_hash_;
+
+    std::mutex mtx_;
+    std::map<std::string, std::vector<Series>> recorded_;   // record：本次运行按文件累计的每轮中位数
+    std::map<std::string, std::vector<Series>> current_;    // compare：同上，finish 时统一检验
+    int compared_ = 0;
+    int regressions_ = 0;
+    int missing_ = 0;
+};
@@ -152,5 +152,18 @@ void MetricsReport::generateSummary() const {
         // --- 新增结束 ---
 
         Logger::getInstance().logAndPrint(oss.str());
+
+        // 每线程 CPU 归因 (按峰值降序，只列出最繁忙的若干线程)
+        if (!end.thread_cpu_usage.empty()) {
+            const size_t max_threads = 8;
+            std::ostringstream toss;
+            toss << std::fixed << std::setprecision(1) << "    线程 CPU (单核%): ";
+            for (size_t i = 0; i < end.thread_cpu_usage.size() && i < max_threads; ++i) {
+                const auto& t = end.thread_cpu_usage[i];
+                if (i > 0) toss << " | ";
+                toss << t.role << "(" << t.tid << ") 峰值 " << t.peak_percent << "% 当前 " << t.usage_percent << "%";
+            }
+            Logger::getInstance().logAndPrint(toss.str());
+        }
     }
 }
\ No newline at end of file
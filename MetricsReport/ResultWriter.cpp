@@ -0,0 +1,267 @@
+﻿// ResultWriter.cpp
+#include "ResultWriter.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>      // _commit, _fileno
+#else
+#include <unistd.h>  // fsync, fileno
+#endif
+
+namespace {
+
+    const char* kCsvHeader =
+        "timestamp,config,type,dpf_qos,dp_qos,writer_qos,reader_qos,round,role,"
+        "payload_bytes,min_size,max_size,send_count,entity_mode,setup_ms,sent,received,lost,loss_rate_pct,duration_ms,time_to_match_ms,"
+        "msgs_per_sec,mb_per_sec,latency_count,latency_min_us,latency_mean_us,latency_p50_us,"
+        "latency_p90_us,latency_p99_us,latency_p999_us,latency_max_us,"
+        "cpu_peak_pct,cpu_avg_pct,mem_peak_kb,mem_current_kb,working_set_peak_kb,intervals\n";
+
+    // 文件名中不允许出现的字符统一替换为 '-'
+    std::string sanitizeFileName(std::string name) {
+        const std::string csv_ext = ".csv";
+        if (name.size() >= csv_ext.size() &&
+            name.compare(name.size() - csv_ext.size(), csv_ext.size(), csv_ext) == 0) {
+            name.erase(name.size() - csv_ext.size());
+        }
+        for (char& ch : name) {
+            if (ch == ':' || ch == '\\' || ch == '/' || ch == '*' || ch == '?' ||
+                ch == '"' || ch == '<' || ch == '>' || ch == '|') {
+                ch = '-';
+            }
+        }
+        return name.empty() ? std::string("result") : name;
+    }
+
+    std::string csvField(const std::string& value) {
+        if (value.find_first_of(",\"\r\n") == std::string::npos) {
+            return value;
+        }
+        std::string quoted = "\"";
+        for (char ch : value) {
+            if (ch == '"') quoted += '"';
+            quoted += ch;
+        }
+        quoted += '"';
+        return quoted;
+    }
+
+    std::string jsonString(const std::string& value) {
+        std::ostringstream oss;
+        oss << '"';
+        for (unsigned char ch : value) {
+            switch (ch) {
+            case '"':  oss << "\\\""; break;
+            case '\\': oss << "\\\\"; break;
+            case '\n': oss << "\\n"; break;
+            case '\r': oss << "\\r"; break;
+            case '\t': oss << "\\t"; break;
+            default:
+                if (ch < 0x20) {
+                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(ch)
+                        << std::dec << std::setfill(' ');
+                }
+                else {
+                    oss << ch;
+                }
+            }
+        }
+        oss << '"';
+        return oss.str();
+    }
+
+    // ISO 8601 本地时间，精确到毫秒
+    std::string isoTimestamp() {
+        const auto now = std::chrono::system_clock::now();
+        const auto time_t = std::chrono::system_clock::to_time_t(now);
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+        tm tm;
+#ifdef _WIN32
+        localtime_s(&tm, &time_t);
+#else
+        localtime_r(&time_t, &tm);
+#endif
+        std::ostringstream oss;
+        oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S") << '.' << std::setw(3) << std::setfill('0') << ms;
+        return oss.str();
+    }
+
+    // SDL 检查下 MSVC 禁用 fopen，Windows 使用 fopen_s
+    FILE* openAppend(const std::string& path) {
+#ifdef _WIN32
+        FILE* file = nullptr;
+        return fopen_s(&file, path.c_str(), "ab") == 0 ? file : nullptr;
+#else
+        return std::fopen(path.c_str(), "ab");
+#endif
+    }
+
+    double cpuAverage(const std::vector<float>& history) {
+        if (history.empty()) return -1.0;
+        return std::accumulate(history.begin(), history.end(), 0.0) / history.size();
+    }
+
+} // namespace
+
+ResultWriter::~ResultWriter() {
+    close();
+}
+
+bool ResultWriter::open(const std::string& dir, const std::string& result_name) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (csv_ || jsonl_) return true;
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        Logger::getInstance().logAndPrint("[ResultWriter] 警告：无法创建结果目录 " + dir + " (" + ec.message() + ")，不写结果文件");
+        return false;
+    }
+
+    const std::filesystem::path base = std::filesystem::path(dir) / sanitizeFileName(result_name);
+    csv_path_ = base.string() + ".csv";
+    jsonl_path_ = base.string() + ".jsonl";
+
+    const bool csv_empty = !std::filesystem::exists(csv_path_, ec) || std::filesystem::file_size(csv_path_, ec) == 0;
+    csv_ = openAppend(csv_path_);
+    jsonl_ = openAppend(jsonl_path_);
+    if (!csv_ || !jsonl_) {
+        Logger::getInstance().logAndPrint("[ResultWriter] 警告：无法打开结果文件 " + base.string() + ".csv/.jsonl，不写结果文件");
+        if (csv_) std::fclose(csv_);
+        if (jsonl_) std::fclose(jsonl_);
+        csv_ = jsonl_ = nullptr;
+        return false;
+    }
+    if (csv_empty) {
+        writeDurable(csv_, kCsvHeader);
+    }
+
+    Logger::getInstance().logAndPrint("[ResultWriter] 结果文件: " + csv_path_ + " | " + jsonl_path_);
+    return true;
+}
+
+void ResultWriter::setContext(const ResultContext& context) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    context_ = context;
+}
+
+void ResultWriter::append(const TestRoundResult& result) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!csv_ || !jsonl_) return;
+
+    const std::string timestamp = isoTimestamp();
+    writeDurable(csv_, csvRow(result, timestamp));
+    writeDurable(jsonl_, jsonLine(result, timestamp));
+}
+
+void ResultWriter::close() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (csv_) std::fclose(csv_);
+    if (jsonl_) std::fclose(jsonl_);
+    csv_ = jsonl_ = nullptr;
+}
+
+std::string ResultWriter::csvRow(const TestRoundResult& result, const std::string& timestamp) const {
+    const RoundPerformance& p = result.perf;
+    const SysMetrics& m = result.end_metrics;
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3)
+        << timestamp << ','
+        << csvField(context_.config_name) << ',' << csvField(context_.type_name) << ','
+        << csvField(context_.dpf_qos) << ',' << csvField(context_.dp_qos) << ','
+        << csvField(context_.writer_qos) << ',' << csvField(context_.reader_qos) << ','
+        << result.round_index << ',' << csvField(p.role) << ','
+        << p.payload_bytes << ',' << context_.min_size << ',' << context_.max_size << ',' << context_.send_count << ','
+        << (context_.persistent_entities ? "persistent" : "recreate") << ',' << context_.setup_ms << ','
+        << p.sent << ',' << p.received << ',' << p.lost << ',' << p.loss_rate_percent << ',' << p.duration_ms << ',' << p.time_to_match_ms << ','
+        << p.msgs_per_sec << ',' << p.mb_per_sec << ','
+        << p.latency_count << ',' << p.latency_min_us << ',' << p.latency_mean_us << ','
+        << p.latency_p50_us << ',' << p.latency_p90_us << ',' << p.latency_p99_us << ','
+        << p.latency_p999_us << ',' << p.latency_max_us << ','
+        << m.cpu_usage_percent_peak << ',' << cpuAverage(result.cpu_usage_history) << ','
+        << m.memory_peak_kb << ',' << m.memory_current_kb << ',' << m.system_peak_working_set_kb << ','
+        << result.intervals.size() << '\n';
+    return oss.str();
+}
+
+std::string ResultWriter::jsonLine(const TestRoundResult& result, const std::string& timestamp) const {
+    const RoundPerformance& p = result.perf;
+    const SysMetrics& m = result.end_metrics;
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3)
+        << "{\"timestamp\":" << jsonString(timestamp)
+        << ",\"config\":" << jsonString(context_.config_name)
+        << ",\"type\":" << jsonString(context_.type_name)
+        << ",\"qos\":{\"dpf\":" << jsonString(context_.dpf_qos)
+        << ",\"dp\":" << jsonString(context_.dp_qos)
+        << ",\"writer\":" << jsonString(context_.writer_qos)
+        << ",\"reader\":" << jsonString(context_.reader_qos) << "}"
+        << ",\"round\":" << result.round_index
+        << ",\"role\":" << jsonString(p.role)
+        << ",\"payload_bytes\":" << p.payload_bytes
+        << ",\"min_size\":" << context_.min_size
+        << ",\"max_size\":" << context_.max_size
+        << ",\"send_count\":" << context_.send_count
+        << ",\"entity_mode\":" << jsonString(context_.persistent_entities ? "persistent" : "recreate")
+        << ",\"setup_ms\":" << context_.setup_ms
+        << ",\"sent\":" << p.sent
+        << ",\"received\":" << p.received
+        << ",\"lost\":" << p.lost
+        << ",\"loss_rate_pct\":" << p.loss_rate_percent
+        << ",\"duration_ms\":" << p.duration_ms
+        << ",\"time_to_match_ms\":" << p.time_to_match_ms
+        << ",\"msgs_per_sec\":" << p.msgs_per_sec
+        << ",\"mb_per_sec\":" << p.mb_per_sec
+        << ",\"latency_us\":{\"count\":" << p.latency_count
+        << ",\"min\":" << p.latency_min_us
+        << ",\"mean\":" << p.latency_mean_us
+        << ",\"p50\":" << p.latency_p50_us
+        << ",\"p90\":" << p.latency_p90_us
+        << ",\"p99\":" << p.latency_p99_us
+        << ",\"p999\":" << p.latency_p999_us
+        << ",\"max\":" << p.latency_max_us << "}"
+        << ",\"cpu_peak_pct\":" << m.cpu_usage_percent_peak
+        << ",\"cpu_avg_pct\":" << cpuAverage(result.cpu_usage_history)
+        << ",\"mem_peak_kb\":" << m.memory_peak_kb
+        << ",\"mem_current_kb\":" << m.memory_current_kb
+        << ",\"working_set_peak_kb\":" << m.system_peak_working_set_kb
+        << ",\"intervals\":[";
+    for (size_t i = 0; i < result.intervals.size(); ++i) {
+        const IntervalSample& s = result.intervals[i];
+        oss << (i ? "," : "")
+            << "{\"t_ms\":" << s.elapsed_ms
+            << ",\"msgs\":" << s.messages
+            << ",\"msgs_per_sec\":" << s.msgs_per_sec
+            << ",\"mb_per_sec\":" << s.mb_per_sec
+            << ",\"lost\":" << s.lost
+            << ",\"lat_count\":" << s.latency_count
+            << ",\"lat_p50_us\":" << s.latency_p50_us
+            << ",\"lat_p99_us\":" << s.latency_p99_us
+            << ",\"lat_max_us\":" << s.latency_max_us
+            << ",\"cpu_pct\":" << s.cpu_percent
+            << ",\"mem_kb\":" << s.memory_kb << "}";
+    }
+    oss << "]}\n";
+    return oss.str();
+}
+
+void ResultWriter::writeDurable(FILE* file, const std::string& text) {
+    if (std::fwrite(text.data(), 1, text.size(), file) != text.size()) {
+        Logger::getInstance().error("[ResultWriter] 写入结果文件失败");
+        return;
+    }
+    std::fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
@@ -0,0 +1,70 @@
+﻿// ResultWriter.h
+#pragma once
+
+#include "TestRoundResult.h"
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+// 写入结果文件时附带的本轮配置信息（由 Main 在每轮开始前设置）
+struct ResultContext {
+    std::string config_name;
+    std::string type_name;
+    std::string dpf_qos;
+    std::string dp_qos;
+    std::string writer_qos;
+    std::string reader_qos;
+    int send_count = 0;
+    int min_size = 0;
+    int max_size = 0;
+    bool persistent_entities = false;   // 实体跨轮复用（m_persistentEntities）
+    double setup_ms = 0.0;              // 本轮准备耗时：上一轮清理 + 初始化 + 等待匹配
+};
+
+/**
+ * @brief 机器可读的结果文件写入器：每轮一行，同时写 CSV 与 JSON Lines。
+ *
+ * 文件位于 <结果目录>/<m_resultPath 去掉 .csv 后缀>.csv / .jsonl，以追加方式打开，
+ * CSV 文件为空时先写表头。每行写完后 flush 并落盘（Windows _commit / POSIX fsync），
+ * 进程中途退出时已完成的轮次不会丢失。JSONL 行额外包含区间采样序列。
+ * 打开失败时只记录警告，后续 append 为空操作，不影响测试本身。
+ */
+class ResultWriter {
+public:
+    ResultWriter() = default;
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    /**
+     * @brief 创建结果目录并打开两个结果文件
+     * @param dir 结果目录（GlobalConfig::DEFAULT_RESULT_PATH）
+     * @param result_name 配置生成的结果文件名（ConfigData::m_resultPath）
+     */
+    bool open(const std::string& dir, const std::string& result_name);
+
+    bool isOpen() const { return csv_ != nullptr || jsonl_ != nullptr; }
+
+    void setContext(const ResultContext& context);
+
+    /**
+     * @brief 追加一轮结果（线程安全）
+     */
+    void append(const TestRoundResult& result);
+
+    void close();
+
+private:
+    std::string csvRow(const TestRoundResult& result, const std::string& timestamp) const;
+    std::string jsonLine(const TestRoundResult& result, const std::string& timestamp) const;
+    static void writeDurable(FILE* file, const std::string& text);
+
+    mutable std::mutex mtx_;
+    ResultContext context_;
+    FILE* csv_ = nullptr;
+    FILE* jsonl_ = nullptr;
+    std::string csv_path_;
+    std::string jsonl_path_;
+};
@@ -0,0 +1,266 @@
+﻿// RealtimeProfile.cpp
+#include "RealtimeProfile.h"
+#include "Logger.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace {
+    constexpr size_t kPageSize = 4096;
+    constexpr size_t kStackPrefaultBytes = 64 * 1024;   // 每个实时线程预触碰的栈空间
+
+    std::string cpuListToString(const std::vector<int>& cpus) {
+        std::ostringstream oss;
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            if (i > 0) oss << ",";
+            oss << cpus[i];
+        }
+        return oss.str();
+    }
+
+    // 写触碰当前线程的栈，避免实时线程在热路径上首次触碰新栈页
+    void prefaultStack() {
+        unsigned char stack[kStackPrefaultBytes];
+        std::memset(stack, 0, sizeof(stack));
+        // 经 volatile 指针逐页读回，编译器不能省去上面的写入
+        const volatile unsigned char* pages = stack;
+        unsigned char sink = 0;
+        for (size_t i = 0; i < kStackPrefaultBytes; i += kPageSize) {
+            sink |= pages[i];
+        }
+        (void)sink;
+    }
+}
+
+RealtimeProfile& RealtimeProfile::instance() {
+    static RealtimeProfile profile;
+    return profile;
+}
+
+bool RealtimeProfile::configure(const std::string& affinity_spec, int rt_priority, bool lock_memory, bool prefault) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (configured_) {
+        if (affinity_spec != affinity_spec_ || std::max(rt_priority, 0) != rt_priority_ ||
+            lock_memory != lock_memory_ || prefault != prefault_) {
+            Logger::getInstance().logAndPrint("[RealtimeProfile] 实时配置每进程只生效一次，"
+                "已登记的线程不会重新应用，忽略本配置的设置并沿用首次设置");
+        }
+        return false;
+    }
+    configured_ = true;
+    affinity_spec_ = affinity_spec;
+    rules_.clear();
+    if (!affinity_spec.empty() && !parseAffinitySpec(affinity_spec, rules_)) {
+        Logger::getInstance().logAndPrint("[RealtimeProfile] 绑核规则无法解析，已忽略: " + affinity_spec);
+        rules_.clear();
+    }
+    rt_priority_ = std::max(rt_priority, 0);
+    lock_memory_ = lock_memory;
+    prefault_ = prefault;
+    return true;
+}
+
+bool RealtimeProfile::parseAffinitySpec(const std::string& spec, std::vector<AffinityRule>& rules) {
+    std::istringstream entries(spec);
+    std::string entry;
+    while (std::getline(entries, entry, ';')) {
+        entry.erase(0, entry.find_first_not_of(" \t"));
+        entry.erase(entry.find_last_not_of(" \t") + 1);
+        if (entry.empty()) continue;
+
+        const size_t colon = entry.find(':');
+        if (colon == std::string::npos || colon == 0) return false;
+
+        AffinityRule rule;
+        rule.role_prefix = entry.substr(0, colon);
+        std::istringstream items(entry.substr(colon + 1));
+        std::string item;
+        while (std::getline(items, item, ',')) {
+            try {
+                const size_t dash = item.find('-');
+                if (dash == std::string::npos) {
+                    rule.cpus.push_back(std::stoi(item));
+                }
+                else {
+                    const int first = std::stoi(item.substr(0, dash));
+                    const int last = std::stoi(item.substr(dash + 1));
+                    for (int cpu = first; cpu <= last; ++cpu) {
+                        rule.cpus.push_back(cpu);
+                    }
+                }
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        }
+        if (rule.cpus.empty()) return false;
+        rules.push_back(std::move(rule));
+    }
+    return true;
+}
+
+const RealtimeProfile::AffinityRule* RealtimeProfile::findRule(const std::string& role) const {
+    for (const auto& rule : rules_) {
+        if (role.compare(0, rule.role_prefix.size(), rule.role_prefix) == 0) {
+            return &rule;
+        }
+    }
+    return nullptr;
+}
+
+bool RealtimeProfile::isHotPathRole(const std::string& role) {
+    // dds_poller 精确匹配：忙轮询线程（dds_poller_spin）不提升优先级
+    return role.rfind("sender", 0) == 0 || role == "dds_listener" || role == "dds_poller";
+}
+
+void RealtimeProfile::applyToCurrentThread(const std::string& role) {
+#ifdef _WIN32
+    // GetCurrentThread() 为伪句柄，仅在本线程内有效
+    applyToThread(GetCurrentThread(), role);
+#else
+    applyToThread(pthread_self(), role);
+#endif
+    if (prefault_ && isHotPathRole(role)) {
+        prefaultStack();
+    }
+}
+
+void RealtimeProfile::applyToThread(std::thread::native_handle_type handle, const std::string& role) {
+    if (handle == std::thread::native_handle_type{}) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    const AffinityRule* rule = findRule(role);
+    const bool want_priority = rt_priority_ > 0 && isHotPathRole(role);
+    if (!rule && !want_priority) {
+        return;
+    }
+
+    std::ostringstream oss;
+    oss << "[RealtimeProfile] 线程 " << role;
+
+#ifdef _WIN32
+    HANDLE thread = reinterpret_cast<HANDLE>(handle);
+    if (rule) {
+        DWORD_PTR mask = 0;
+        for (int cpu : rule->cpus) {
+            if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+                mask |= (static_cast<DWORD_PTR>(1) << cpu);
+            }
+        }
+        if (mask != 0 && SetThreadAffinityMask(thread, mask) != 0) {
+            oss << " | CPU {" << cpuListToString(rule->cpus) << "}";
+        }
+        else {
+            oss << " | 绑核失败 (错误码 " << GetLastError() << ")";
+        }
+    }
+    if (want_priority) {
+        if (SetThreadPriority(thread, THREAD_PRIORITY_TIME_CRITICAL)) {
+            oss << " | THREAD_PRIORITY_TIME_CRITICAL";
+        }
+        else {
+            oss << " | 设置优先级失败 (错误码 " << GetLastError() << ")";
+        }
+    }
+#else
+    pthread_t thread = static_cast<pthread_t>(handle);
+    if (rule) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : rule->cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        const int rc = pthread_setaffinity_np(thread, sizeof(set), &set);
+        if (rc == 0) {
+            oss << " | CPU {" << cpuListToString(rule->cpus) << "}";
+        }
+        else {
+            oss << " | 绑核失败: " << std::strerror(rc);
+        }
+    }
+    if (want_priority) {
+        sched_param param{};
+        param.sched_priority = std::min(rt_priority_, sched_get_priority_max(SCHED_FIFO));
+        const int rc = pthread_setschedparam(thread, SCHED_FIFO, &param);
+        if (rc == 0) {
+            oss << " | SCHED_FIFO " << param.sched_priority;
+        }
+        else {
+            oss << " | 设置 SCHED_FIFO 失败: " << std::strerror(rc);
+        }
+    }
+#endif
+    Logger::getInstance().logAndPrint(oss.str());
+}
+
+void RealtimeProfile::lockProcessMemory() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!lock_memory_ || memory_locked_) {
+        return;
+    }
+#ifdef _WIN32
+    // Windows 无 mlockall：提高工作集下限，降低测试期间页面被换出的概率
+    SIZE_T min_ws = 0;
+    SIZE_T max_ws = 0;
+    HANDLE process = GetCurrentProcess();
+    if (GetProcessWorkingSetSize(process, &min_ws, &max_ws)) {
+        const SIZE_T target = static_cast<SIZE_T>(512) * 1024 * 1024;
+        if (SetProcessWorkingSetSize(process, std::max(min_ws, target), std::max(max_ws, target * 2))) {
+            memory_locked_ = true;
+            Logger::getInstance().logAndPrint("[RealtimeProfile] 已提高进程工作集下限至 512 MB");
+            return;
+        }
+    }
+    Logger::getInstance().logAndPrint("[RealtimeProfile] 提高工作集下限失败 (错误码 " + std::to_string(GetLastError()) + ")");
+#else
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+        memory_locked_ = true;
+        Logger::getInstance().logAndPrint("[RealtimeProfile] mlockall(MCL_CURRENT | MCL_FUTURE) 成功");
+    }
+    else {
+        Logger::getInstance().logAndPrint("[RealtimeProfile] mlockall 失败: " + std::string(std::strerror(errno)));
+    }
+#endif
+}
+
+void RealtimeProfile::prefault(void* buffer, size_t size) const {
+    if (!prefault_ || !buffer || size == 0) {
+        return;
+    }
+    volatile unsigned char* bytes = static_cast<volatile unsigned char*>(buffer);
+    for (size_t i = 0; i < size; i += kPageSize) {
+        bytes[i] = bytes[i];
+    }
+    bytes[size - 1] = bytes[size - 1];
+}
+
+std::string RealtimeProfile::describe() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::ostringstream oss;
+    oss << "[RealtimeProfile] 绑核: ";
+    if (rules_.empty()) {
+        oss << "无";
+    }
+    for (size_t i = 0; i < rules_.size(); ++i) {
+        if (i > 0) oss << "; ";
+        oss << rules_[i].role_prefix << " -> {" << cpuListToString(rules_[i].cpus) << "}";
+    }
+    oss << " | 实时优先级: " << (rt_priority_ > 0 ? std::to_string(rt_priority_) : "关闭")
+        << " | 锁定内存: " << (lock_memory_ ? "是" : "否")
+        << " | 预缺页: " << (prefault_ ? "是" : "否");
+    return oss.str();
+}
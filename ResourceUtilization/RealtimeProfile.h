@@ -0,0 +1,87 @@
+﻿// RealtimeProfile.h
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 实时执行配置（单例）：按线程角色绑核、可选实时调度优先级、锁定内存与缓冲区预缺页。
+ *
+ * 绑核规则字符串格式为 "角色:CPU列表;角色:CPU列表"，CPU 列表支持逗号与区间，例如
+ * "sender:2;dds_listener:3;logger:0;resource_sampler:1" 或 "sender:2-5"。
+ * 角色按前缀匹配（"sender" 同时匹配 "sender_0"、"sender_1" ...），未列出的角色不做处理。
+ *
+ * 实时优先级只作用于热路径角色（sender*、dds_listener、dds_poller），日志与采样线程保持普通调度以免抢占。
+ * 忙轮询的接收线程登记为 dds_poller_spin：绑核按前缀仍匹配 "dds_poller"，但不提升优先级，
+ * 否则 SCHED_FIFO 下 yield 不会让出 CPU，同核的 DDS 传输线程会被饿死。
+ * Linux 使用 SCHED_FIFO（需 CAP_SYS_NICE）与 mlockall；Windows 使用 THREAD_PRIORITY_TIME_CRITICAL，
+ * 内存锁定以提高进程工作集下限近似。所有失败只记录告警，不影响测试继续运行。
+ *
+ * 线程通过 ResourceUtilization::registerCurrentThread() 登记角色时自动应用；
+ * 日志写入线程由 Main 通过 applyToThread() 按句柄设置。
+ * 已登记的线程（DDS 内部线程、日志线程）跨配置存活，不会重新应用，因此配置每进程只生效一次。
+ */
+class RealtimeProfile {
+public:
+    static RealtimeProfile& instance();
+
+    /**
+     * @brief 设置本进程的实时配置（应在创建工作线程前调用）；只有首次调用生效，
+     * 之后的调用若与首次设置不同只记录告警（suite 模式沿用第一个配置的实时设置）
+     * @param affinity_spec 绑核规则，为空表示不绑核
+     * @param rt_priority 实时优先级（Linux 1-99），0 表示不修改调度策略
+     * @param lock_memory 是否锁定进程内存
+     * @param prefault 是否对负载缓冲区与线程栈预缺页
+     * @return 本次调用生效返回 true
+     */
+    bool configure(const std::string& affinity_spec, int rt_priority, bool lock_memory, bool prefault);
+
+    bool enabled() const { return !rules_.empty() || rt_priority_ > 0 || lock_memory_ || prefault_; }
+    bool prefaultEnabled() const { return prefault_; }
+
+    /**
+     * @brief 对调用线程应用该角色的绑核与优先级（prefault 开启时同时预触碰栈）
+     */
+    void applyToCurrentThread(const std::string& role);
+
+    /**
+     * @brief 对指定线程应用该角色的绑核与优先级
+     */
+    void applyToThread(std::thread::native_handle_type handle, const std::string& role);
+
+    /**
+     * @brief 锁定进程当前及后续分配的内存（未开启 lock_memory 时不做处理）
+     */
+    void lockProcessMemory();
+
+    /**
+     * @brief 逐页写触碰缓冲区，使缺页发生在测试开始前（未开启 prefault 时不做处理）
+     */
+    void prefault(void* buffer, size_t size) const;
+
+    std::string describe() const;
+
+private:
+    RealtimeProfile() = default;
+
+    struct AffinityRule {
+        std::string role_prefix;
+        std::vector<int> cpus;
+    };
+
+    static bool parseAffinitySpec(const std::string& spec, std::vector<AffinityRule>& rules);
+    const AffinityRule* findRule(const std::string& role) const;
+    static bool isHotPathRole(const std::string& role);
+
+    bool configured_ = false;
+    std::string affinity_spec_;     // 首次 configure 的原始规则，用于比较后续调用
+    std::vector<AffinityRule> rules_;
+    int rt_priority_ = 0;
+    bool lock_memory_ = false;
+    bool prefault_ = false;
+    bool memory_locked_ = false;
+    mutable std::mutex mtx_;
+};
@@ -1,6 +1,7 @@
 ﻿#include "ResourceUtilization.h"
 #include "GloMemPool.h" // 用于获取内存 stats
 #include "Logger.h"     // 用于输出调试日志
+#include "RealtimeProfile.h" // 按线程角色绑核 / 设置优先级
 
 // Windows 平台特定头文件
 #ifdef _WIN32
@@ -9,20 +10,43 @@
 #include <psapi.h> // 包含 GetProcessMemoryInfo 所需的头文件
 #pragma comment(lib, "psapi.lib") // 链接 psapi.lib 库
 // --- 新增结束 ---
-#include <sstream>      // 用于格式化错误信息
-#include <chrono>       // 用于时间间隔控制
-#include <thread>       // 用于后台采样线程
-#include <atomic>       // 用于线程安全的峰值存储
-#include <algorithm>    // 用于 std::max
-#include <string>       // for std::string, needed for WideCharToMultiByte conversion
 // --- 新增：PDH 头文件 ---
 #include <pdh.h>
 #include <pdhmsg.h>
 #pragma comment(lib, "pdh.lib")
 // --- 新增结束 ---
+#else
+// Linux 平台：基于 /proc 文件系统采样
+#include <fstream>
+#include <filesystem>
+#include <unistd.h>      // sysconf, getpid
+#include <sys/syscall.h> // SYS_gettid
 #endif
 
-#include <vector> // 确保包含 vector
+#include <sstream>       // 用于格式化错误信息
+#include <chrono>        // 用于时间间隔控制
+#include <thread>        // 用于后台采样线程
+#include <atomic>        // 用于线程安全的峰值存储
+#include <algorithm>     // 用于 std::max
+#include <string>        // for std::string, needed for WideCharToMultiByte conversion
+#include <mutex>         // 保护每线程/每核心采样状态
+#include <unordered_map> // tid -> 角色 / 使用率
+#include <vector>        // 确保包含 vector
+
+namespace {
+    // 获取调用线程的系统线程 ID
+    int current_thread_id() {
+#ifdef _WIN32
+        return static_cast<int>(GetCurrentThreadId());
+#else
+        return static_cast<int>(syscall(SYS_gettid));
+#endif
+    }
+
+    // 每个线程采样窗口包含的 CPU 采样次数 (20ms * 10 = 200ms)
+    // 线程级 tick 分辨率较粗 (通常 10ms)，窗口过短会导致使用率抖动
+    constexpr int kThreadSampleEvery = 10;
+}
 
 // -----------------------------
 // Implementation (Pimpl)
@@ -103,8 +127,38 @@ public:
         return true;
 
 #else
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Error: GetProcessTimes method not supported on non-Windows.");
-        return false;
+        pid_ = static_cast<DWORD>(getpid());
+        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Current Process ID: " + std::to_string(pid_));
+
+        clk_tck_ = sysconf(_SC_CLK_TCK);
+        if (clk_tck_ <= 0) {
+            clk_tck_ = 100; // 绝大多数内核的默认 USER_HZ
+        }
+
+        // 初始化时读取一次，检查 /proc 可用性
+        ProcCpuTimes dummy_sys;
+        unsigned long long dummy_proc = 0;
+        if (!read_proc_stat(dummy_sys, nullptr) || !read_task_stat("/proc/self/stat", dummy_proc, nullptr)) {
+            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Error: Initial read of /proc/stat or /proc/self/stat failed.");
+            return false;
+        }
+
+        // --- 启动后台采样线程 ---
+        stop_sampling_ = false;
+        current_cpu_peak_ = -1.0; // 重置峰值
+        sampling_thread_ = new std::thread(&Impl::sampling_loop, this);
+        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Sampling thread started.");
+
+        if (!initialize_per_core_internal()) {
+            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Warning: Per-core monitoring initialization failed or not supported.");
+        }
+        else {
+            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Per-core monitoring initialized.");
+        }
+
+        is_initialized_ = true;
+        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Successfully initialized (/proc method).");
+        return true;
 #endif
     }
 
@@ -134,6 +188,13 @@ public:
 #ifdef _WIN32
         process_handle_ = NULL;
 #endif
+        {
+            std::lock_guard<std::mutex> lock(thread_mtx_);
+            thread_usage_.clear();
+#ifndef _WIN32
+            prev_thread_ticks_.clear();
+#endif
+        }
         Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::shutdown_internal] Shutdown complete.");
     }
 
@@ -226,8 +287,15 @@ public:
         Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Successfully initialized per-core monitoring for " + std::to_string(counters_.size()) + " cores.");
         return true;
 #else
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Per-core monitoring not implemented for non-Windows.");
-        return false;
+        std::lock_guard<std::mutex> lock(core_mtx_);
+        ProcCpuTimes aggregate;
+        prev_core_times_.clear();
+        if (!read_proc_stat(aggregate, &prev_core_times_) || prev_core_times_.empty()) {
+            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Error: No cpuN lines found in /proc/stat.");
+            return false;
+        }
+        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Successfully initialized per-core monitoring for " + std::to_string(prev_core_times_.size()) + " cores.");
+        return true;
 #endif
     }
     // --- 新增结束 ---
@@ -242,6 +310,9 @@ public:
         counters_.clear();
         counterPaths_.clear();
         Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::shutdown_per_core_internal] Per-core monitoring resources released.");
+#else
+        std::lock_guard<std::mutex> lock(core_mtx_);
+        prev_core_times_.clear();
 #endif
     }
     // --- 新增结束 ---
@@ -302,6 +373,29 @@ public:
                 coreUsages.emplace_back(errorCoreId, -1.0); // 用 -1.0 表示错误
             }
         }
+#else
+        // 与 PDH 语义一致：返回自上次调用 (或初始化) 以来每个核心的平均使用率
+        std::lock_guard<std::mutex> lock(core_mtx_);
+        ProcCpuTimes aggregate;
+        std::vector<ProcCpuTimes> cores;
+        if (!read_proc_stat(aggregate, &cores)) {
+            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Error reading /proc/stat.");
+            return coreUsages;
+        }
+
+        for (const auto& core : cores) {
+            double usage = -1.0;
+            auto prev = std::find_if(prev_core_times_.begin(), prev_core_times_.end(),
+                [&core](const ProcCpuTimes& p) { return p.id == core.id; });
+            if (prev != prev_core_times_.end() && core.total > prev->total) {
+                unsigned long long total_delta = core.total - prev->total;
+                unsigned long long idle_delta = core.idle >= prev->idle ? core.idle - prev->idle : 0;
+                usage = static_cast<double>(total_delta - std::min(idle_delta, total_delta)) /
+                    static_cast<double>(total_delta) * 100.0;
+            }
+            coreUsages.emplace_back(static_cast<DWORD>(core.id), usage);
+        }
+        prev_core_times_ = std::move(cores);
 #endif
         return coreUsages;
     }
@@ -312,9 +406,15 @@ public:
     // 在独立线程中高频采样 CPU 使用率并更新峰值
     void sampling_loop() {
         Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sampling_loop] Sampling thread started loop.");
+        {
+            std::lock_guard<std::mutex> lock(thread_mtx_);
+            thread_roles_[current_thread_id()] = "resource_sampler";
+        }
+        RealtimeProfile::instance().applyToCurrentThread("resource_sampler");
         // 定义采样间隔 (例如，每 20ms 采样一次)
         const std::chrono::milliseconds sampling_interval(20);
 
+#ifdef _WIN32
         FILETIME prev_sys_idle, prev_sys_kernel, prev_sys_user;
         FILETIME prev_proc_creation, prev_proc_exit, prev_proc_kernel, prev_proc_user;
 
@@ -371,24 +471,8 @@ public:
             // 确保结果非负
             if (cpu_usage < 0.0) cpu_usage = 0.0;
 
-            // --- 原子地更新峰值 ---
-            // 使用 std::atomic<double> 的 compare_exchange_weak 来实现无锁更新
-            double current_peak = current_cpu_peak_.load();
-            while (cpu_usage > current_peak) {
-                // 如果当前计算出的 cpu_usage 高于已记录的峰值 current_peak，
-                // 则尝试用 cpu_usage 更新 current_cpu_peak_。
-                // compare_exchange_weak 会自动处理并发情况：
-                // - 如果 current_cpu_peak_ 的值仍然是 current_peak，则更新为 cpu_usage，并返回 true。
-                // - 如果 current_cpu_peak_ 的值已经被其他线程修改（不再是 current_peak），则返回 false，
-                //   并将 current_peak 更新为 current_cpu_peak_ 的最新值，然后循环继续尝试。
-                if (current_cpu_peak_.compare_exchange_weak(current_peak, cpu_usage)) {
-                    // 成功更新峰值
-                    Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sampling_loop] New peak CPU usage: " + std::to_string(cpu_usage) + "%");
-                    break; // 跳出循环
-                }
-                // 如果 compare_exchange_weak 失败，current_peak 会被自动更新为最新的值，然后循环继续尝试
-            }
-            // --- 更新结束 ---
+            update_cpu_peak(cpu_usage);
+            record_cpu_sample(cpu_usage);
 
             // 更新 previous times 供下次迭代使用
             prev_sys_idle = sys_idle;
@@ -400,14 +484,237 @@ public:
             prev_proc_user = proc_user;
 
         } // while (!stop_sampling_)
+#else
+        ProcCpuTimes prev_sys;
+        unsigned long long prev_proc_ticks = 0;
+
+        // 获取初始时间点
+        if (!read_proc_stat(prev_sys, nullptr) || !read_task_stat("/proc/self/stat", prev_proc_ticks, nullptr)) {
+            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sampling_loop] Error: Initial read of /proc/stat or /proc/self/stat failed in sampling loop.");
+            return;
+        }
+        sample_threads(); // 建立每线程基线
+
+        int iteration = 0;
+        while (!stop_sampling_) {
+            std::this_thread::sleep_for(sampling_interval);
+
+            ProcCpuTimes sys;
+            unsigned long long proc_ticks = 0;
+            if (!read_proc_stat(sys, nullptr) || !read_task_stat("/proc/self/stat", proc_ticks, nullptr)) {
+                Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sampling_loop] Error: Reading /proc failed during sampling.");
+                continue;
+            }
+
+            // 与 Windows 实现一致：进程 CPU 时间 / 全部核心的总时间 (含 idle)
+            unsigned long long sys_total_delta = sys.total - prev_sys.total;
+            unsigned long long proc_total_delta = proc_ticks - prev_proc_ticks;
+
+            double cpu_usage = 0.0;
+            if (sys_total_delta != 0) {
+                cpu_usage = (static_cast<double>(proc_total_delta) / static_cast<double>(sys_total_delta)) * 100.0;
+            }
+            // 两个文件的 tick 更新不同步，20ms 窗口内可能出现超过 100% 的量化误差
+            cpu_usage = std::min(std::max(cpu_usage, 0.0), 100.0);
+
+            update_cpu_peak(cpu_usage);
+            record_cpu_sample(cpu_usage);
+
+            prev_sys = sys;
+            prev_proc_ticks = proc_ticks;
+
+            if (++iteration % kThreadSampleEvery == 0) {
+                sample_threads();
+            }
+        }
+#endif
         Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sampling_loop] Sampling thread exiting loop.");
     }
     // --- 新增结束 ---
 
+    // 原子地更新峰值
+    // 使用 std::atomic<double> 的 compare_exchange_weak 来实现无锁更新：
+    // 若 current_cpu_peak_ 已被其他线程修改，current_peak 会被刷新为最新值后重试
+    void update_cpu_peak(double cpu_usage) {
+        double current_peak = current_cpu_peak_.load();
+        while (cpu_usage > current_peak) {
+            if (current_cpu_peak_.compare_exchange_weak(current_peak, cpu_usage)) {
+                ZR_LOG_DEBUG("ResourceUtilization", "[ResourceUtilization::Impl::sampling_loop] New peak CPU usage: " << cpu_usage << "%");
+                break;
+            }
+        }
+    }
+
+    // 保存最近一次采样值；处于记录状态时追加到本轮历史中
+    void record_cpu_sample(double cpu_usage) {
+        last_cpu_usage_.store(cpu_usage, std::memory_order_relaxed);
+        if (recording_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(history_mtx_);
+            cpu_history_.push_back(static_cast<float>(cpu_usage));
+        }
+    }
+
+    void start_recording() {
+        std::lock_guard<std::mutex> lock(history_mtx_);
+        cpu_history_.clear();
+        recording_.store(true, std::memory_order_release);
+    }
+
+    std::vector<float> stop_recording() {
+        recording_.store(false, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(history_mtx_);
+        std::vector<float> history;
+        history.swap(cpu_history_);
+        return history;
+    }
+
+    double last_cpu_usage() const {
+        return last_cpu_usage_.load(std::memory_order_relaxed);
+    }
+
+    // 登记调用线程的角色
+    void register_thread_role(const std::string& role) {
+        std::lock_guard<std::mutex> lock(thread_mtx_);
+        thread_roles_[current_thread_id()] = role;
+    }
+
+    // 获取每线程使用率快照 (按峰值降序)，reset_peak 为 true 时开始新的峰值统计周期
+    std::vector<ThreadCpuUsage> get_per_thread_usage_internal(bool reset_peak) {
+        std::vector<ThreadCpuUsage> result;
+        {
+            std::lock_guard<std::mutex> lock(thread_mtx_);
+            result.reserve(thread_usage_.size());
+            for (auto& kv : thread_usage_) {
+                result.push_back(kv.second);
+                if (reset_peak) {
+                    kv.second.peak_percent = kv.second.usage_percent;
+                }
+            }
+        }
+        std::sort(result.begin(), result.end(), [](const ThreadCpuUsage& a, const ThreadCpuUsage& b) {
+            return a.peak_percent > b.peak_percent;
+        });
+        return result;
+    }
+
+#ifndef _WIN32
+    // /proc/stat 中一行 cpu 统计 (单位: clock tick)
+    struct ProcCpuTimes {
+        int id = -1;                  // 核心编号，汇总行为 -1
+        unsigned long long total = 0; // user + nice + system + idle + iowait + irq + softirq + steal
+        unsigned long long idle = 0;  // idle + iowait
+    };
+
+    // 读取 /proc/stat：aggregate 为汇总行，per_core 非空时追加每个 cpuN 行
+    static bool read_proc_stat(ProcCpuTimes& aggregate, std::vector<ProcCpuTimes>* per_core) {
+        std::ifstream in("/proc/stat");
+        if (!in.is_open()) return false;
+
+        bool found = false;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.compare(0, 3, "cpu") != 0) break; // cpu 行总位于文件开头
+
+            std::istringstream iss(line);
+            std::string label;
+            iss >> label;
+            unsigned long long v[8] = { 0 };
+            for (int i = 0; i < 8 && (iss >> v[i]); ++i) {}
+
+            ProcCpuTimes t;
+            t.idle = v[3] + v[4];
+            for (unsigned long long x : v) t.total += x;
+
+            if (label == "cpu") {
+                aggregate = t;
+                found = true;
+            }
+            else if (per_core) {
+                t.id = std::atoi(label.c_str() + 3);
+                per_core->push_back(t);
+            }
+        }
+        return found;
+    }
+
+    // 读取 /proc/.../stat 中的 utime + stime (clock tick)，comm 非空时输出线程名
+    static bool read_task_stat(const std::string& path, unsigned long long& ticks, std::string* comm) {
+        std::ifstream in(path);
+        std::string content;
+        if (!in.is_open() || !std::getline(in, content)) return false;
+
+        // comm 字段可能包含空格和括号，以最后一个 ')' 为界
+        size_t lp = content.find('(');
+        size_t rp = content.rfind(')');
+        if (lp == std::string::npos || rp == std::string::npos || rp < lp || rp + 2 > content.size()) return false;
+        if (comm) *comm = content.substr(lp + 1, rp - lp - 1);
+
+        // ')' 之后从第 3 个字段 (state) 开始，utime / stime 为第 14 / 15 个字段
+        std::istringstream iss(content.substr(rp + 2));
+        std::string field;
+        unsigned long long utime = 0, stime = 0;
+        for (int idx = 3; idx <= 15 && (iss >> field); ++idx) {
+            if (idx == 14) utime = std::stoull(field);
+            if (idx == 15) stime = std::stoull(field);
+        }
+        ticks = utime + stime;
+        return true;
+    }
+
+    // 遍历 /proc/self/task，计算每个线程在上一窗口内的单核使用率
+    void sample_threads() {
+        auto now = std::chrono::steady_clock::now();
+        double window_ticks = std::chrono::duration<double>(now - last_thread_sample_).count() * static_cast<double>(clk_tck_);
+
+        std::unordered_map<int, std::pair<unsigned long long, std::string>> current;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator("/proc/self/task", ec)) {
+            int tid = std::atoi(entry.path().filename().string().c_str());
+            unsigned long long ticks = 0;
+            std::string comm;
+            if (tid <= 0 || !read_task_stat((entry.path() / "stat").string(), ticks, &comm)) continue;
+            current.emplace(tid, std::make_pair(ticks, std::move(comm)));
+        }
+        if (ec) {
+            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sample_threads] Error iterating /proc/self/task: " + ec.message());
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(thread_mtx_);
+        for (const auto& kv : current) {
+            const int tid = kv.first;
+            ThreadCpuUsage& u = thread_usage_[tid];
+            u.tid = tid;
+            auto role_it = thread_roles_.find(tid);
+            u.role = (role_it != thread_roles_.end()) ? role_it->second : kv.second.second;
+
+            auto prev_it = prev_thread_ticks_.find(tid);
+            if (prev_it != prev_thread_ticks_.end() && window_ticks > 0.0 && kv.second.first >= prev_it->second) {
+                u.usage_percent = static_cast<double>(kv.second.first - prev_it->second) / window_ticks * 100.0;
+                u.peak_percent = std::max(u.peak_percent, u.usage_percent);
+            }
+        }
+
+        // 清理已退出的线程
+        for (auto it = thread_usage_.begin(); it != thread_usage_.end();) {
+            if (current.find(it->first) == current.end()) it = thread_usage_.erase(it);
+            else ++it;
+        }
+        // 仅清理上个窗口存在、本窗口消失的线程的登记，避免误删刚登记的新线程
+        for (const auto& kv : prev_thread_ticks_) {
+            if (current.find(kv.first) == current.end()) thread_roles_.erase(kv.first);
+        }
+
+        prev_thread_ticks_.clear();
+        for (const auto& kv : current) prev_thread_ticks_[kv.first] = kv.second.first;
+        last_thread_sample_ = now;
+    }
+#endif
+
     // --- 修改：get_cpu_peak_since_last_call 现在只返回并重置峰值 ---
     // 这个函数由 collectCurrentMetrics 调用，获取并重置由后台线程维护的峰值
     double get_cpu_peak_since_last_call() {
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Called.");
+        ZR_LOG_TRACE("ResourceUtilization", "[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Called.");
         if (!is_initialized_) {
             Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Error: Not initialized.");
             return -1.0;
@@ -415,7 +722,7 @@ public:
         // 原子地加载当前峰值，并将其重置为 -1.0 (表示下一轮监控周期的开始)
         // exchange 操作是原子的：它返回旧值，并将新值存入 atomic 变量
         double peak = current_cpu_peak_.exchange(-1.0);
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Returning peak: " + std::to_string(peak) + "% and resetting internal peak tracker.");
+        ZR_LOG_DEBUG("ResourceUtilization", "[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Returning peak: " << peak << "% and resetting internal peak tracker.");
         return peak;
     }
     // --- 修改结束 ---
@@ -426,6 +733,7 @@ public:
 
     // --- 新增：辅助函数：安全地将 std::wstring 转换为 std::string ---
     // 解决 C4244 警告
+#ifdef _WIN32
     static std::string wstring_to_string(const std::wstring& wstr) {
         if (wstr.empty()) return std::string();
         int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
@@ -434,6 +742,7 @@ public:
         WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), &str[0], size_needed, NULL, NULL);
         return str;
     }
+#endif
     // --- 新增结束 ---
 
 private:
@@ -448,14 +757,31 @@ private:
     std::thread* sampling_thread_;  // 后台采样线程指针
     std::atomic<bool> stop_sampling_; // 停止采样的标志
     std::atomic<double> current_cpu_peak_; // 存储当前采样周期内的 CPU 使用率峰值
+    std::atomic<double> last_cpu_usage_{ -1.0 }; // 最近一次采样的 CPU 使用率
+
+    // CPU 历史记录 (start_cpu_recording / stop_cpu_recording_and_get_history)
+    std::atomic<bool> recording_{ false };
+    std::mutex history_mtx_;           // 保护 cpu_history_
+    std::vector<float> cpu_history_;   // 每 20ms 一个采样点
 
     // --- 新增：每个核心监控相关 ---
 #ifdef _WIN32
     mutable PDH_HQUERY query_; // PDH 查询句柄
     mutable std::vector<PDH_HCOUNTER> counters_; // PDH 计数器句柄列表
     mutable std::vector<std::wstring> counterPaths_; // 存储每个核心的计数器路径 (wstring)
+#else
+    long clk_tck_ = 100;                           // 每秒 clock tick 数 (USER_HZ)
+    mutable std::mutex core_mtx_;                  // 保护 prev_core_times_
+    mutable std::vector<ProcCpuTimes> prev_core_times_; // 上次快照时每个核心的时间
+    std::unordered_map<int, unsigned long long> prev_thread_ticks_; // 上个线程窗口的 tick
+    std::chrono::steady_clock::time_point last_thread_sample_{ std::chrono::steady_clock::now() };
 #endif
     // --- 新增结束 ---
+
+    // 每线程 CPU 归因
+    std::mutex thread_mtx_;                                // 保护以下两个容器
+    std::unordered_map<int, std::string> thread_roles_;    // tid -> 登记的角色
+    std::unordered_map<int, ThreadCpuUsage> thread_usage_; // tid -> 使用率
     // --- 成员变量结束 ---
 };
 
@@ -506,7 +832,7 @@ void ResourceUtilization::shutdown() {
 
 // 【核心】采集当前系统指标
 SysMetrics ResourceUtilization::collectCurrentMetrics() const {
-    Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] Collecting metrics...");
+    ZR_LOG_TRACE("ResourceUtilization", "[ResourceUtilization::collectCurrentMetrics] Collecting metrics...");
     SysMetrics metrics{};
 
     // 初始化所有指标为默认值 (包括新增的系统级指标)
@@ -532,31 +858,34 @@ SysMetrics ResourceUtilization::collectCurrentMetrics() const {
     // --- 修改结束 ---
     if (cpu_peak >= 0.0) {
         metrics.cpu_usage_percent_peak = cpu_peak;
-        Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] CPU usage peak (valid): " + std::to_string(cpu_peak));
+        ZR_LOG_DEBUG("ResourceUtilization", "[ResourceUtilization::collectCurrentMetrics] CPU usage peak (valid): " << cpu_peak);
     }
     else if (cpu_peak == -1.0) {
         // 这可能意味着初始化失败，或者在采样周期内没有获取到有效数据 (例如，进程非常空闲)
         metrics.cpu_usage_percent_peak = -1.0;
-        Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] CPU usage peak collection returned -1.0 (no data or error).");
+        ZR_LOG_DEBUG("ResourceUtilization", "[ResourceUtilization::collectCurrentMetrics] CPU usage peak collection returned -1.0 (no data or error).");
     }
     // 注意：由于后台线程持续运行，理论上不太可能返回 < -1.0 的值
 
     // 2. 内存统计来自 GloMemPool (保持原有逻辑不变)
-    Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] Collecting memory stats from GloMemPool...");
+    ZR_LOG_TRACE("ResourceUtilization", "[ResourceUtilization::collectCurrentMetrics] Collecting memory stats from GloMemPool...");
     auto mem_stats = GloMemPool::getStats();
     metrics.memory_peak_kb = static_cast<unsigned long long>(mem_stats.peak_usage / 1024);
     metrics.memory_current_kb = static_cast<unsigned long long>(mem_stats.total_allocated / 1024);
     metrics.memory_alloc_count = mem_stats.alloc_count;
     metrics.memory_dealloc_count = mem_stats.dealloc_count;
     metrics.memory_current_blocks = mem_stats.current_blocks;
-    Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] GloMemPool stats collected.");
+    ZR_LOG_TRACE("ResourceUtilization", "[ResourceUtilization::collectCurrentMetrics] GloMemPool stats collected.");
 
     // --- 新增：委托给 Impl 收集系统级进程内存信息 ---
     // 通过 Impl 的私有方法安全地访问其成员并收集系统内存信息
     pimpl_->collect_system_memory_info(metrics);
     // --- 新增结束 ---
 
-    Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] Metrics collection complete.");
+    // 3. 每线程 CPU 使用率 (同时重置每线程峰值，与进程峰值的统计周期保持一致)
+    metrics.thread_cpu_usage = pimpl_->get_per_thread_usage_internal(true);
+
+    ZR_LOG_TRACE("ResourceUtilization", "[ResourceUtilization::collectCurrentMetrics] Metrics collection complete.");
     return metrics;
 }
 
@@ -588,26 +917,47 @@ std::vector<PerCoreUsage> ResourceUtilization::getPerCoreUsageSnapshot() const {
 }
 // --- 新增结束 ---
 
-// --- 其他现有方法 (start_cpu_recording, stop_cpu_recording_and_get_history) 的实现 ---
-// (请将您原有的实现放在这里，并确保 stop_cpu_recording_and_get_history 有 return 语句)
+void ResourceUtilization::registerCurrentThread(const std::string& role) {
+    if (pimpl_) {
+        pimpl_->register_thread_role(role);
+    }
+    RealtimeProfile::instance().applyToCurrentThread(role);
+}
+
+std::vector<ThreadCpuUsage> ResourceUtilization::getPerThreadUsageSnapshot() const {
+    if (!is_initialized_ || !pimpl_) {
+        return {};
+    }
+    return pimpl_->get_per_thread_usage_internal(false);
+}
+
+// --- CPU 历史记录：由后台采样线程在记录期间追加每个采样点 ---
 void ResourceUtilization::start_cpu_recording() {
-    // ... (您的现有实现逻辑) ...
-    // TODO: 实现 CPU 记录启动逻辑
-    Logger::getInstance().logAndPrint("[ResourceUtilization::start_cpu_recording] CPU recording started (placeholder).");
+    if (!is_initialized_ || !pimpl_) {
+        Logger::getInstance().logAndPrint("[ResourceUtilization::start_cpu_recording] Warning: Not initialized, CPU history will be empty.");
+        return;
+    }
+    pimpl_->start_recording();
+    ZR_LOG_DEBUG("ResourceUtilization", "[ResourceUtilization::start_cpu_recording] CPU recording started.");
 }
 
 std::vector<float> ResourceUtilization::stop_cpu_recording_and_get_history() {
-    // ... (您的现有实现逻辑) ...
-    // 例如：
-    std::vector<float> history;
-    // ... (填充 history 的逻辑) ...
-    // ... (可能的清理逻辑) ...
-    Logger::getInstance().logAndPrint("[ResourceUtilization::stop_cpu_recording_and_get_history] CPU recording stopped and history retrieved (placeholder).");
-    return history; // <--- 确保有 return 语句
-    // 如果暂时没有实现，可以返回空 vector:
-    // return {};
+    if (!is_initialized_ || !pimpl_) {
+        return {};
+    }
+    std::vector<float> history = pimpl_->stop_recording();
+    ZR_LOG_DEBUG("ResourceUtilization", "[ResourceUtilization::stop_cpu_recording_and_get_history] CPU recording stopped, "
+        << history.size() << " samples.");
+    return history;
+}
+
+double ResourceUtilization::lastCpuUsage() const {
+    if (!is_initialized_ || !pimpl_) {
+        return -1.0;
+    }
+    return pimpl_->last_cpu_usage();
 }
-// --- 其他现有方法结束 ---
+// --- CPU 历史记录结束 ---
 
 
 // --- 新增：Impl 类中 collect_system_memory_info 方法的实现 ---
@@ -625,7 +975,7 @@ void ResourceUtilization::Impl::collect_system_memory_info(SysMetrics& metrics_o
             metrics_out.system_private_usage_kb = pmc_ex.PrivateUsage / 1024;
             metrics_out.system_quota_paged_pool_usage_kb = pmc_ex.QuotaPagedPoolUsage / 1024;
             metrics_out.system_quota_nonpaged_pool_usage_kb = pmc_ex.QuotaNonPagedPoolUsage / 1024;
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::collect_system_memory_info] System process memory stats collected.");
+            ZR_LOG_TRACE("ResourceUtilization", "[ResourceUtilization::Impl::collect_system_memory_info] System process memory stats collected.");
         }
         else {
             DWORD error = GetLastError();
@@ -636,7 +986,25 @@ void ResourceUtilization::Impl::collect_system_memory_info(SysMetrics& metrics_o
         Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::collect_system_memory_info] Warning: Process handle or Impl not initialized for system memory stats.");
     }
 #else
-    Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::collect_system_memory_info] System process memory stats collection not implemented for non-Windows.");
+    // Linux 映射：VmSize/VmPeak -> 提交大小，VmRSS/VmHWM -> 工作集，RssAnon -> 私有内存
+    std::ifstream in("/proc/self/status");
+    if (!in.is_open()) {
+        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::collect_system_memory_info] Error opening /proc/self/status.");
+        return;
+    }
+    std::string key;
+    unsigned long long value_kb = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream iss(line);
+        if (!(iss >> key >> value_kb)) continue;
+        if (key == "VmSize:") metrics_out.system_pagefile_usage_kb = value_kb;
+        else if (key == "VmPeak:") metrics_out.system_peak_pagefile_usage_kb = value_kb;
+        else if (key == "VmRSS:") metrics_out.system_working_set_kb = value_kb;
+        else if (key == "VmHWM:") metrics_out.system_peak_working_set_kb = value_kb;
+        else if (key == "RssAnon:") metrics_out.system_private_usage_kb = value_kb;
+    }
+    ZR_LOG_TRACE("ResourceUtilization", "[ResourceUtilization::Impl::collect_system_memory_info] System process memory stats collected from /proc/self/status.");
 #endif
 }
 // --- 新增结束 ---
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "SysMetrics.h" // 确保包含 SysMetrics.h
 #include <memory>
+#include <string>
 #include <vector>
 
 // --- 新增：包含 PerCoreUsage 定义所需的头文件 ---
@@ -52,6 +53,10 @@ public:
 
     // 停止 CPU 记录并获取记录的历史数据
     std::vector<float> stop_cpu_recording_and_get_history();
+
+    // 后台采样线程最近一次得到的进程 CPU 使用率 (%)，未采样时为 -1.0；
+    // 只读原子量，可在区间采样等场景下高频调用，不影响峰值统计
+    double lastCpuUsage() const;
     // --- 新增结束 ---
 
     // --- 新增：获取每个 CPU 核心使用率的方法 (声明) ---
@@ -60,6 +65,13 @@ public:
     std::vector<PerCoreUsage> getPerCoreUsageSnapshot() const;
     // --- 新增结束 ---
 
+    // 将调用线程登记为指定角色 (sender / dds_listener 等)，用于每线程 CPU 归因；
+    // 同时按 RealtimeProfile 为该角色绑核 / 设置优先级
+    void registerCurrentThread(const std::string& role);
+
+    // 获取每线程 CPU 使用率快照 (不重置峰值，目前仅 Linux 实现)
+    std::vector<ThreadCpuUsage> getPerThreadUsageSnapshot() const;
+
 private:
     // 私有构造/析构函数，防止外部实例化
     ResourceUtilization();
@@ -1,5 +1,15 @@
 #pragma once
 #include <cstdint>
+#include <string>
+#include <vector>
+
+// 单个线程的 CPU 使用情况 (百分比以单核满载为 100%)
+struct ThreadCpuUsage {
+    int tid = 0;                  // 线程 ID (Linux: gettid)
+    std::string role;             // 登记的角色 (sender / dds_listener ...)，未登记时为线程名
+    double usage_percent = -1.0;  // 最近一个线程采样窗口内的使用率
+    double peak_percent = -1.0;   // 自上次 collectCurrentMetrics 以来的峰值
+};
 
 // 系统资源指标结构体
 struct SysMetrics {
@@ -29,4 +39,7 @@ struct SysMetrics {
     unsigned long long system_quota_paged_pool_usage_kb = 0;    // 分页池配额使用量
     unsigned long long system_quota_nonpaged_pool_usage_kb = 0; // 非分页池配额使用量
     // --- 新增结束 ---
+
+    // 每线程 CPU 使用率 (按峰值降序，目前仅 Linux 填充)
+    std::vector<ThreadCpuUsage> thread_cpu_usage;
 };
\ No newline at end of file
@@ -0,0 +1,157 @@
+﻿// IntervalRecorder.cpp
+#include "IntervalRecorder.h"
+#include "GloMemPool.h"
+#include "Logger.h"
+#include "ResourceUtilization.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+IntervalRecorder::IntervalRecorder(int interval_ms)
+    : interval_ms_(interval_ms) {
+}
+
+IntervalRecorder::~IntervalRecorder() {
+    if (running_) {
+        TestRoundResult discard;
+        stopInto(discard);
+    }
+}
+
+void IntervalRecorder::start(CounterProbe counters, LatencyProbe latency) {
+    if (running_) return;
+
+    counter_probe_ = std::move(counters);
+    latency_probe_ = std::move(latency);
+    intervals_.clear();
+    samples_.clear();
+    last_ = counter_probe_ ? counter_probe_() : Counters{};
+    round_start_ = last_time_ = Clock::now();
+    stop_ = false;
+    running_ = true;
+
+    ResourceUtilization::instance().start_cpu_recording();
+    if (enabled()) {
+        thread_ = std::thread(&IntervalRecorder::run, this);
+    }
+}
+
+void IntervalRecorder::stopInto(TestRoundResult& result) {
+    if (!running_) return;
+
+    if (thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+        // 补记最后一个不完整区间（不足 1ms 的尾巴直接丢弃）
+        const auto now = Clock::now();
+        if (now - last_time_ >= std::chrono::milliseconds(1)) {
+            sampleOnce(now);
+        }
+    }
+    running_ = false;
+
+    result.cpu_usage_history = ResourceUtilization::instance().stop_cpu_recording_and_get_history();
+    result.intervals = std::move(intervals_);
+    result.samples = std::move(samples_);
+    intervals_.clear();
+    samples_.clear();
+
+    if (!result.intervals.empty()) {
+        Logger::getInstance().logAndPrint(formatSummary(result.intervals));
+    }
+}
+
+void IntervalRecorder::run() {
+    ResourceUtilization::instance().registerCurrentThread("interval_recorder");
+
+    const auto period = std::chrono::milliseconds(interval_ms_);
+    auto next = round_start_ + period;
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (!cv_.wait_until(lock, next, [this] { return stop_; })) {
+        lock.unlock();
+        sampleOnce(Clock::now());
+        lock.lock();
+        // 按绝对时间表推进；采样被拖慢时跳过错过的周期，不连发
+        next += period;
+        const auto now = Clock::now();
+        if (next <= now) {
+            next = now + period;
+        }
+    }
+}
+
+void IntervalRecorder::sampleOnce(Clock::time_point now) {
+    const Counters cur = counter_probe_ ? counter_probe_() : Counters{};
+    const double seconds = std::chrono::duration<double>(now - last_time_).count();
+
+    IntervalSample s;
+    s.elapsed_ms = std::chrono::duration<double, std::milli>(now - round_start_).count();
+    s.messages = cur.messages >= last_.messages ? cur.messages - last_.messages : 0;
+    const uint64_t bytes = cur.bytes >= last_.bytes ? cur.bytes - last_.bytes : 0;
+    s.lost = cur.lost >= last_.lost ? cur.lost - last_.lost : 0;
+    if (seconds > 0) {
+        s.msgs_per_sec = s.messages / seconds;
+        s.mb_per_sec = bytes / seconds / (1024.0 * 1024.0);
+    }
+    if (latency_probe_) {
+        latency_probe_(s);
+    }
+    s.cpu_percent = ResourceUtilization::instance().lastCpuUsage();
+
+    const GloMemPool::Stats mem = GloMemPool::getStats();
+    s.memory_kb = static_cast<unsigned long long>(mem.total_allocated / 1024);
+
+    // 与 intervals 一一对应的轻量 SysMetrics（不采集每线程 / 系统内存，避免重置峰值统计）
+    SysMetrics m;
+    m.cpu_usage_percent_peak = s.cpu_percent;
+    m.memory_current_kb = s.memory_kb;
+    m.memory_peak_kb = static_cast<unsigned long long>(mem.peak_usage / 1024);
+    m.memory_alloc_count = mem.alloc_count;
+    m.memory_dealloc_count = mem.dealloc_count;
+    m.memory_current_blocks = mem.current_blocks;
+
+    ZR_LOG_DEBUG("IntervalRecorder", std::fixed << std::setprecision(2)
+        << "[区间] t=" << s.elapsed_ms << "ms | " << s.msgs_per_sec << " msg/s | "
+        << s.mb_per_sec << " MB/s | 丢包 " << s.lost
+        << " | 时延 p50/p99 " << s.latency_p50_us << "/" << s.latency_p99_us << " μs"
+        << " | CPU " << s.cpu_percent << "% | 内存 " << s.memory_kb << " KB");
+
+    intervals_.push_back(s);
+    samples_.push_back(std::move(m));
+    last_ = cur;
+    last_time_ = now;
+}
+
+std::string IntervalRecorder::formatSummary(const std::vector<IntervalSample>& intervals) {
+    std::ostringstream oss;
+    if (intervals.empty()) {
+        oss << "区间采样 | 无数据";
+        return oss.str();
+    }
+
+    std::vector<double> rates;
+    rates.reserve(intervals.size());
+    size_t stalls = 0;
+    size_t lossy = 0;
+    double cpu_max = -1.0;
+    for (const auto& s : intervals) {
+        rates.push_back(s.msgs_per_sec);
+        if (s.messages == 0) ++stalls;
+        if (s.lost > 0) ++lossy;
+        cpu_max = std::max(cpu_max, s.cpu_percent);
+    }
+    std::sort(rates.begin(), rates.end());
+
+    oss << std::fixed << std::setprecision(2)
+        << "区间采样 | 区间数: " << intervals.size()
+        << " | msg/s 最小/中位/最大: " << rates.front() << "/" << rates[rates.size() / 2] << "/" << rates.back()
+        << " | 停顿区间: " << stalls
+        << " | 丢包区间: " << lossy
+        << " | 区间 CPU 最大: " << cpu_max << "%";
+    return oss.str();
+}
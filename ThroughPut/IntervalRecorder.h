@@ -0,0 +1,87 @@
+﻿// IntervalRecorder.h
+#pragma once
+
+#include "TestRoundResult.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 每轮测试的区间采样器：按固定周期（m_sampleIntervalMs，默认 100ms）记录时间序列。
+ *
+ * 测试引擎提供一个计数探针，返回本轮开始以来的累计消息数 / 字节数 / 丢包数；
+ * 采样线程每个周期读取一次，差分得到区间内的 msg/s、MB/s 与新增丢包，
+ * 并附上 ResourceUtilization 最近一次 CPU 采样值与 GloMemPool 当前占用。
+ * 时延测试可额外提供时延探针，填充区间内的 p50 / p99 / max。
+ *
+ * 探针在采样线程中调用，只应读取原子计数，不得阻塞热路径。
+ * 停止时补记最后一个不完整区间，结果写入 TestRoundResult 的 intervals / samples /
+ * cpu_usage_history（后者来自 ResourceUtilization 的 20ms 级 CPU 历史）。
+ */
+class IntervalRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 本轮开始以来的累计计数
+    struct Counters {
+        uint64_t messages = 0;
+        uint64_t bytes = 0;
+        uint64_t lost = 0;
+    };
+    using CounterProbe = std::function<Counters()>;
+    // 可选：填充本区间的 latency_count / latency_p50_us / latency_p99_us / latency_max_us
+    using LatencyProbe = std::function<void(IntervalSample&)>;
+
+    /**
+     * @param interval_ms 采样周期（毫秒），<= 0 时不启动采样线程，仅记录 CPU 历史
+     */
+    explicit IntervalRecorder(int interval_ms);
+    ~IntervalRecorder();
+
+    IntervalRecorder(const IntervalRecorder&) = delete;
+    IntervalRecorder& operator=(const IntervalRecorder&) = delete;
+
+    bool enabled() const { return interval_ms_ > 0; }
+
+    /**
+     * @brief 以当前时刻为本轮起点开始采样
+     */
+    void start(CounterProbe counters, LatencyProbe latency = nullptr);
+
+    /**
+     * @brief 停止采样，将区间序列与 CPU 历史写入 result（未 start 时不修改 result）
+     */
+    void stopInto(TestRoundResult& result);
+
+    /**
+     * @brief 区间序列摘要：区间数、msg/s 最小/中位/最大、停顿区间数、丢包区间数
+     */
+    static std::string formatSummary(const std::vector<IntervalSample>& intervals);
+
+private:
+    void run();
+    void sampleOnce(Clock::time_point now);
+
+    const int interval_ms_;
+    CounterProbe counter_probe_;
+    LatencyProbe latency_probe_;
+
+    std::thread thread_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    bool running_ = false;
+
+    Clock::time_point round_start_;
+    Clock::time_point last_time_;
+    Counters last_;
+    std::vector<IntervalSample> intervals_;
+    std::vector<SysMetrics> samples_;
+};
@@ -0,0 +1,166 @@
+﻿// RateController.cpp
+#include "RateController.h"
+#include "ConfigData.h"
+
+#include <thread>
+#include <sstream>
+#include <iomanip>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define RATE_CPU_RELAX() _mm_pause()
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RATE_CPU_RELAX() _mm_pause()
+#else
+#define RATE_CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace {
+    // 距离截止时间小于该值时改为自旋；Windows 默认定时器粒度约 1ms，需要更大的余量
+#ifdef _WIN32
+    constexpr std::chrono::microseconds kSpinThreshold(2000);
+#else
+    constexpr std::chrono::microseconds kSpinThreshold(100);
+#endif
+    constexpr int64_t kLateThresholdNs = 10000; // 滞后超过 10us 计为一次迟发
+}
+
+RateController::RateController(const ConfigData& config, int round_index)
+    : rng_(std::random_device{}())
+{
+    int delay_us = 0;
+    int delay_count = 1;
+    if (config.has_m_sendDelay && round_index < static_cast<int>(config.m_sendDelay.size())) {
+        delay_us = config.m_sendDelay[round_index];
+    }
+    if (round_index < static_cast<int>(config.m_sendDelayCount.size()) &&
+        config.m_sendDelayCount[round_index] > 0) {
+        delay_count = config.m_sendDelayCount[round_index];
+    }
+    if (delay_us <= 0) {
+        mode_ = ArrivalMode::Saturate;
+        return;
+    }
+
+    interval_ns_ = static_cast<double>(delay_us) * 1000.0 / delay_count;
+
+    if (config.m_arrivalMode == "poisson") {
+        mode_ = ArrivalMode::Poisson;
+    }
+    else if (config.m_arrivalMode == "onoff" && config.m_onDurationUs > 0 && config.m_offDurationUs > 0) {
+        mode_ = ArrivalMode::OnOff;
+        on_duration_ = std::chrono::microseconds(config.m_onDurationUs);
+        off_duration_ = std::chrono::microseconds(config.m_offDurationUs);
+    }
+    else {
+        mode_ = ArrivalMode::Constant;
+    }
+}
+
+double RateController::targetRate() const {
+    if (!enabled() || interval_ns_ <= 0.0) return 0.0;
+    double rate = 1e9 / interval_ns_;
+    if (mode_ == ArrivalMode::OnOff) {
+        // 平均速率按 ON 占空比折算
+        double on = static_cast<double>(on_duration_.count());
+        double period = on + static_cast<double>(off_duration_.count());
+        rate *= on / period;
+    }
+    return rate;
+}
+
+void RateController::start() {
+    start_time_ = Clock::now();
+    next_send_ = start_time_;
+    schedule_carry_ns_ = 0.0;
+    scheduled_count_ = 0;
+    late_count_ = 0;
+    max_lateness_ns_ = 0;
+    total_lateness_ns_ = 0.0;
+}
+
+std::chrono::nanoseconds RateController::nextInterval() {
+    double ns = interval_ns_;
+    if (mode_ == ArrivalMode::Poisson) {
+        ns = exp_dist_(rng_) * interval_ns_;
+    }
+    ns += schedule_carry_ns_;
+    int64_t whole = static_cast<int64_t>(ns);
+    schedule_carry_ns_ = ns - static_cast<double>(whole);
+    return std::chrono::nanoseconds(whole);
+}
+
+void RateController::sleepUntil(Clock::time_point deadline) {
+    auto now = Clock::now();
+    if (now >= deadline) return;
+    if (deadline - now > kSpinThreshold) {
+        std::this_thread::sleep_until(deadline - kSpinThreshold);
+    }
+    while (Clock::now() < deadline) {
+        RATE_CPU_RELAX();
+    }
+}
+
+RateController::Clock::time_point RateController::waitNext() {
+    if (!enabled()) {
+        return Clock::now();
+    }
+
+    if (mode_ == ArrivalMode::OnOff) {
+        // 计划时刻落入 OFF 区间时，顺延到下一个 ON 区间起点
+        auto period = on_duration_ + off_duration_;
+        auto offset = (next_send_ - start_time_) % period;
+        if (offset >= on_duration_) {
+            next_send_ += period - offset;
+        }
+    }
+
+    const Clock::time_point scheduled = next_send_;
+    sleepUntil(scheduled);
+
+    int64_t lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - scheduled).count();
+    ++scheduled_count_;
+    total_lateness_ns_ += static_cast<double>(lateness);
+    if (lateness > max_lateness_ns_) max_lateness_ns_ = lateness;
+    if (lateness > kLateThresholdNs) ++late_count_;
+
+    next_send_ += nextInterval();
+    return scheduled;
+}
+
+std::string RateController::describe() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    switch (mode_) {
+    case ArrivalMode::Saturate:
+        oss << "速率控制: 不限速";
+        return oss.str();
+    case ArrivalMode::Constant:
+        oss << "速率控制: 恒定间隔";
+        break;
+    case ArrivalMode::Poisson:
+        oss << "速率控制: 泊松到达";
+        break;
+    case ArrivalMode::OnOff:
+        oss << "速率控制: ON/OFF 突发 (ON " << on_duration_.count() / 1000 << " us, OFF "
+            << off_duration_.count() / 1000 << " us)";
+        break;
+    }
+    oss << " | 平均间隔: " << interval_ns_ / 1000.0 << " us | 目标速率: " << targetRate() << " msg/s";
+    return oss.str();
+}
+
+std::string RateController::summary(uint64_t sent) const {
+    if (!enabled()) return "速率控制: 不限速";
+    double elapsed_s = std::chrono::duration<double>(Clock::now() - start_time_).count();
+    double actual_rate = elapsed_s > 0 ? static_cast<double>(sent) / elapsed_s : 0.0;
+    double avg_late_us = scheduled_count_ ? total_lateness_ns_ / scheduled_count_ / 1000.0 : 0.0;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "速率控制统计 | 目标: " << targetRate() << " msg/s | 实际: " << actual_rate << " msg/s | "
+        << "平均调度滞后: " << avg_late_us << " us | 最大滞后: " << max_lateness_ns_ / 1000.0 << " us | "
+        << "迟发(>" << kLateThresholdNs / 1000 << "us): " << late_count_;
+    return oss.str();
+}
@@ -0,0 +1,98 @@
+﻿// RateController.h
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+
+struct ConfigData;
+
+/**
+ * @brief 发送速率控制器：按 m_sendDelay / m_sendDelayCount 生成发送时刻并精确等待。
+ *
+ * 配置语义：每 m_sendDelayCount 个样本占用 m_sendDelay 微秒，即目标速率
+ * m_sendDelayCount * 1e6 / m_sendDelay msg/s；m_sendDelay 为 0 时不限速（饱和发送）。
+ *
+ * 到达过程由 m_arrivalMode 选择：
+ *  - "constant"：恒定间隔
+ *  - "poisson" ：指数分布间隔（泊松到达），平均速率与 constant 相同
+ *  - "onoff"   ：ON 期间 (m_onDurationUs) 按恒定间隔发送，OFF 期间 (m_offDurationUs) 静默
+ *
+ * 发送时刻按绝对时间表推进（不累积误差）；落后于时间表时不再等待，立即补发。
+ * 等待采用"睡眠 + 自旋"混合方式：距离截止时间较远时 sleep，最后一段自旋，精度可达数微秒。
+ */
+class RateController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class ArrivalMode {
+        Saturate,   // 不限速
+        Constant,
+        Poisson,
+        OnOff
+    };
+
+    /**
+     * @brief 根据当前轮次配置构造
+     * @param config 配置数据
+     * @param round_index 轮次索引（用于选取 m_sendDelay / m_sendDelayCount）
+     */
+    RateController(const ConfigData& config, int round_index);
+
+    bool enabled() const { return mode_ != ArrivalMode::Saturate; }
+    ArrivalMode mode() const { return mode_; }
+
+    /**
+     * @brief 目标速率（msg/s），不限速时返回 0
+     */
+    double targetRate() const;
+
+    /**
+     * @brief 以当前时刻为时间表起点
+     */
+    void start();
+
+    /**
+     * @brief 阻塞等待到下一个计划发送时刻，并推进时间表
+     * @return 本次计划发送时刻（开环时延测试可据此修正协调遗漏）
+     */
+    Clock::time_point waitNext();
+
+    /**
+     * @brief 混合睡眠/自旋等待到指定时刻
+     */
+    static void sleepUntil(Clock::time_point deadline);
+
+    /**
+     * @brief 描述当前速率配置
+     */
+    std::string describe() const;
+
+    /**
+     * @brief 生成本轮速率控制统计（实际速率、调度滞后）
+     * @param sent 本轮实际发送数量
+     */
+    std::string summary(uint64_t sent) const;
+
+private:
+    std::chrono::nanoseconds nextInterval();
+
+    ArrivalMode mode_ = ArrivalMode::Saturate;
+    double interval_ns_ = 0.0;          // 平均发送间隔（纳秒）
+    std::chrono::nanoseconds on_duration_{ 0 };
+    std::chrono::nanoseconds off_duration_{ 0 };
+
+    Clock::time_point start_time_;
+    Clock::time_point next_send_;       // 下一个计划发送时刻
+    double schedule_carry_ns_ = 0.0;    // 间隔小数部分累计，避免取整误差
+
+    std::mt19937_64 rng_;
+    std::exponential_distribution<double> exp_dist_{ 1.0 };
+
+    // 统计：计划时刻与实际发送时刻的滞后
+    uint64_t scheduled_count_ = 0;
+    uint64_t late_count_ = 0;           // 滞后超过 kLateThreshold 的次数
+    int64_t max_lateness_ns_ = 0;
+    double total_lateness_ns_ = 0.0;
+};
@@ -0,0 +1,106 @@
+﻿// RoundGate.cpp
+#include "RoundGate.h"
+
+#include <algorithm>
+
+RoundGate::RoundGate() {
+    pending_sequences_.reserve(kDeferredCapacity);
+}
+
+RoundGate::Admit RoundGate::classifyLocked(uint32_t round) const {
+    const uint32_t armed = armed_.load(std::memory_order_relaxed);
+    if (armed != 0 && round == armed) {
+        return Admit::Current;
+    }
+    if (round <= std::max(armed, finished_)) {
+        return Admit::Stale;
+    }
+    return Admit::Deferred;
+}
+
+void RoundGate::deferLocked(uint32_t round) {
+    if (pending_round_ == round) {
+        return;
+    }
+    // 更晚轮次的样本到达时较早的暂存已无法被登记，整体替换
+    pending_round_ = round;
+    pending_sequences_.clear();
+    pending_first_data_ = std::chrono::steady_clock::time_point();
+    pending_end_ = false;
+    pending_dropped_ = 0;
+}
+
+RoundGate::Admit RoundGate::admitData(uint32_t round, uint32_t sequence) {
+    const uint32_t armed = armed_.load(std::memory_order_acquire);
+    if (armed != 0) {
+        if (round == armed) return Admit::Current;
+        if (round < armed) return Admit::Stale;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    const Admit admit = classifyLocked(round);
+    if (admit != Admit::Deferred) {
+        return admit;
+    }
+    deferLocked(round);
+    if (pending_end_) {
+        return Admit::Deferred;   // 结束包之后到达的数据不计入
+    }
+    if (pending_sequences_.size() < kDeferredCapacity) {
+        if (pending_sequences_.empty()) {
+            pending_first_data_ = std::chrono::steady_clock::now();
+        }
+        pending_sequences_.push_back(sequence);
+    }
+    else {
+        ++pending_dropped_;
+    }
+    return Admit::Deferred;
+}
+
+RoundGate::Admit RoundGate::admitEnd(uint32_t round) {
+    const uint32_t armed = armed_.load(std::memory_order_acquire);
+    if (armed != 0) {
+        if (round == armed) return Admit::Current;
+        if (round < armed) return Admit::Stale;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    const Admit admit = classifyLocked(round);
+    if (admit != Admit::Deferred) {
+        return admit;
+    }
+    deferLocked(round);
+    if (!pending_end_) {
+        pending_end_ = true;
+        pending_end_time_ = std::chrono::steady_clock::now();
+    }
+    return Admit::Deferred;
+}
+
+void RoundGate::arm(uint32_t round, const std::function<void(const Deferred&)>& replay) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    const bool matched = pending_round_ == round;
+    static const std::vector<uint32_t> kNone;
+    const Deferred deferred{
+        matched ? pending_sequences_ : kNone,
+        matched ? pending_first_data_ : std::chrono::steady_clock::time_point(),
+        matched && pending_end_,
+        matched ? pending_end_time_ : std::chrono::steady_clock::time_point(),
+        matched ? pending_dropped_ : 0 };
+    if (replay) {
+        replay(deferred);
+    }
+
+    pending_round_ = 0;
+    pending_sequences_.clear();
+    pending_end_ = false;
+    pending_dropped_ = 0;
+    armed_.store(round, std::memory_order_release);
+}
+
+void RoundGate::close() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    finished_ = std::max(finished_, armed_.load(std::memory_order_relaxed));
+    armed_.store(0, std::memory_order_release);
+}
@@ -0,0 +1,74 @@
+﻿// RoundGate.h
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 吞吐订阅端的轮次闸门：按包头轮次标记把样本分为本轮 / 上一轮迟到 / 下一轮提前到达。
+ *
+ * 实体复用（m_persistentEntities）时 Reader 跨轮存活，发布端可能在订阅端结算上一轮期间
+ * 就开始发送下一轮。提前到达的样本不阻塞回调线程，只在锁内暂存序列号（最多 kDeferredCapacity 个），
+ * 订阅端 arm() 登记该轮时在锁内交给 replay 回调补记，之后回调线程直接统计本轮。
+ *
+ * 约定：admitData()/admitEnd() 由回调线程调用；arm()/close() 由订阅端线程调用。
+ * 本轮样本走无锁快路径，仅未登记轮次的样本进入加锁慢路径。
+ */
+class RoundGate {
+public:
+    static constexpr size_t kDeferredCapacity = 1u << 16;  // 提前到达样本的暂存上限（序列号个数）
+
+    enum class Admit {
+        Current,    // 属于已登记轮次，由调用方直接统计
+        Deferred,   // 属于尚未登记的轮次，已暂存（或超出暂存上限被丢弃并计数）
+        Stale       // 属于已结算或更早的轮次，调用方忽略
+    };
+
+    /**
+     * @brief arm() 时交给 replay 回调的提前到达记录
+     */
+    struct Deferred {
+        const std::vector<uint32_t>& sequences;           // 暂存的序列号（按到达顺序）
+        std::chrono::steady_clock::time_point first_data;  // 首个暂存数据包到达时间（无暂存时为默认值）
+        bool end_seen;                                      // 该轮结束包已提前到达
+        std::chrono::steady_clock::time_point end_time;    // 结束包到达时间
+        uint64_t dropped;                                   // 超出暂存上限被丢弃的样本数
+    };
+
+    RoundGate();
+
+    RoundGate(const RoundGate&) = delete;
+    RoundGate& operator=(const RoundGate&) = delete;
+
+    Admit admitData(uint32_t round, uint32_t sequence);
+    Admit admitEnd(uint32_t round);
+
+    /**
+     * @brief 登记新一轮：在锁内先调用 replay（订阅端在其中重置统计并补记暂存样本），再让回调线程统计该轮
+     */
+    void arm(uint32_t round, const std::function<void(const Deferred&)>& replay);
+
+    /**
+     * @brief 本轮结算开始：此后到达的本轮样本按迟到处理，不再改写结果
+     */
+    void close();
+
+private:
+    Admit classifyLocked(uint32_t round) const;
+    void deferLocked(uint32_t round);
+
+    std::atomic<uint32_t> armed_{ 0 };     // 正在统计的轮次标记，0 表示没有进行中的轮次
+    std::mutex mtx_;
+    uint32_t finished_ = 0;                 // 已结算的最大轮次标记
+    uint32_t pending_round_ = 0;            // 暂存记录所属轮次，0 表示无暂存
+    std::vector<uint32_t> pending_sequences_;
+    std::chrono::steady_clock::time_point pending_first_data_;
+    bool pending_end_ = false;
+    std::chrono::steady_clock::time_point pending_end_time_;
+    uint64_t pending_dropped_ = 0;
+};
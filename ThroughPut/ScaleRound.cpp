@@ -0,0 +1,162 @@
+﻿// ScaleRound.cpp
+#include "ScaleRound.h"
+#include "RateController.h"
+#include "Logger.h"
+#include "ResourceUtilization.h"
+#include "PacketHeader.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+namespace {
+    constexpr size_t kSizeTableSize = 1024;     // 预抽样包大小表长度（2 的幂）
+}
+
+// ========================
+// 发送线程
+// ========================
+
+void runScaleSender(DDSManager_Scale& manager, const std::vector<size_t>& writer_indices,
+    const ConfigData& profile, int round, uint32_t source_base,
+    std::vector<WriterSendStats>& stats, const char* log_tag) {
+    ResourceUtilization::instance().registerCurrentThread("sender");
+
+    const int min_size = profile.m_minSize[round];
+    const int max_size = profile.m_maxSize[round];
+    const int send_count = profile.m_sendCount[round];
+    const int print_gap = (log_tag && round < static_cast<int>(profile.m_sendPrintGap.size())) ? profile.m_sendPrintGap[round] : 0;
+    const int header_size = static_cast<int>(sizeof(PacketHeader));
+    const auto& writers = manager.writers();
+
+    DDS::Bytes sample;
+    if (!manager.prepareReusableBytesData(sample, std::max({ min_size, max_size, header_size }))) {
+        return;
+    }
+    // 包大小每轮预抽样一次，发送循环内只查表
+    std::vector<int> size_table;
+    if (min_size != max_size) {
+        std::mt19937 gen(std::random_device{}());
+        std::uniform_int_distribution<int> dis(std::min(min_size, max_size), std::max(min_size, max_size));
+        size_table.resize(kSizeTableSize);
+        for (auto& s : size_table) {
+            s = std::max(dis(gen), header_size);
+        }
+    }
+    const int fixed_size = std::max(min_size, header_size);
+    PacketHeader* hdr = reinterpret_cast<PacketHeader*>(sample.value.get_contiguous_buffer());
+
+    RateController rate(profile, round);
+    const auto begin = std::chrono::steady_clock::now();
+    rate.start();
+    for (int i = 0; i < send_count; ++i) {
+        rate.waitNext();
+        hdr->sequence = static_cast<uint32_t>(i);
+        hdr->timestamp = steadyNowNs();
+        hdr->packet_type = 0;
+        sample.value._length = static_cast<DDS_ULong>(
+            size_table.empty() ? fixed_size : size_table[static_cast<size_t>(i) & (kSizeTableSize - 1)]);
+        for (size_t w : writer_indices) {
+            if (writers[w].typed_writer->write(sample, DDS_HANDLE_NIL_NATIVE) == DDS::RETCODE_OK) {
+                ++stats[w].sent;
+            }
+            else {
+                ++stats[w].failed;
+            }
+        }
+        if (print_gap > 0 && (i + 1) % print_gap == 0) {
+            Logger::getInstance().logAndPrint(std::string(log_tag) + ": Writer[" + std::to_string(writer_indices.front()) +
+                (writer_indices.size() > 1 ? " 等 " + std::to_string(writer_indices.size()) + " 个" : std::string()) +
+                "] 已发送 " + std::to_string(i + 1));
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    for (size_t w : writer_indices) {
+        stats[w].seconds = seconds;
+        stats[w].rate_summary = rate.summary(stats[w].sent);
+    }
+    manager.releaseReusableBytesData(sample);
+
+    // 等待确认后发送结束包（重复 3 次，兼容 best-effort Reader）
+    DDS::Bytes end_sample;
+    if (manager.prepareEndBytesData(end_sample)) {
+        for (size_t w : writer_indices) {
+            writers[w].writer->wait_for_acknowledgments({ 2, 0 });
+        }
+        PacketHeader* end_hdr = reinterpret_cast<PacketHeader*>(end_sample.value.get_contiguous_buffer());
+        for (int k = 0; k < 3; ++k) {
+            for (size_t w : writer_indices) {
+                end_hdr->source = source_base + static_cast<uint32_t>(w);
+                writers[w].typed_writer->write(end_sample, DDS_HANDLE_NIL_NATIVE);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        manager.releaseReusableBytesData(end_sample);
+    }
+}
+
+// ========================
+// 结束包计数
+// ========================
+
+void EndOfRoundTracker::reset(const std::vector<size_t>& expected_writers) {
+    count_ = expected_writers.size();
+    entries_.reset(count_ > 0 ? new Entry[count_] : nullptr);
+    for (size_t i = 0; i < count_; ++i) {
+        entries_[i].expected = std::max<size_t>(expected_writers[i], 1);
+    }
+    ended_readers_.store(0);
+}
+
+void EndOfRoundTracker::onEnd(size_t reader_index, uint32_t source) {
+    if (reader_index >= count_) return;
+    Entry& e = entries_[reader_index];
+    if (e.ended.load()) return;
+    {
+        std::lock_guard<std::mutex> lock(e.mtx);
+        if (std::find(e.sources.begin(), e.sources.end(), source) != e.sources.end()) return;
+        e.sources.push_back(source);
+        if (e.sources.size() < e.expected) return;
+    }
+    if (e.ended.exchange(true)) return;
+    if (ended_readers_.fetch_add(1) + 1 >= count_) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        cv_.notify_all();
+    }
+}
+
+bool EndOfRoundTracker::ended(size_t reader_index) const {
+    return reader_index < count_ && entries_[reader_index].ended.load();
+}
+
+size_t EndOfRoundTracker::endedWriters(size_t reader_index) const {
+    if (reader_index >= count_) return 0;
+    std::lock_guard<std::mutex> lock(entries_[reader_index].mtx);
+    return entries_[reader_index].sources.size();
+}
+
+size_t EndOfRoundTracker::expectedWriters(size_t reader_index) const {
+    return reader_index < count_ ? entries_[reader_index].expected : 1;
+}
+
+bool EndOfRoundTracker::wait(const std::function<uint64_t()>& progress, const std::string& log_tag) {
+    uint64_t last_total = 0;
+    auto last_progress = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (ended_readers_.load() < count_) {
+        cv_.wait_for(lock, std::chrono::seconds(1));
+        const uint64_t total = progress ? progress() : 0;
+        const auto now = std::chrono::steady_clock::now();
+        if (total != last_total) {
+            last_total = total;
+            last_progress = now;
+        }
+        else if (now - last_progress >= kStallTimeout) {
+            Logger::getInstance().logAndPrint(log_tag + ": 接收端 " + std::to_string(kStallTimeout.count()) +
+                "s 无新数据，已结束 Reader: " + std::to_string(ended_readers_.load()) + "/" +
+                std::to_string(count_) + "，强制结束本轮");
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+﻿// ScaleRound.h
+#pragma once
+
+#include "DDSManager_Scale.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * scale:: 与 traffic:: 共用的单轮收发流程（ScaleTest / TrafficTest 都基于 DDSManager_Scale）：
+ * 发送循环、按 Writer 去重的结束包计数、「全部 Reader 结束或长时间无进展」的接收等待。
+ */
+
+constexpr size_t kScaleMaxEntityLines = 32;     // 逐实体结果每类最多打印的行数
+
+inline uint64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 单个 Writer 的发送统计（每个元素只由负责该 Writer 的发送线程写入）
+ */
+struct WriterSendStats {
+    uint64_t sent = 0;
+    uint64_t failed = 0;
+    double seconds = 0.0;           // 所在发送线程的发送耗时
+    std::string rate_summary;       // RateController::summary()
+};
+
+/**
+ * @brief 发送线程主体：按 profile 第 round 轮的包大小 / 数量 / 速率，每个时间片对 writer_indices 中的 Writer 各写一次；
+ * 发送完成后等待确认，再为每个 Writer 发送 3 次结束包（兼容 best-effort Reader），
+ * 包头 source 为 source_base + Writer 下标，供接收端按 Writer 去重。
+ *
+ * @param stats 下标与 manager.writers() 一致
+ * @param log_tag 非空且 profile 配置了 m_sendPrintGap 时按条数打印发送进度
+ */
+void runScaleSender(DDSManager_Scale& manager, const std::vector<size_t>& writer_indices,
+    const ConfigData& profile, int round, uint32_t source_base,
+    std::vector<WriterSendStats>& stats, const char* log_tag);
+
+/**
+ * @brief 按 Reader 记录已发送结束包的 Writer。
+ *
+ * 同一 Writer 的结束包重复发送，按 PacketHeader::source 去重；Reader 收齐预期数量的 Writer 后才算结束，
+ * 避免同一 Topic 有多个 Writer 时被第一个结束包提前截断统计。
+ */
+class EndOfRoundTracker {
+public:
+    static constexpr std::chrono::seconds kStallTimeout{ 10 };    // 接收端无进展判定超时
+
+    EndOfRoundTracker() = default;
+    EndOfRoundTracker(const EndOfRoundTracker&) = delete;
+    EndOfRoundTracker& operator=(const EndOfRoundTracker&) = delete;
+
+    /**
+     * @brief 按 Reader 设置预期 Writer 数（0 按 1 处理）；须在 Reader 创建（监听器可能立即回调）之前调用
+     */
+    void reset(const std::vector<size_t>& expected_writers);
+
+    // DDS 监听线程调用
+    void onEnd(size_t reader_index, uint32_t source);
+
+    size_t readerCount() const { return count_; }
+    bool ended(size_t reader_index) const;
+    size_t endedWriters(size_t reader_index) const;
+    size_t expectedWriters(size_t reader_index) const;
+
+    /**
+     * @brief 等待全部 Reader 结束；progress 返回累计接收样本数，kStallTimeout 内无变化时放弃
+     * @return 全部 Reader 结束返回 true
+     */
+    bool wait(const std::function<uint64_t()>& progress, const std::string& log_tag);
+
+private:
+    struct Entry {
+        std::atomic<bool> ended{ false };
+        mutable std::mutex mtx;
+        std::vector<uint32_t> sources;  // 已收到结束包的 Writer 标识
+        size_t expected = 1;
+    };
+
+    std::unique_ptr<Entry[]> entries_;
+    size_t count_ = 0;
+    std::atomic<size_t> ended_readers_{ 0 };
+    std::mutex mtx_;
+    std::condition_variable cv_;
+};
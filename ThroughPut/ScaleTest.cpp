@@ -0,0 +1,284 @@
+﻿// ScaleTest.cpp
+#include "ScaleTest.h"
+#include "TestRoundResult.h"
+#include "Logger.h"
+#include "ResourceUtilization.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <thread>
+
+using namespace DDS;
+
+ScaleTest::ScaleTest(DDSManager_Scale& manager, ResultCallback callback)
+    : manager_(manager)
+    , result_callback_(std::move(callback))
+{
+}
+
+ScaleTest::~ScaleTest() = default;
+
+ScaleLayout ScaleTest::prepareRound(const ConfigData& config) {
+    layout_ = ScaleLayout::fromConfig(config, config.m_activeLoop);
+
+    // 接收计数须在 Reader 创建（监听器可能立即回调）之前就绪
+    reader_counter_count_ = static_cast<size_t>(layout_.readerCount());
+    reader_counters_.reset(reader_counter_count_ > 0 ? new ReaderCounters[reader_counter_count_] : nullptr);
+    writer_counters_.assign(static_cast<size_t>(layout_.writerCount()), WriterSendStats{});
+    expected_writers_ = static_cast<size_t>(std::max(config.m_remoteNum, 1));
+    end_tracker_.reset(std::vector<size_t>(reader_counter_count_, expected_writers_));
+    // 结束包按 Writer 标识去重：随机起点避免与其他进程的 Writer 标识冲突
+    std::mt19937 gen(std::random_device{}());
+    source_base_ = static_cast<uint32_t>(gen());
+
+    auto& resUtil = ResourceUtilization::instance();
+    resUtil.initialize();
+    pre_create_metrics_ = resUtil.collectCurrentMetrics();
+    pre_create_time_ = std::chrono::steady_clock::now();
+    return layout_;
+}
+
+// ========================
+// 回调（DDS 监听线程）
+// ========================
+
+void ScaleTest::onDataReceived(size_t reader_index, const DDS::Bytes& sample, const DDS::SampleInfo&) {
+    if (reader_index >= reader_counter_count_) return;
+    ReaderCounters& c = reader_counters_[reader_index];
+    const uint64_t now = steadyNowNs();
+    if (c.received.fetch_add(1, std::memory_order_relaxed) == 0) {
+        c.first_ns.store(now, std::memory_order_relaxed);
+    }
+    c.bytes.fetch_add(sample.value.length(), std::memory_order_relaxed);
+    c.last_ns.store(now, std::memory_order_relaxed);
+}
+
+void ScaleTest::onEndOfRound(size_t reader_index, uint32_t source) {
+    end_tracker_.onEnd(reader_index, source);
+}
+
+// ========================
+// 匹配等待
+// ========================
+
+bool ScaleTest::waitForMatch(const std::chrono::seconds& timeout) {
+    std::vector<DataWriter*> writers;
+    writers.reserve(manager_.writers().size());
+    for (const auto& w : manager_.writers()) {
+        writers.push_back(w.writer);
+    }
+    std::vector<DataReader*> readers;
+    readers.reserve(manager_.readers().size());
+    for (const auto& r : manager_.readers()) {
+        readers.push_back(r.reader);
+    }
+    if (writers.empty() && readers.empty()) {
+        return true;
+    }
+
+    Logger::getInstance().logAndPrint("ScaleTest: 等待匹配 | Writer: " + std::to_string(writers.size()) +
+        " | Reader: " + std::to_string(readers.size()));
+    MatchTracker& matches = manager_.match_tracker();
+    if (!matches.waitForEndpoints(writers, {}, readers, {}, timeout)) {
+        return false;
+    }
+    Logger::getInstance().logAndPrint(formatTimeToMatch("ScaleTest", matches.lastTimeToMatchMs()));
+    return true;
+}
+
+// ========================
+// runRound
+// ========================
+
+int ScaleTest::runRound(const ConfigData& config) {
+    const int round_index = config.m_activeLoop;
+    if (manager_.writers().size() != writer_counters_.size() || manager_.readers().size() != reader_counter_count_) {
+        Logger::getInstance().error("ScaleTest: 实体数量与布局不一致，请先调用 prepareRound 再初始化 DDSManager_Scale");
+        return -1;
+    }
+    const double create_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - pre_create_time_).count();
+
+    Logger::getInstance().logAndPrint("第 " + std::to_string(round_index + 1) + " 轮规模测试 | " + layout_.describe());
+    if (!waitForMatch(std::chrono::seconds(config.m_matchTimeoutSec))) {
+        Logger::getInstance().logAndPrint("ScaleTest: 等待匹配超时，按已匹配实体继续");
+    }
+
+    auto& resUtil = ResourceUtilization::instance();
+    SysMetrics start_metrics = resUtil.collectCurrentMetrics();
+    {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2)
+            << "实体创建+匹配耗时: " << create_ms << " ms | 内存增量(工作集): "
+            << (static_cast<long long>(start_metrics.system_working_set_kb) -
+                static_cast<long long>(pre_create_metrics_.system_working_set_kb)) << " KB";
+        const size_t entities = manager_.participant_count() + manager_.writers().size() + manager_.readers().size();
+        if (entities > 0) {
+            oss << " (每实体 " << (static_cast<double>(start_metrics.system_working_set_kb) -
+                static_cast<double>(pre_create_metrics_.system_working_set_kb)) / entities << " KB)";
+        }
+        Logger::getInstance().logAndPrint(oss.str());
+    }
+
+    // 按 Participant 划分发送线程
+    std::map<int, std::vector<size_t>> by_participant;
+    for (size_t i = 0; i < manager_.writers().size(); ++i) {
+        by_participant[manager_.writers()[i].participant].push_back(i);
+    }
+    const auto send_begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> senders;
+    senders.reserve(by_participant.size());
+    for (const auto& kv : by_participant) {
+        senders.emplace_back(runScaleSender, std::ref(manager_), std::cref(kv.second), std::cref(config),
+            round_index, source_base_, std::ref(writer_counters_), nullptr);
+    }
+    for (auto& t : senders) {
+        t.join();
+    }
+    const double send_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - send_begin).count();
+
+    if (reader_counter_count_ > 0) {
+        end_tracker_.wait([this] {
+            uint64_t total = 0;
+            for (size_t i = 0; i < reader_counter_count_; ++i) {
+                total += reader_counters_[i].received.load(std::memory_order_relaxed);
+            }
+            return total;
+            }, "ScaleTest");
+    }
+
+    SysMetrics end_metrics = resUtil.collectCurrentMetrics();
+    TestRoundResult round_result{ round_index + 1, start_metrics, end_metrics };
+    report(config, start_metrics, end_metrics, send_seconds, round_result.perf);
+    round_result.perf.time_to_match_ms = manager_.match_tracker().lastTimeToMatchMs();
+    if (result_callback_) {
+        result_callback_(round_result);
+    }
+    return 0;
+}
+
+// ========================
+// 报告
+// ========================
+
+void ScaleTest::report(const ConfigData& config, const SysMetrics& start_metrics, const SysMetrics& end_metrics,
+    double send_seconds, RoundPerformance& perf) {
+    const int round_index = config.m_activeLoop;
+    const uint64_t expected_per_reader = static_cast<uint64_t>(config.m_sendCount[round_index]) * expected_writers_;
+    const auto& writers = manager_.writers();
+    const auto& readers = manager_.readers();
+
+    // --- 每实体 ---
+    uint64_t total_sent = 0;
+    uint64_t total_failed = 0;
+    for (size_t i = 0; i < writers.size(); ++i) {
+        const WriterSendStats& c = writer_counters_[i];
+        total_sent += c.sent;
+        total_failed += c.failed;
+        if (i < kScaleMaxEntityLines) {
+            Logger::getInstance().logAndPrint("  Writer[" + std::to_string(i) + "] dp=" + std::to_string(writers[i].participant) +
+                " topic=" + std::to_string(writers[i].topic) + " | 发送: " + std::to_string(c.sent) +
+                " | 失败: " + std::to_string(c.failed));
+        }
+    }
+    if (writers.size() > kScaleMaxEntityLines) {
+        Logger::getInstance().logAndPrint("  ... 其余 " + std::to_string(writers.size() - kScaleMaxEntityLines) + " 个 Writer 已省略");
+    }
+
+    uint64_t total_received = 0;
+    uint64_t total_bytes = 0;
+    uint64_t first_ns = UINT64_MAX;
+    uint64_t last_ns = 0;
+    double min_reader_pps = 0.0;
+    double max_reader_pps = 0.0;
+    for (size_t i = 0; i < reader_counter_count_; ++i) {
+        const ReaderCounters& c = reader_counters_[i];
+        const uint64_t received = c.received.load();
+        const uint64_t f = c.first_ns.load();
+        const uint64_t l = c.last_ns.load();
+        const double seconds = (received > 1 && l > f) ? (l - f) / 1e9 : 0.0;
+        const double pps = seconds > 0 ? received / seconds : 0.0;
+        total_received += received;
+        total_bytes += c.bytes.load();
+        if (received > 0) {
+            first_ns = std::min(first_ns, f);
+            last_ns = std::max(last_ns, l);
+        }
+        min_reader_pps = (i == 0) ? pps : std::min(min_reader_pps, pps);
+        max_reader_pps = std::max(max_reader_pps, pps);
+        if (i < kScaleMaxEntityLines) {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(2)
+                << "  Reader[" << i << "] dp=" << readers[i].participant << " topic=" << readers[i].topic
+                << " | 接收: " << received
+                << " | 丢失: " << (expected_per_reader > received ? expected_per_reader - received : 0)
+                << " | 吞吐: " << pps << " pps";
+            if (!end_tracker_.ended(i)) {
+                oss << " | 结束包: " << end_tracker_.endedWriters(i) << "/" << end_tracker_.expectedWriters(i);
+            }
+            Logger::getInstance().logAndPrint(oss.str());
+        }
+    }
+    if (reader_counter_count_ > kScaleMaxEntityLines) {
+        Logger::getInstance().logAndPrint("  ... 其余 " + std::to_string(reader_counter_count_ - kScaleMaxEntityLines) + " 个 Reader 已省略");
+    }
+
+    // --- 汇总 ---
+    const double recv_seconds = (last_ns > first_ns && first_ns != UINT64_MAX) ? (last_ns - first_ns) / 1e9 : 0.0;
+    const uint64_t expected_total = expected_per_reader * reader_counter_count_;
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "规模测试结果 | 第 " << (round_index + 1) << " 轮"
+        << " | Participant: " << manager_.participant_count()
+        << " | Writer: " << writers.size()
+        << " | Reader: " << reader_counter_count_;
+    if (!writers.empty()) {
+        oss << " | 总发送: " << total_sent << " (失败 " << total_failed << ")"
+            << " | 发送速率: " << (send_seconds > 0 ? total_sent / send_seconds : 0.0) << " msg/s";
+    }
+    if (reader_counter_count_ > 0) {
+        oss << " | 总接收: " << total_received
+            << " | 丢包率: " << (expected_total > 0 && expected_total > total_received
+                ? (expected_total - total_received) * 100.0 / expected_total : 0.0) << "%"
+            << " | 接收速率: " << (recv_seconds > 0 ? total_received / recv_seconds : 0.0) << " msg/s"
+            << " | 带宽: " << (recv_seconds > 0 ? total_bytes * 8.0 / (1024.0 * 1024.0) / recv_seconds : 0.0) << " Mbps"
+            << " | 单 Reader 吞吐: [" << min_reader_pps << ", " << max_reader_pps << "] pps";
+    }
+    Logger::getInstance().logAndPrint(oss.str());
+
+    // 有 Reader 时按接收端口径（与日志汇总一致），纯发送布局按发送端口径
+    perf.role = "scale";
+    perf.sent = total_sent;
+    if (reader_counter_count_ > 0) {
+        perf.payload_bytes = total_received > 0 ? static_cast<int>(total_bytes / total_received) : config.m_minSize[round_index];
+        perf.received = total_received;
+        perf.lost = expected_total > total_received ? expected_total - total_received : 0;
+        perf.loss_rate_percent = expected_total > 0 ? perf.lost * 100.0 / expected_total : 0.0;
+        perf.duration_ms = recv_seconds * 1000.0;
+        if (recv_seconds > 0) {
+            perf.msgs_per_sec = total_received / recv_seconds;
+            perf.mb_per_sec = total_bytes / recv_seconds / (1024.0 * 1024.0);
+        }
+    }
+    else {
+        perf.payload_bytes = config.m_minSize[round_index];
+        perf.duration_ms = send_seconds * 1000.0;
+        if (send_seconds > 0) {
+            perf.msgs_per_sec = total_sent / send_seconds;
+            perf.mb_per_sec = total_sent * static_cast<double>(perf.payload_bytes) / send_seconds / (1024.0 * 1024.0);
+        }
+    }
+
+    std::ostringstream res;
+    res << std::fixed << std::setprecision(2)
+        << "规模测试资源 | CPU 峰值: " << end_metrics.cpu_usage_percent_peak << "%"
+        << " | 工作集: " << end_metrics.system_working_set_kb << " KB"
+        << " (峰值 " << end_metrics.system_peak_working_set_kb << " KB)"
+        << " | 内存池: " << end_metrics.memory_current_kb << " KB"
+        << " | 测试期间工作集变化: " << (static_cast<long long>(end_metrics.system_working_set_kb) -
+            static_cast<long long>(start_metrics.system_working_set_kb)) << " KB";
+    Logger::getInstance().logAndPrint(res.str());
+}
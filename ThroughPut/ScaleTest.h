@@ -0,0 +1,76 @@
+﻿// ScaleTest.h
+#pragma once
+
+#include "DDSManager_Scale.h"
+#include "ScaleRound.h"
+#include "SysMetrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+struct TestRoundResult;
+struct RoundPerformance;
+
+/**
+ * @brief scale:: 模式测试：在单进程内驱动 DDSManager_Scale 创建的全部 Writer / Reader。
+ *
+ * 每轮流程：prepareRound()（按布局分配接收计数并记录建实体前的资源）→ DDSManager_Scale::initialize()
+ * → runRound()（发送线程按 Participant 划分，每个时间片对线程内所有 Writer 各写一次；
+ * 接收端等待全部 Reader 收到 m_remoteNum 个 Writer 的结束包或长时间无进展）→ DDSManager_Scale::shutdown()。
+ * 结果包含每个实体的收发统计，以及汇总吞吐、CPU 峰值与实体创建带来的内存增量。
+ */
+class ScaleTest {
+public:
+    using ResultCallback = std::function<void(const TestRoundResult&)>;
+
+    explicit ScaleTest(DDSManager_Scale& manager, ResultCallback callback = nullptr);
+    ~ScaleTest();
+
+    ScaleTest(const ScaleTest&) = delete;
+    ScaleTest& operator=(const ScaleTest&) = delete;
+
+    /**
+     * @brief 在 DDSManager_Scale::initialize() 之前调用，返回本轮布局
+     */
+    ScaleLayout prepareRound(const ConfigData& config);
+
+    /**
+     * @brief 运行单轮规模测试
+     * @return 0 成功，非0 失败
+     */
+    int runRound(const ConfigData& config);
+
+    void onDataReceived(size_t reader_index, const DDS::Bytes& sample, const DDS::SampleInfo& info);
+    void onEndOfRound(size_t reader_index, uint32_t source);
+
+private:
+    struct ReaderCounters {
+        std::atomic<uint64_t> received{ 0 };
+        std::atomic<uint64_t> bytes{ 0 };
+        std::atomic<uint64_t> first_ns{ 0 };
+        std::atomic<uint64_t> last_ns{ 0 };
+    };
+
+    bool waitForMatch(const std::chrono::seconds& timeout);
+    // 输出每实体与汇总结果，并把汇总写入 perf（结果文件的一行）
+    void report(const ConfigData& config, const SysMetrics& start_metrics, const SysMetrics& end_metrics,
+        double send_seconds, RoundPerformance& perf);
+
+    DDSManager_Scale& manager_;
+    ResultCallback result_callback_;
+
+    ScaleLayout layout_;
+    std::unique_ptr<ReaderCounters[]> reader_counters_;
+    size_t reader_counter_count_ = 0;
+    size_t expected_writers_ = 1;                    // 每个 Reader 预期的 Writer 数（m_remoteNum，含进程外）
+    std::vector<WriterSendStats> writer_counters_;   // 每个元素只由负责该 Writer 的发送线程写入
+    uint32_t source_base_ = 0;                       // 本轮 Writer 标识起点（随机），Writer i 的标识为 source_base_ + i
+    EndOfRoundTracker end_tracker_;
+
+    SysMetrics pre_create_metrics_;
+    std::chrono::steady_clock::time_point pre_create_time_;
+};
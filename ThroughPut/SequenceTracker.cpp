@@ -0,0 +1,141 @@
+﻿// SequenceTracker.cpp
+#include "SequenceTracker.h"
+
+#include <cstring>
+#include <sstream>
+
+SequenceTracker::SequenceTracker()
+    : bitmap_(new uint64_t[kWordCount])
+{
+    reset();
+}
+
+void SequenceTracker::reset() {
+    std::memset(bitmap_.get(), 0, kWordCount * sizeof(uint64_t));
+    highest_ = -1;
+    current_run_ = 0;
+    finalized_ = false;
+    received_.store(0, std::memory_order_relaxed);
+    duplicates_.store(0, std::memory_order_relaxed);
+    lost_.store(0, std::memory_order_relaxed);
+    gap_count_.store(0, std::memory_order_relaxed);
+    max_burst_loss_.store(0, std::memory_order_relaxed);
+    reordered_.store(0, std::memory_order_relaxed);
+    max_reorder_depth_.store(0, std::memory_order_relaxed);
+    too_late_.store(0, std::memory_order_relaxed);
+    highest_published_.store(-1, std::memory_order_relaxed);
+}
+
+void SequenceTracker::addLostRun(uint64_t count) {
+    if (count == 0) return;
+    if (current_run_ == 0) {
+        add(gap_count_, 1);
+    }
+    current_run_ += count;
+    add(lost_, count);
+}
+
+void SequenceTracker::closeLostRun() {
+    if (current_run_ > max_burst_loss_.load(std::memory_order_relaxed)) {
+        max_burst_loss_.store(current_run_, std::memory_order_relaxed);
+    }
+    current_run_ = 0;
+}
+
+void SequenceTracker::evict(bool was_received) {
+    if (was_received) {
+        if (current_run_ > 0) closeLostRun();
+    }
+    else {
+        addLostRun(1);
+    }
+}
+
+void SequenceTracker::record(uint32_t sequence) {
+    add(received_, 1);
+    const int64_t seq = static_cast<int64_t>(sequence);
+    const int64_t window = static_cast<int64_t>(kWindowSize);
+
+    if (seq > highest_) {
+        // 窗口前移：(highest_, seq] 中每个位置对应的旧序列号 p - window 滑出窗口
+        int64_t from = highest_ + 1;
+        if (seq - highest_ > window) {
+            // 跳跃超过整个窗口：先逐个结算旧窗口，再把从未进入窗口的区间直接计为丢失
+            for (int64_t q = highest_ - window + 1; q <= highest_; ++q) {
+                if (q >= 0) evict(testBit(static_cast<uint64_t>(q)));
+            }
+            addLostRun(static_cast<uint64_t>(seq - window - highest_));
+            std::memset(bitmap_.get(), 0, kWordCount * sizeof(uint64_t));
+            from = seq + 1; // 已全部清空，无需再逐位处理
+        }
+        for (int64_t p = from; p <= seq; ++p) {
+            int64_t q = p - window;
+            if (q >= 0) {
+                evict(testBit(static_cast<uint64_t>(q)));
+            }
+            clearBit(static_cast<uint64_t>(p));
+        }
+        setBit(static_cast<uint64_t>(seq));
+        highest_ = seq;
+        highest_published_.store(seq, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint64_t depth = static_cast<uint64_t>(highest_ - seq);
+    if (depth >= kWindowSize) {
+        add(too_late_, 1); // 已滑出窗口并计为丢失，无法再区分是否重复
+        return;
+    }
+    if (testBit(static_cast<uint64_t>(seq))) {
+        add(duplicates_, 1);
+        return;
+    }
+    setBit(static_cast<uint64_t>(seq));
+    add(reordered_, 1);
+    if (depth > max_reorder_depth_.load(std::memory_order_relaxed)) {
+        max_reorder_depth_.store(depth, std::memory_order_relaxed);
+    }
+}
+
+void SequenceTracker::finalize(uint64_t expected_count) {
+    if (finalized_) return; // 避免重复结算
+    const int64_t window = static_cast<int64_t>(kWindowSize);
+    for (int64_t q = highest_ - window + 1; q <= highest_; ++q) {
+        if (q >= 0) evict(testBit(static_cast<uint64_t>(q)));
+    }
+    if (expected_count > static_cast<uint64_t>(highest_ + 1)) {
+        addLostRun(expected_count - static_cast<uint64_t>(highest_ + 1));
+    }
+    closeLostRun();
+    finalized_ = true;
+}
+
+std::string formatSequenceStats(const SequenceStats& stats) {
+    std::ostringstream oss;
+    oss << "序列号统计 | 有效: " << stats.unique
+        << " | 重复: " << stats.duplicates
+        << " | 丢失: " << stats.lost
+        << " | 丢失段: " << stats.gap_count
+        << " | 最长连续丢失: " << stats.max_burst_loss
+        << " | 乱序: " << stats.reordered
+        << " | 最大乱序深度: " << stats.max_reorder_depth;
+    if (stats.too_late > 0) {
+        oss << " | 超窗迟到: " << stats.too_late;
+    }
+    return oss.str();
+}
+
+SequenceStats SequenceTracker::snapshot() const {
+    SequenceStats s;
+    s.received = received_.load(std::memory_order_relaxed);
+    s.duplicates = duplicates_.load(std::memory_order_relaxed);
+    s.too_late = too_late_.load(std::memory_order_relaxed);
+    s.unique = s.received - s.duplicates - s.too_late;
+    s.lost = lost_.load(std::memory_order_relaxed);
+    s.gap_count = gap_count_.load(std::memory_order_relaxed);
+    s.max_burst_loss = max_burst_loss_.load(std::memory_order_relaxed);
+    s.reordered = reordered_.load(std::memory_order_relaxed);
+    s.max_reorder_depth = max_reorder_depth_.load(std::memory_order_relaxed);
+    s.highest_sequence = highest_published_.load(std::memory_order_relaxed);
+    return s;
+}
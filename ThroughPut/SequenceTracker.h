@@ -0,0 +1,101 @@
+﻿// SequenceTracker.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * @brief 序列号统计快照（由 SequenceTracker::snapshot() 返回）
+ */
+struct SequenceStats {
+    uint64_t received = 0;          // 收到的样本总数（含重复）
+    uint64_t unique = 0;            // 去重后的样本数
+    uint64_t duplicates = 0;        // 重复样本数
+    uint64_t lost = 0;              // 判定丢失的序列号数
+    uint64_t gap_count = 0;         // 丢失段个数（连续缺失的区间数）
+    uint64_t max_burst_loss = 0;    // 最长连续丢失长度
+    uint64_t reordered = 0;         // 乱序到达（晚于更大序列号）的样本数
+    uint64_t max_reorder_depth = 0; // 最大乱序深度（到达时与当前最大序列号之差）
+    uint64_t too_late = 0;          // 滑出窗口后才到达的样本数（已计为丢失）
+    int64_t  highest_sequence = -1; // 目前收到的最大序列号
+};
+
+/**
+ * @brief 将序列号统计格式化为单行日志文本
+ */
+std::string formatSequenceStats(const SequenceStats& stats);
+
+/**
+ * @brief 基于滑动位图的序列号跟踪器，用于吞吐测试接收端统计丢包、重复和乱序。
+ *
+ * 位图窗口覆盖 [highest - kWindowSize + 1, highest]，序列号滑出窗口时若仍未收到则判定为丢失，
+ * 同时累计连续丢失段长度。每个样本仅需 O(1) 次位操作，不加锁、不分配内存。
+ *
+ * 约定：record() 只由单个线程（DDS 监听线程）调用；统计计数使用原子变量，
+ * 可由其他线程随时通过 snapshot() 读取。reset()/finalize() 应在没有数据到达时调用。
+ */
+class SequenceTracker {
+public:
+    static constexpr uint64_t kWindowSize = 1ull << 16;     // 窗口大小（序列号个数）
+    static constexpr size_t kWordCount = static_cast<size_t>(kWindowSize / 64);
+
+    SequenceTracker();
+    ~SequenceTracker() = default;
+
+    SequenceTracker(const SequenceTracker&) = delete;
+    SequenceTracker& operator=(const SequenceTracker&) = delete;
+
+    /**
+     * @brief 清空所有状态，开始新一轮统计
+     */
+    void reset();
+
+    /**
+     * @brief 记录一个收到的序列号
+     */
+    void record(uint32_t sequence);
+
+    /**
+     * @brief 本轮结束时调用：将窗口内剩余缺失及 [highest+1, expected_count) 计为丢失
+     * @param expected_count 本轮发送端预期发送的数量（序列号从 0 开始）
+     */
+    void finalize(uint64_t expected_count);
+
+    /**
+     * @brief 获取当前统计快照
+     */
+    SequenceStats snapshot() const;
+
+private:
+    bool testBit(uint64_t seq) const {
+        return (bitmap_[(seq / 64) % kWordCount] >> (seq % 64)) & 1ull;
+    }
+    void setBit(uint64_t seq) { bitmap_[(seq / 64) % kWordCount] |= (1ull << (seq % 64)); }
+    void clearBit(uint64_t seq) { bitmap_[(seq / 64) % kWordCount] &= ~(1ull << (seq % 64)); }
+
+    // 序列号滑出窗口时调用，累计丢包和连续丢失段
+    void evict(bool was_received);
+    void addLostRun(uint64_t count);
+    void closeLostRun();
+    static void add(std::atomic<uint64_t>& counter, uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<uint64_t[]> bitmap_;
+    int64_t highest_ = -1;          // 仅 record() 线程访问
+    uint64_t current_run_ = 0;      // 当前连续丢失长度
+    bool finalized_ = false;
+
+    std::atomic<uint64_t> received_{ 0 };
+    std::atomic<uint64_t> duplicates_{ 0 };
+    std::atomic<uint64_t> lost_{ 0 };
+    std::atomic<uint64_t> gap_count_{ 0 };
+    std::atomic<uint64_t> max_burst_loss_{ 0 };
+    std::atomic<uint64_t> reordered_{ 0 };
+    std::atomic<uint64_t> max_reorder_depth_{ 0 };
+    std::atomic<uint64_t> too_late_{ 0 };
+    std::atomic<int64_t> highest_published_{ -1 };
+};
@@ -1,8 +1,47 @@
 #pragma once
 #include "SysMetrics.h"
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
+// 单个采样区间（默认 100ms）的测量结果，由 IntervalRecorder 填充
+struct IntervalSample {
+    double elapsed_ms = 0.0;        // 区间结束时距本轮开始的时间
+    uint64_t messages = 0;          // 本区间内发送/接收的消息数
+    double msgs_per_sec = 0.0;
+    double mb_per_sec = 0.0;
+    uint64_t lost = 0;              // 本区间内新增的丢包数（仅订阅端）
+    uint64_t latency_count = 0;     // 本区间内的时延样本数（仅时延测试）
+    double latency_p50_us = 0.0;
+    double latency_p99_us = 0.0;
+    double latency_max_us = 0.0;
+    double cpu_percent = -1.0;      // 区间结束时最近一次 CPU 采样值，-1 为无数据
+    unsigned long long memory_kb = 0; // GloMemPool 当前占用
+};
+
+// 本轮性能结果，由测试引擎在回调前填充；未测量的字段保持默认值（0 / 空）
+struct RoundPerformance {
+    std::string role;               // publisher / subscriber / initiator
+    int payload_bytes = 0;          // 平均包长
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    uint64_t lost = 0;
+    double loss_rate_percent = 0.0;
+    double duration_ms = 0.0;
+    double time_to_match_ms = 0.0;  // 端点匹配耗时（见 MatchTracker::lastTimeToMatchMs）
+    double msgs_per_sec = 0.0;
+    double mb_per_sec = 0.0;
+    uint64_t latency_count = 0;     // 时延样本数（仅时延测试）
+    double latency_min_us = 0.0;
+    double latency_mean_us = 0.0;
+    double latency_p50_us = 0.0;
+    double latency_p90_us = 0.0;
+    double latency_p99_us = 0.0;
+    double latency_p999_us = 0.0;
+    double latency_max_us = 0.0;
+};
+
 struct TestRoundResult {
     int round_index;              // 第几轮
     SysMetrics start_metrics;     // 开始时的资源状态
@@ -11,6 +50,12 @@ struct TestRoundResult {
     // 可选：中间采样点（用于绘制趋势图）
     std::vector<SysMetrics> samples;
 
+    // 每个采样区间的吞吐 / 丢包 / 时延 / 资源，与 samples 一一对应
+    std::vector<IntervalSample> intervals;
+
+    // 本轮吞吐 / 丢包 / 时延汇总（写入结果文件）
+    RoundPerformance perf;
+
     // --- 新增：存储整轮测试的 CPU 使用率历史记录 ---
     // 使用 float 可能比 double 节省一些内存，精度对 CPU % 通常也足够
     std::vector<float> cpu_usage_history;
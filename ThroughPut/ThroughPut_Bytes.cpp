@@ -10,53 +10,24 @@
 #include "ZRDDSDataReader.h"
 #include "ZRBuiltinTypes.h"
 
+#include "RateController.h"
+#include "IntervalRecorder.h"
+#include "PacketHeader.h"
+
 #include <thread>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <random>
+#include <vector>
 
 using namespace DDS;
-struct PacketHeader {
-    uint32_t sequence;     // 序列号
-    //uint64_t timestamp;    // 发送时间（纳秒）
-    uint8_t  packet_type;
-};
-
-// ========================
-// 内部类：WriterListener
-// ========================
-
-class Throughput_Bytes::WriterListener : public virtual DDS::DataWriterListener {
-public:
-    WriterListener(std::atomic<bool>& flag, std::mutex& mtx, std::condition_variable& cv)
-        : reconnected_flag_(flag), mutex_(mtx), cond_var_(cv), last_current_count_(0) {
-    }
-
-    void on_liveliness_lost(DataWriter*, const LivelinessLostStatus&) override {}
-    void on_offered_deadline_missed(DataWriter*, const OfferedDeadlineMissedStatus&) override {}
-    void on_offered_incompatible_qos(DataWriter*, const OfferedIncompatibleQosStatus&) override {}
-    void on_publication_matched(DataWriter*, const PublicationMatchedStatus&) override {}
-
-    /*void on_subscription_matched(DataWriter*, const SubscriptionMatchedStatus& status) override {
-        int32_t current = status.current_count;
-        int32_t previous = last_current_count_.load();
-
-        last_current_count_.store(current);
 
-        if (current > 0 && previous == 0) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            reconnected_flag_.store(true);
-            cond_var_.notify_all();
-            Logger::getInstance().logAndPrint("Throughput_Bytes: 检测到订阅者重新上线");
-        }
-    }*/
-
-private:
-    std::atomic<bool>& reconnected_flag_;
-    std::mutex& mutex_;
-    std::condition_variable& cond_var_;
-    std::atomic<int32_t> last_current_count_;
-};
+namespace {
+    // m_roundIdleTimeoutSec 为 0 时的无数据等待上限
+    constexpr auto kMaxRoundIdle = std::chrono::minutes(60);
+}
 
 // ========================
 // 构造函数 & 析构
@@ -65,21 +36,7 @@ private:
 Throughput_Bytes::Throughput_Bytes(DDSManager_Bytes& ddsManager, ResultCallback callback)
     : ddsManager_(ddsManager)
     , result_callback_(std::move(callback))
-    , subscriber_reconnected_(false)
 {
-    writer_listener_ = std::make_unique<WriterListener>(
-        subscriber_reconnected_,
-        reconnect_mtx_,
-        reconnect_cv_
-    );
-
-    DataWriter* writer = ddsManager_.get_data_writer();
-    if (writer) {
-        ReturnCode_t ret = writer->set_listener(writer_listener_.get(), DDS::SUBSCRIPTION_MATCHED_STATUS);
-        if (ret != DDS::RETCODE_OK) {
-            Logger::getInstance().logAndPrint("警告：无法为 DataWriter 设置监听器");
-        }
-    }
 }
 
 Throughput_Bytes::~Throughput_Bytes() = default;
@@ -89,56 +46,61 @@ Throughput_Bytes::~Throughput_Bytes() = default;
 // ========================
 
 bool Throughput_Bytes::waitForSubscriberReconnect(const std::chrono::seconds& timeout) {
-    std::unique_lock<std::mutex> lock(reconnect_mtx_);
-    subscriber_reconnected_ = false;
-    return reconnect_cv_.wait_for(lock, timeout, [this] { return subscriber_reconnected_.load(); });
+    // 每轮重建的 Writer 挂有 MatchTracker 的匹配监听器，订阅者上线即唤醒
+    DataWriter* writer = ddsManager_.get_data_writer();
+    return writer && ddsManager_.match_tracker().waitForWriters({ writer }, timeout);
 }
 
-void Throughput_Bytes::waitForRoundEnd() {
+bool Throughput_Bytes::waitForRoundEnd(std::chrono::seconds idle_timeout) {
+    // 按「持续无新数据」判定超时：长轮次只要数据仍在到达就继续等待
+    const std::chrono::seconds slice = idle_timeout.count() > 0
+        ? idle_timeout : std::chrono::duration_cast<std::chrono::seconds>(kMaxRoundIdle);
+
     std::unique_lock<std::mutex> lock(mtx_);
-    cv_.wait(lock, [this] { return roundFinished_.load(); });
+    int last = receivedCount_.load(std::memory_order_relaxed);
+    while (!cv_.wait_for(lock, slice, [this] { return roundFinished_.load(); })) {
+        const int now = receivedCount_.load(std::memory_order_relaxed);
+        if (now == last) {
+            roundFinished_.store(true);   // 此后到达的本轮结束包不再改写结果
+            return false;
+        }
+        last = now;
+    }
+    return true;
 }
 
-bool Throughput_Bytes::waitForWriterMatch() {
+bool Throughput_Bytes::waitForWriterMatch(std::chrono::milliseconds timeout) {
     auto writer = ddsManager_.get_data_writer();
     if (!writer) return false;
 
-    while (true) {
-        PublicationMatchedStatus status{};
-        ReturnCode_t ret = writer->get_publication_matched_status(status);
-        if (ret == RETCODE_OK) {
-            Logger::getInstance().logAndPrint(
-                "Writer wait match(" + std::to_string(status.current_count) + "/1)"
-            );
-            if (status.current_count > 0) return true;
-        }
-        else {
-            Logger::getInstance().logAndPrint("Error: Failed to get publication matched status.");
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
+    Logger::getInstance().logAndPrint("Writer 等待匹配...");
+    MatchTracker& matches = ddsManager_.match_tracker();
+    if (!matches.waitForWriters({ writer }, timeout)) return false;
+    Logger::getInstance().logAndPrint(formatTimeToMatch("Writer", matches.lastTimeToMatchMs()));
+    return true;
+}
+
+bool Throughput_Bytes::waitForSenderWritersMatch(std::chrono::milliseconds timeout) {
+    const auto& sender_writers = ddsManager_.get_sender_writers();
+    if (sender_writers.empty()) return false;
+
+    Logger::getInstance().logAndPrint("Sender writers 等待匹配（" + std::to_string(sender_writers.size()) + " 个）...");
+    std::vector<DataWriter*> writers(sender_writers.begin(), sender_writers.end());
+    MatchTracker& matches = ddsManager_.match_tracker();
+    if (!matches.waitForWriters(writers, timeout)) return false;
+    Logger::getInstance().logAndPrint(formatTimeToMatch("Sender writers", matches.lastTimeToMatchMs()));
+    return true;
 }
 
-bool Throughput_Bytes::waitForReaderMatch() {
+bool Throughput_Bytes::waitForReaderMatch(std::chrono::milliseconds timeout) {
     auto reader = ddsManager_.get_data_reader();
     if (!reader) return false;
 
-    while (true) {
-        SubscriptionMatchedStatus status{};
-        ReturnCode_t ret = reader->get_subscription_matched_status(status);
-        if (ret == RETCODE_OK) {
-            Logger::getInstance().logAndPrint(
-                "Reader wait match(" + std::to_string(status.current_count) + "/1)"
-            );
-            if (status.current_count > 0) return true;
-        }
-        else {
-            Logger::getInstance().logAndPrint("Error: Failed to get subscription matched status.");
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
+    Logger::getInstance().logAndPrint("Reader 等待匹配...");
+    MatchTracker& matches = ddsManager_.match_tracker();
+    if (!matches.waitForReaders({ reader }, timeout)) return false;
+    Logger::getInstance().logAndPrint(formatTimeToMatch("Reader", matches.lastTimeToMatchMs()));
+    return true;
 }
 
 // ========================
@@ -146,6 +108,10 @@ bool Throughput_Bytes::waitForReaderMatch() {
 // ========================
 
 int Throughput_Bytes::runPublisher(const ConfigData& config) {
+    if (config.m_sendThreadNum > 1) {
+        return runPublisherMultiThread(config);
+    }
+
     using WriterType = DDS::ZRDDSDataWriter<DDS::Bytes>;
     WriterType* writer = dynamic_cast<WriterType*>(ddsManager_.get_data_writer());
     if (!writer) {
@@ -159,7 +125,7 @@ int Throughput_Bytes::runPublisher(const ConfigData& config) {
     const int sendCount = config.m_sendCount[round_index];
     const int sendPrintGap = config.m_sendPrintGap[round_index];
 
-    if (!waitForWriterMatch()) {
+    if (!waitForWriterMatch(std::chrono::seconds(config.m_matchTimeoutSec))) {
         Logger::getInstance().logAndPrint("Throughput_Bytes: 等待 Subscriber 匹配超时");
         return -1;
     }
@@ -171,6 +137,7 @@ int Throughput_Bytes::runPublisher(const ConfigData& config) {
 
     auto& resUtil = ResourceUtilization::instance();
     resUtil.initialize();
+    resUtil.registerCurrentThread("sender");
     SysMetrics start_metrics = resUtil.collectCurrentMetrics();
 
     DDS::Bytes sample;
@@ -187,16 +154,38 @@ int Throughput_Bytes::runPublisher(const ConfigData& config) {
         Logger::getInstance().error("Throughput_Bytes: 内存 buffer 为空");
         return -1;
     }
+    const uint32_t round_tag = static_cast<uint32_t>(round_index + 1);
+    reinterpret_cast<PacketHeader*>(buffer)->round = round_tag;
+
+    // === 区间采样：发送线程只做 relaxed store，由采样线程读取 ===
+    const uint64_t payload_bytes = sample.value.length();
+    std::atomic<uint64_t> sent_progress{ 0 };
+    IntervalRecorder recorder(config.m_sampleIntervalMs);
+    recorder.start([&sent_progress, payload_bytes] {
+        IntervalRecorder::Counters c;
+        c.messages = sent_progress.load(std::memory_order_relaxed);
+        c.bytes = c.messages * payload_bytes;
+        return c;
+        });
+
+    // === 速率控制（m_sendDelay 为 0 时饱和发送）===
+    RateController rate(config, round_index);
+    Logger::getInstance().logAndPrint(rate.describe());
+    rate.start();
+    const auto send_begin = std::chrono::steady_clock::now();
 
     // === 发送主循环 ===
+    uint64_t sent = 0;
     for (int j = 0; j < sendCount; ++j) {
+        rate.waitNext();
         *reinterpret_cast<uint32_t*>(buffer) = j;
 
         DDS::ReturnCode_t ret = writer->write(sample, DDS_HANDLE_NIL_NATIVE);
         if (ret == DDS::RETCODE_OK) {
-            static int cnt = 0;
-            if (++cnt % sendPrintGap == 0) {
-                Logger::getInstance().logAndPrint("已发送 " + std::to_string(cnt) + " 条");
+            ++sent;
+            sent_progress.store(sent, std::memory_order_relaxed);
+            if (sendPrintGap > 0 && sent % sendPrintGap == 0) {
+                Logger::getInstance().logAndPrint("已发送 " + std::to_string(sent) + " 条");
             }
         }
         else {
@@ -204,14 +193,32 @@ int Throughput_Bytes::runPublisher(const ConfigData& config) {
         }
     }
 
+    const double send_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - send_begin).count();
+    if (rate.enabled()) {
+        Logger::getInstance().logAndPrint(rate.summary(sent));
+    }
+
     // 等待所有数据被确认
     writer->wait_for_acknowledgments({ 10, 0 });  // 10秒超时
 
+    TestRoundResult round_result;
+    recorder.stopInto(round_result);
+    round_result.perf.role = "publisher";
+    round_result.perf.time_to_match_ms = ddsManager_.match_tracker().lastTimeToMatchMs();
+    round_result.perf.payload_bytes = static_cast<int>(payload_bytes);
+    round_result.perf.sent = sent;
+    round_result.perf.duration_ms = send_seconds * 1000.0;
+    if (send_seconds > 0) {
+        round_result.perf.msgs_per_sec = sent / send_seconds;
+        round_result.perf.mb_per_sec = sent * payload_bytes / send_seconds / (1024.0 * 1024.0);
+    }
+
     // === 发送结束包（标记本轮结束）===
     // === 发送结束包 ===
     // 发送结束包
     ddsManager_.cleanupBytesData(sample);
     if (ddsManager_.prepareEndBytesData(sample, minSize)) {
+        reinterpret_cast<PacketHeader*>(sample.value.get_contiguous_buffer())->round = round_tag;
         if (sample.value.length() > 0) {
             Logger::getInstance().logAndPrint("发送结束包，长度=" + std::to_string(sample.value.length()));
         }
@@ -228,9 +235,213 @@ int Throughput_Bytes::runPublisher(const ConfigData& config) {
     ddsManager_.cleanupBytesData(sample);
 
     // 收集资源使用情况
-    SysMetrics end_metrics = resUtil.collectCurrentMetrics();
+    round_result.round_index = round_index + 1;
+    round_result.start_metrics = start_metrics;
+    round_result.end_metrics = resUtil.collectCurrentMetrics();
     if (result_callback_) {
-        result_callback_(TestRoundResult{ round_index + 1, start_metrics, end_metrics });
+        result_callback_(round_result);
+    }
+
+    Logger::getInstance().logAndPrint("第 " + std::to_string(round_index + 1) + " 轮发送完成");
+    return 0;
+}
+
+// ========================
+// runPublisherMultiThread - 多线程发送
+// ========================
+// 本轮 m_sendCount 条按序列号交错分给 N 个线程（线程 t 发送 t, t+N, t+2N ...），
+// 接收端看到的仍是 [0, m_sendCount) 的完整序列号，丢包统计不受影响；
+// 跨 Writer 的到达顺序不保证，订阅端的乱序计数会相应增加。
+// 速率控制按线程独立生效，总目标速率为单线程配置的 N 倍。
+
+int Throughput_Bytes::runPublisherMultiThread(const ConfigData& config) {
+    using WriterType = DDS::ZRDDSDataWriter<DDS::Bytes>;
+
+    const int round_index = config.m_activeLoop;
+    const int minSize = config.m_minSize[round_index];
+    const int maxSize = config.m_maxSize[round_index];
+    const int sendCount = config.m_sendCount[round_index];
+    const int sendPrintGap = config.m_sendPrintGap[round_index];
+    const int threadNum = config.m_sendThreadNum;
+
+    const std::vector<WriterType*>& writers = ddsManager_.get_sender_writers();
+    if (writers.empty() || std::find(writers.begin(), writers.end(), nullptr) != writers.end()) {
+        Logger::getInstance().logAndPrint("Throughput_Bytes: DataWriter 为空，无法发送");
+        return -1;
+    }
+    const bool shared = writers.size() == 1;
+
+    if (!waitForSenderWritersMatch(std::chrono::seconds(config.m_matchTimeoutSec))) {
+        Logger::getInstance().logAndPrint("Throughput_Bytes: 等待 Subscriber 匹配超时");
+        return -1;
+    }
+
+    std::ostringstream oss;
+    oss << "第 " << (round_index + 1) << " 轮吞吐测试 | 发送: " << sendCount
+        << " 条 | 数据大小: [" << minSize << ", " << maxSize << "]"
+        << " | 发送线程: " << threadNum
+        << " | Writer: " << (shared ? "共用 1 个" : "每线程 1 个");
+    Logger::getInstance().logAndPrint(oss.str());
+
+    auto& resUtil = ResourceUtilization::instance();
+    resUtil.initialize();
+    SysMetrics start_metrics = resUtil.collectCurrentMetrics();
+
+    // 每个线程一个可复用样本，包大小与单线程路径一致：每轮抽取一次
+    std::vector<DDS::Bytes> samples(static_cast<size_t>(threadNum));
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<int> dis(std::min(minSize, maxSize), std::max(minSize, maxSize));
+    for (int t = 0; t < threadNum; ++t) {
+        if (!ddsManager_.prepareReusableBytesData(samples[t], std::max(minSize, maxSize))) {
+            for (int k = 0; k < t; ++k) {
+                ddsManager_.releaseReusableBytesData(samples[k]);
+            }
+            Logger::getInstance().logAndPrint("Throughput_Bytes: 准备测试数据失败");
+            return -1;
+        }
+        reinterpret_cast<PacketHeader*>(samples[t].value.get_contiguous_buffer())->round = static_cast<uint32_t>(round_index + 1);
+        const int size = minSize == maxSize ? minSize : dis(gen);
+        samples[t].value._length = static_cast<DDS_ULong>(std::max(size, static_cast<int>(sizeof(PacketHeader))));
+    }
+
+    struct SenderStats {
+        uint64_t sent = 0;
+        uint64_t failed = 0;
+        double seconds = 0.0;
+        std::string rate_summary;
+        std::atomic<uint64_t> progress{ 0 };   // 供区间采样读取的已发送数
+        uint64_t payload_bytes = 0;
+    };
+    std::vector<SenderStats> stats(static_cast<size_t>(threadNum));
+    for (int t = 0; t < threadNum; ++t) {
+        stats[t].payload_bytes = samples[t].value._length;
+    }
+
+    IntervalRecorder recorder(config.m_sampleIntervalMs);
+    recorder.start([&stats] {
+        IntervalRecorder::Counters c;
+        for (const auto& s : stats) {
+            const uint64_t n = s.progress.load(std::memory_order_relaxed);
+            c.messages += n;
+            c.bytes += n * s.payload_bytes;
+        }
+        return c;
+        });
+
+    auto sender = [&](int t) {
+        resUtil.registerCurrentThread("sender_" + std::to_string(t));
+        WriterType* writer = writers[shared ? 0 : static_cast<size_t>(t)];
+        DDS::Bytes& sample = samples[t];
+        uint8_t* buffer = sample.value.get_contiguous_buffer();
+        SenderStats& s = stats[t];
+
+        RateController rate(config, round_index);
+        const auto begin = std::chrono::steady_clock::now();
+        rate.start();
+        for (int j = t; j < sendCount; j += threadNum) {
+            rate.waitNext();
+            *reinterpret_cast<uint32_t*>(buffer) = j;
+            if (writer->write(sample, DDS_HANDLE_NIL_NATIVE) == DDS::RETCODE_OK) {
+                s.progress.store(++s.sent, std::memory_order_relaxed);
+                if (s.sent % sendPrintGap == 0) {
+                    Logger::getInstance().logAndPrint("线程 " + std::to_string(t) + " 已发送 " + std::to_string(s.sent) + " 条");
+                }
+            }
+            else {
+                ++s.failed;
+            }
+        }
+        s.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (rate.enabled()) {
+            s.rate_summary = rate.summary(s.sent);
+        }
+        };
+
+    const auto wall_begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(threadNum));
+    for (int t = 0; t < threadNum; ++t) {
+        threads.emplace_back(sender, t);
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    TestRoundResult round_result;
+    recorder.stopInto(round_result);
+    const double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_begin).count();
+
+    for (auto& sample : samples) {
+        ddsManager_.releaseReusableBytesData(sample);
+    }
+
+    // === 逐线程与汇总速率 ===
+    uint64_t total_sent = 0;
+    uint64_t total_failed = 0;
+    double min_rate = 0.0;
+    double max_rate = 0.0;
+    for (int t = 0; t < threadNum; ++t) {
+        const SenderStats& s = stats[t];
+        const double rate = s.seconds > 0 ? s.sent / s.seconds : 0.0;
+        total_sent += s.sent;
+        total_failed += s.failed;
+        min_rate = (t == 0) ? rate : std::min(min_rate, rate);
+        max_rate = std::max(max_rate, rate);
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2)
+            << "  发送线程[" << t << "] | 发送: " << s.sent << " | 失败: " << s.failed
+            << " | 耗时: " << s.seconds * 1000.0 << " ms | 速率: " << rate << " msg/s";
+        if (!s.rate_summary.empty()) {
+            line << " | " << s.rate_summary;
+        }
+        Logger::getInstance().logAndPrint(line.str());
+    }
+    std::ostringstream summary;
+    summary << std::fixed << std::setprecision(2)
+        << "多线程发送汇总 | 线程: " << threadNum
+        << " | Writer: " << writers.size()
+        << " | 总发送: " << total_sent << " (失败 " << total_failed << ")"
+        << " | 墙钟耗时: " << wall_seconds * 1000.0 << " ms"
+        << " | 总速率: " << (wall_seconds > 0 ? total_sent / wall_seconds : 0.0) << " msg/s"
+        << " | 每线程平均: " << (wall_seconds > 0 ? total_sent / wall_seconds / threadNum : 0.0) << " msg/s"
+        << " | 单线程区间: [" << min_rate << ", " << max_rate << "] msg/s";
+    Logger::getInstance().logAndPrint(summary.str());
+
+    uint64_t total_bytes = 0;
+    for (const auto& s : stats) {
+        total_bytes += s.sent * s.payload_bytes;
+    }
+    round_result.perf.role = "publisher";
+    round_result.perf.time_to_match_ms = ddsManager_.match_tracker().lastTimeToMatchMs();
+    round_result.perf.payload_bytes = total_sent > 0 ? static_cast<int>(total_bytes / total_sent) : minSize;
+    round_result.perf.sent = total_sent;
+    round_result.perf.duration_ms = wall_seconds * 1000.0;
+    if (wall_seconds > 0) {
+        round_result.perf.msgs_per_sec = total_sent / wall_seconds;
+        round_result.perf.mb_per_sec = total_bytes / wall_seconds / (1024.0 * 1024.0);
+    }
+
+    // 等待所有 Writer 的数据被确认，再由第一个 Writer 发送结束包
+    for (auto* writer : writers) {
+        writer->wait_for_acknowledgments({ 10, 0 });
+    }
+
+    DDS::Bytes end_sample;
+    if (ddsManager_.prepareEndBytesData(end_sample, minSize)) {
+        reinterpret_cast<PacketHeader*>(end_sample.value.get_contiguous_buffer())->round = static_cast<uint32_t>(round_index + 1);
+        for (int k = 0; k < 3; ++k) {
+            writers[0]->write(end_sample, DDS_HANDLE_NIL_NATIVE);
+            Logger::getInstance().logAndPrint("结束包发送第 " + std::to_string(k + 1) + " 次");
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ddsManager_.cleanupBytesData(end_sample);
+
+    round_result.round_index = round_index + 1;
+    round_result.start_metrics = start_metrics;
+    round_result.end_metrics = resUtil.collectCurrentMetrics();
+    if (result_callback_) {
+        result_callback_(round_result);
     }
 
     Logger::getInstance().logAndPrint("第 " + std::to_string(round_index + 1) + " 轮发送完成");
@@ -252,7 +463,7 @@ int Throughput_Bytes::runSubscriber(const ConfigData& config) {
 
     const int round_index = config.m_activeLoop;
 
-    if (!waitForReaderMatch()) {
+    if (!waitForReaderMatch(std::chrono::seconds(config.m_matchTimeoutSec))) {
         Logger::getInstance().logAndPrint("Throughput_Bytes: 等待 Publisher 匹配超时");
         return -1;
     }
@@ -263,9 +474,39 @@ int Throughput_Bytes::runSubscriber(const ConfigData& config) {
     resUtil.initialize();
     SysMetrics start_metrics = resUtil.collectCurrentMetrics();
 
-    // 重置状态
-    receivedCount_.store(0);
-    roundFinished_.store(false);
+    // 重置状态并登记本轮标记：登记前提前到达的本轮数据由 RoundGate 暂存后在此补记，
+    // 上一轮迟到的数据和重复结束包按包头轮次标记忽略（实体复用时 Reader 跨轮存活）
+    uint64_t deferred_dropped = 0;
+    roundGate_.arm(static_cast<uint32_t>(round_index + 1), [&](const RoundGate::Deferred& d) {
+        staleCount_.store(0);
+        seqTracker_.reset();
+        for (uint32_t sequence : d.sequences) {
+            seqTracker_.record(sequence);
+        }
+        receivedCount_.store(static_cast<int>(d.sequences.size()));
+        {
+            std::lock_guard<std::mutex> lock(time_mutex_);
+            first_packet_time_ = d.first_data;
+            end_packet_time_ = d.end_time;
+        }
+        roundFinished_.store(d.end_seen);
+        deferred_dropped = d.dropped;
+        });
+    if (deferred_dropped > 0) {
+        Logger::getInstance().logAndPrint("警告：订阅端就绪前提前到达的样本超出暂存上限，丢弃 " + std::to_string(deferred_dropped) + " 条");
+    }
+
+    // 区间采样：接收数 / 丢包均来自回调线程维护的原子计数；
+    // 字节数按配置的包大小估算（与本轮汇总的带宽口径一致）
+    const uint64_t payload_bytes = static_cast<uint64_t>(config.m_minSize[round_index]);
+    IntervalRecorder recorder(config.m_sampleIntervalMs);
+    recorder.start([this, payload_bytes] {
+        IntervalRecorder::Counters c;
+        c.messages = static_cast<uint64_t>(receivedCount_.load(std::memory_order_relaxed));
+        c.bytes = c.messages * payload_bytes;
+        c.lost = seqTracker_.snapshot().lost;
+        return c;
+        });
 
     // 用于计时（由回调设置）
     std::chrono::steady_clock::time_point start_time;
@@ -284,7 +525,15 @@ int Throughput_Bytes::runSubscriber(const ConfigData& config) {
     // 这里我们假设你已经通过其他方式记录了这两个时间（见下方说明）
 
     // === 阻塞等待测试结束信号 ===
-    waitForRoundEnd();  // 会阻塞直到 onEndOfRound() 被调用
+    const bool end_received = waitForRoundEnd(std::chrono::seconds(config.m_roundIdleTimeoutSec));
+    roundGate_.close();
+    if (!end_received) {
+        Logger::getInstance().logAndPrint("警告：长时间未收到新数据且未收到结束包，按已收数据结算本轮");
+        std::lock_guard<std::mutex> lock(time_mutex_);
+        end_packet_time_ = std::chrono::steady_clock::now();
+    }
+    TestRoundResult round_result;
+    recorder.stopInto(round_result);
 
     // === 测试结束，读取计时结果 ===
     start_time = first_packet_time_;   // 来自 onDataReceived 的记录
@@ -319,15 +568,30 @@ int Throughput_Bytes::runSubscriber(const ConfigData& config) {
         }
     }
 
-    // === 计算丢包数和丢包率 ===
+    // === 计算丢包数和丢包率（按序列号，重复包不计入有效接收）===
     int expected = config.m_sendCount[round_index];
-    int lost = expected - received;
+    seqTracker_.finalize(static_cast<uint64_t>(expected));
+    SequenceStats seq_stats = seqTracker_.snapshot();
+    int lost = static_cast<int>(seq_stats.lost);
     double lossRate = expected > 0 ? (double)lost / expected * 100.0 : 0.0;
 
+    round_result.perf.role = "subscriber";
+    round_result.perf.time_to_match_ms = ddsManager_.match_tracker().lastTimeToMatchMs();
+    round_result.perf.payload_bytes = avg_packet_size;
+    round_result.perf.sent = static_cast<uint64_t>(expected);
+    round_result.perf.received = static_cast<uint64_t>(received);
+    round_result.perf.lost = seq_stats.lost;
+    round_result.perf.loss_rate_percent = lossRate;
+    round_result.perf.duration_ms = duration_seconds * 1000.0;
+    round_result.perf.msgs_per_sec = throughput_pps;
+    round_result.perf.mb_per_sec = throughput_mbps / 8.0;
+
     // === 上报资源使用 ===
-    SysMetrics end_metrics = resUtil.collectCurrentMetrics();
+    round_result.round_index = round_index + 1;
+    round_result.start_metrics = start_metrics;
+    round_result.end_metrics = resUtil.collectCurrentMetrics();
     if (result_callback_) {
-        result_callback_(TestRoundResult{ round_index + 1, start_metrics, end_metrics });
+        result_callback_(round_result);
     }
 
     // === 输出结果 ===
@@ -342,17 +606,52 @@ int Throughput_Bytes::runSubscriber(const ConfigData& config) {
         << "带宽: " << throughput_mbps << " Mbps";
 
     Logger::getInstance().logAndPrint(oss.str());
+    Logger::getInstance().logAndPrint(formatSequenceStats(seq_stats));
+    if (staleCount_.load() > 0) {
+        Logger::getInstance().logAndPrint("忽略的上一轮迟到样本: " + std::to_string(staleCount_.load()));
+    }
 
-    return 0;
+    // === 完整性校验（m_checkSample）：校验耗时单独列出，不从吞吐中扣除 ===
+    const SampleVerifier& verifier = ddsManager_.sample_verifier();
+    if (verifier.enabled()) {
+        IntegrityStats integrity = verifier.snapshot();
+        std::ostringstream ioss;
+        ioss << std::fixed << std::setprecision(2) << formatIntegrityStats(integrity)
+            << " | 占接收耗时: " << (duration_seconds > 0 ? integrity.verify_ns / 1e9 / duration_seconds * 100.0 : 0.0) << "%";
+        Logger::getInstance().logAndPrint(ioss.str());
+    }
+
+    return end_received ? 0 : -1;
 }
 
 // ========================
 // 回调函数
 // ========================
 
-void Throughput_Bytes::onDataReceived(const DDS::Bytes& /*sample*/, const DDS::SampleInfo& info) {
+void Throughput_Bytes::onDataReceived(const DDS::Bytes& sample, const DDS::SampleInfo& info) {
     if (!info.valid_data) return;
 
+    const uint8_t* buffer = sample.value.get_contiguous_buffer();
+    if (!buffer || sample.value.length() < sizeof(PacketHeader)) return;
+
+    const PacketHeader* hdr = reinterpret_cast<const PacketHeader*>(buffer);
+    const RoundGate::Admit admit = roundGate_.admitData(hdr->round, hdr->sequence);
+    if (admit != RoundGate::Admit::Current) {
+        if (admit == RoundGate::Admit::Stale) {
+            staleCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (ddsManager_.concurrent_dispatch()) {
+        // pool 分发时回调并发执行，SequenceTracker 只允许单线程 record
+        std::lock_guard<std::mutex> lock(seq_mutex_);
+        seqTracker_.record(hdr->sequence);
+    }
+    else {
+        seqTracker_.record(hdr->sequence);
+    }
+
     int64_t count = receivedCount_.fetch_add(1, std::memory_order_relaxed) + 1;
 
     // 记录第一个包的时间
@@ -363,15 +662,26 @@ void Throughput_Bytes::onDataReceived(const DDS::Bytes& /*sample*/, const DDS::S
     }
 }
 
-void Throughput_Bytes::onEndOfRound() {
-    // 记录结束时间
-    {
-        std::lock_guard<std::mutex> lock(time_mutex_);
-        end_packet_time_ = std::chrono::steady_clock::now();
+void Throughput_Bytes::onEndOfRound(uint32_t round) {
+    // 发布端每轮的结束包重复发送 3 次：属于上一轮的、或本轮已结算后到达的直接忽略；
+    // 订阅端就绪前提前到达的由 RoundGate 记下，登记本轮时直接结束
+    if (roundGate_.admitEnd(round) != RoundGate::Admit::Current) {
+        return;
     }
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (roundFinished_.load()) {
+            return;
+        }
 
-    roundFinished_.store(true);
-    cv_.notify_one();
+        // 记录结束时间
+        {
+            std::lock_guard<std::mutex> time_lock(time_mutex_);
+            end_packet_time_ = std::chrono::steady_clock::now();
+        }
+        roundFinished_.store(true);
+    }
+    cv_.notify_all();
 
     Logger::getInstance().logAndPrint("[Throughput_Bytes] 测试轮次结束信号已触发");
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 #pragma once
 
 #include "DDSManager_Bytes.h"  // 只依赖 Bytes 版本
+#include "SequenceTracker.h"
+#include "RoundGate.h"
+
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
@@ -26,28 +29,31 @@ public:
     bool waitForSubscriberReconnect(const std::chrono::seconds& timeout);
 
     void onDataReceived(const DDS::Bytes& sample, const DDS::SampleInfo& info);
-    void onEndOfRound();
+    void onEndOfRound(uint32_t round);
 
 private:
-    class WriterListener;
-
     DDSManager_Bytes& ddsManager_;
     ResultCallback result_callback_;
 
     std::atomic<int> receivedCount_{ 0 };
+    SequenceTracker seqTracker_;   // 按序列号统计丢包、重复与乱序
+    std::mutex seq_mutex_;         // 仅 pool 分发（多工作线程）时保护 seqTracker_
     std::atomic<bool> roundFinished_{ false };
+    RoundGate roundGate_;                      // 按包头轮次标记（m_activeLoop + 1）划分样本，回调只统计已登记轮次
+    std::atomic<uint64_t> staleCount_{ 0 };    // 本轮忽略的上一轮迟到样本数
     std::mutex mtx_;
     std::condition_variable cv_;
 
-    std::atomic<bool> subscriber_reconnected_{ false };
-    std::mutex reconnect_mtx_;
-    std::condition_variable reconnect_cv_;
+    // 超过 idle_timeout 没有新数据且未收到结束包时返回 false
+    bool waitForRoundEnd(std::chrono::seconds idle_timeout);
 
-    std::unique_ptr<WriterListener> writer_listener_;
+    // 匹配等待由 DDSManager 的 MatchTracker 回调驱动；timeout 为 0 时最多等待 60 分钟（m_matchTimeoutSec）
+    bool waitForWriterMatch(std::chrono::milliseconds timeout);
+    bool waitForSenderWritersMatch(std::chrono::milliseconds timeout);
 
-    void waitForRoundEnd();
-    bool waitForWriterMatch();
-    bool waitForReaderMatch();
+    // m_sendThreadNum > 1 时的多线程发送路径
+    int runPublisherMultiThread(const ConfigData& config);
+    bool waitForReaderMatch(std::chrono::milliseconds timeout);
 
     std::chrono::steady_clock::time_point first_packet_time_;
     std::chrono::steady_clock::time_point end_packet_time_;
@@ -6,6 +6,10 @@
 #include "ZRBuiltinTypes.h"
 #include "ZRBuiltinTypesTypeSupport.h"
 
+#include "RateController.h"
+#include "IntervalRecorder.h"
+#include "PacketHeader.h"
+
 #include <thread>
 #include <chrono>
 #include <sstream>
@@ -14,34 +18,10 @@
 
 using namespace DDS;
 
-// Packet Header 结构（保持与 Bytes 版本一致）
-struct PacketHeader {
-    uint32_t sequence;     // 序列号
-    // uint64_t timestamp; // 当前未使用，可选
-    uint8_t  packet_type;  // 0=数据包, 1=结束包
-};
-
-// ========================
-// 内部类：WriterListener (专用于 ZeroCopy)
-// ========================
-
-class Throughput_ZeroCopyBytes::WriterListener : public virtual DDS::DataWriterListener {
-public:
-    WriterListener(std::atomic<bool>& flag, std::mutex& mtx, std::condition_variable& cv)
-        : reconnected_flag_(flag), mutex_(mtx), cond_var_(cv), last_current_count_(0) {
-    }
-
-    void on_liveliness_lost(DataWriter*, const LivelinessLostStatus&) override {}
-    void on_offered_deadline_missed(DataWriter*, const OfferedDeadlineMissedStatus&) override {}
-    void on_offered_incompatible_qos(DataWriter*, const OfferedIncompatibleQosStatus&) override {}
-    void on_publication_matched(DataWriter*, const PublicationMatchedStatus&) override {}
-
-private:
-    std::atomic<bool>& reconnected_flag_;
-    std::mutex& mutex_;
-    std::condition_variable& cond_var_;
-    std::atomic<int32_t> last_current_count_;
-};
+namespace {
+    // m_roundIdleTimeoutSec 为 0 时的无数据等待上限
+    constexpr auto kMaxRoundIdle = std::chrono::minutes(60);
+}
 
 // ========================
 // 构造函数 & 析构
@@ -50,23 +30,9 @@ private:
 Throughput_ZeroCopyBytes::Throughput_ZeroCopyBytes(DDSManager_ZeroCopyBytes& ddsManager, ResultCallback callback)
     : ddsManager_(ddsManager)
     , result_callback_(std::move(callback))
-    , subscriber_reconnected_(false)
     , receivedCount_(0)
     , roundFinished_(false)
 {
-    writer_listener_ = std::make_unique<WriterListener>(
-        subscriber_reconnected_,
-        reconnect_mtx_,
-        reconnect_cv_
-    );
-
-    DataWriter* writer = ddsManager_.get_data_writer();
-    if (writer) {
-        ReturnCode_t ret = writer->set_listener(writer_listener_.get(), DDS::SUBSCRIPTION_MATCHED_STATUS);
-        if (ret != DDS::RETCODE_OK) {
-            Logger::getInstance().logAndPrint("警告：无法为 DataWriter 设置监听器");
-        }
-    }
 }
 
 Throughput_ZeroCopyBytes::~Throughput_ZeroCopyBytes() = default;
@@ -76,57 +42,51 @@ Throughput_ZeroCopyBytes::~Throughput_ZeroCopyBytes() = default;
 // ========================
 
 bool Throughput_ZeroCopyBytes::waitForSubscriberReconnect(const std::chrono::seconds& timeout) {
-    std::unique_lock<std::mutex> lock(reconnect_mtx_);
-    subscriber_reconnected_ = false;
-    return reconnect_cv_.wait_for(lock, timeout, [this] { return subscriber_reconnected_.load(); });
+    // 每轮重建的 Writer 挂有 MatchTracker 的匹配监听器，订阅者上线即唤醒
+    DataWriter* writer = ddsManager_.get_data_writer();
+    return writer && ddsManager_.match_tracker().waitForWriters({ writer }, timeout);
 }
 
-void Throughput_ZeroCopyBytes::waitForRoundEnd() {
+bool Throughput_ZeroCopyBytes::waitForRoundEnd(std::chrono::seconds idle_timeout) {
+    // 按「持续无新数据」判定超时：长轮次只要数据仍在到达就继续等待
+    const std::chrono::seconds slice = idle_timeout.count() > 0
+        ? idle_timeout : std::chrono::duration_cast<std::chrono::seconds>(kMaxRoundIdle);
+
     std::unique_lock<std::mutex> lock(mtx_);
-    cv_.wait(lock, [this] { return roundFinished_.load(); });
+    int last = receivedCount_.load(std::memory_order_relaxed);
+    while (!cv_.wait_for(lock, slice, [this] { return roundFinished_.load(); })) {
+        const int now = receivedCount_.load(std::memory_order_relaxed);
+        if (now == last) {
+            roundFinished_.store(true);   // 此后到达的本轮结束包不再改写结果
+            return false;
+        }
+        last = now;
+    }
+    return true;
 }
 
-bool Throughput_ZeroCopyBytes::waitForWriterMatch() {
+bool Throughput_ZeroCopyBytes::waitForWriterMatch(std::chrono::milliseconds timeout) {
     auto writer = ddsManager_.get_data_writer();
     if (!writer) return false;
 
-    while (true) {
-        PublicationMatchedStatus status{};
-        ReturnCode_t ret = writer->get_publication_matched_status(status);
-        if (ret == RETCODE_OK) {
-            Logger::getInstance().logAndPrint(
-                "Writer wait match(" + std::to_string(status.current_count) + "/1)"
-            );
-            if (status.current_count > 0) return true;
-        }
-        else {
-            Logger::getInstance().logAndPrint("Error: Failed to get publication matched status.");
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
+    Logger::getInstance().logAndPrint("Writer 等待匹配...");
+    MatchTracker& matches = ddsManager_.match_tracker();
+    if (!matches.waitForWriters({ writer }, timeout)) return false;
+    Logger::getInstance().logAndPrint(formatTimeToMatch("Writer", matches.lastTimeToMatchMs()));
+    return true;
 }
 
-bool Throughput_ZeroCopyBytes::waitForReaderMatch() {
+bool Throughput_ZeroCopyBytes::waitForReaderMatch(std::chrono::milliseconds timeout) {
     auto reader = ddsManager_.get_data_reader();
     if (!reader) return false;
 
-    while (true) {
-        SubscriptionMatchedStatus status{};
-        ReturnCode_t ret = reader->get_subscription_matched_status(status);
-        if (ret == RETCODE_OK) {
-            Logger::getInstance().logAndPrint(
-                "Reader wait match(" + std::to_string(status.current_count) + "/1)"
-            );
-            if (status.current_count > 0) return true;
-        }
-        else {
-            Logger::getInstance().logAndPrint("Error: Failed to get subscription matched status.");
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
+    Logger::getInstance().logAndPrint("Reader 等待匹配...");
+    MatchTracker& matches = ddsManager_.match_tracker();
+    if (!matches.waitForReaders({ reader }, timeout)) return false;
+    Logger::getInstance().logAndPrint(formatTimeToMatch("Reader", matches.lastTimeToMatchMs()));
+    return true;
 }
+
 // ========================
 // runPublisher - 发送逻辑（零拷贝专用）
 // ========================
@@ -145,6 +105,10 @@ int Throughput_ZeroCopyBytes::runPublisher(const ConfigData& config) {
     const int sendCount = config.m_sendCount[round_index];
     const int sendPrintGap = config.m_sendPrintGap[round_index];
 
+    if (config.m_sendThreadNum > 1) {
+        Logger::getInstance().logAndPrint("[Warning] Zero-Copy 共用单一借出缓冲区，不支持多线程发送，按单线程运行");
+    }
+
     // === 确保 Zero-Copy 缓冲区大小匹配当前轮次数据尺寸 ===
     if (!ddsManager_.ensureBufferSize(static_cast<size_t>(minSize))) {
         Logger::getInstance().error(
@@ -154,7 +118,7 @@ int Throughput_ZeroCopyBytes::runPublisher(const ConfigData& config) {
         return -1;
     }
 
-    if (!waitForWriterMatch()) {
+    if (!waitForWriterMatch(std::chrono::seconds(config.m_matchTimeoutSec))) {
         Logger::getInstance().logAndPrint("Throughput_ZeroCopyBytes: 等待 Subscriber 匹配超时");
         return -1;
     }
@@ -166,6 +130,7 @@ int Throughput_ZeroCopyBytes::runPublisher(const ConfigData& config) {
 
     auto& resUtil = ResourceUtilization::instance();
     resUtil.initialize();
+    resUtil.registerCurrentThread("sender");
     SysMetrics start_metrics = resUtil.collectCurrentMetrics();
 
     DDS::ZeroCopyBytes sample;
@@ -181,17 +146,39 @@ int Throughput_ZeroCopyBytes::runPublisher(const ConfigData& config) {
         Logger::getInstance().error("Throughput_ZeroCopyBytes: userBuffer 为空");
         return -1;
     }
+    const uint32_t round_tag = static_cast<uint32_t>(round_index + 1);
+    reinterpret_cast<PacketHeader*>(userBuffer)->round = round_tag;
+
+    // === 区间采样：发送线程只做 relaxed store，由采样线程读取 ===
+    const uint64_t payload_bytes = static_cast<uint64_t>(minSize);
+    std::atomic<uint64_t> sent_progress{ 0 };
+    IntervalRecorder recorder(config.m_sampleIntervalMs);
+    recorder.start([&sent_progress, payload_bytes] {
+        IntervalRecorder::Counters c;
+        c.messages = sent_progress.load(std::memory_order_relaxed);
+        c.bytes = c.messages * payload_bytes;
+        return c;
+        });
+
+    // === 速率控制（m_sendDelay 为 0 时饱和发送）===
+    RateController rate(config, round_index);
+    Logger::getInstance().logAndPrint(rate.describe());
+    rate.start();
+    const auto send_begin = std::chrono::steady_clock::now();
 
     // === 发送主循环 ===
+    uint64_t sent = 0;
     for (int j = 0; j < sendCount; ++j) {
+        rate.waitNext();
         // 更新序列号
         *reinterpret_cast<uint32_t*>(userBuffer) = static_cast<uint32_t>(j);
 
         DDS::ReturnCode_t ret = writer->write(sample, DDS_HANDLE_NIL_NATIVE);
         if (ret == DDS::RETCODE_OK) {
-            static int cnt = 0;
-            if (++cnt % sendPrintGap == 0) {
-                Logger::getInstance().logAndPrint("已发送 " + std::to_string(cnt) + " 条");
+            ++sent;
+            sent_progress.store(sent, std::memory_order_relaxed);
+            if (sendPrintGap > 0 && sent % sendPrintGap == 0) {
+                Logger::getInstance().logAndPrint("已发送 " + std::to_string(sent) + " 条");
             }
         }
         else {
@@ -199,12 +186,30 @@ int Throughput_ZeroCopyBytes::runPublisher(const ConfigData& config) {
         }
     }
 
+    const double send_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - send_begin).count();
+    if (rate.enabled()) {
+        Logger::getInstance().logAndPrint(rate.summary(sent));
+    }
+
     // 等待所有数据被确认
     DDS::Duration_t timeout = { 10, 0 };
     writer->wait_for_acknowledgments(timeout);
 
+    TestRoundResult round_result;
+    recorder.stopInto(round_result);
+    round_result.perf.role = "publisher";
+    round_result.perf.time_to_match_ms = ddsManager_.match_tracker().lastTimeToMatchMs();
+    round_result.perf.payload_bytes = minSize;
+    round_result.perf.sent = sent;
+    round_result.perf.duration_ms = send_seconds * 1000.0;
+    if (send_seconds > 0) {
+        round_result.perf.msgs_per_sec = sent / send_seconds;
+        round_result.perf.mb_per_sec = sent * payload_bytes / send_seconds / (1024.0 * 1024.0);
+    }
+
     // === 发送结束包（标记本轮结束）===
     ddsManager_.prepareEndZeroCopyData(sample);
+    reinterpret_cast<PacketHeader*>(sample.userBuffer)->round = round_tag;
     for (int k = 0; k < 3; ++k) {
         writer->write(sample, DDS_HANDLE_NIL_NATIVE);
         Logger::getInstance().logAndPrint("结束包发送第 " + std::to_string(k + 1) + " 次");
@@ -212,9 +217,11 @@ int Throughput_ZeroCopyBytes::runPublisher(const ConfigData& config) {
     }
 
     // 收集资源使用情况
-    SysMetrics end_metrics = resUtil.collectCurrentMetrics();
+    round_result.round_index = round_index + 1;
+    round_result.start_metrics = start_metrics;
+    round_result.end_metrics = resUtil.collectCurrentMetrics();
     if (result_callback_) {
-        result_callback_(TestRoundResult{ round_index + 1, start_metrics, end_metrics }); // <--- 此处应能正常工作
+        result_callback_(round_result);
     }
 
     Logger::getInstance().logAndPrint("第 " + std::to_string(round_index + 1) + " 轮发送完成 (ZeroCopy)");
@@ -246,7 +253,7 @@ int Throughput_ZeroCopyBytes::runSubscriber(const ConfigData& config) {
         return -1;
     }
 
-    if (!waitForReaderMatch()) {
+    if (!waitForReaderMatch(std::chrono::seconds(config.m_matchTimeoutSec))) {
         Logger::getInstance().logAndPrint("Throughput_ZeroCopyBytes: 等待 Publisher 匹配超时");
         return -1;
     }
@@ -257,18 +264,49 @@ int Throughput_ZeroCopyBytes::runSubscriber(const ConfigData& config) {
     resUtil.initialize();
     SysMetrics start_metrics = resUtil.collectCurrentMetrics();
 
-    // 重置状态
-    receivedCount_.store(0);
-    roundFinished_.store(false);
-
-    {
-        std::lock_guard<std::mutex> lock(time_mutex_);
-        first_packet_time_ = std::chrono::steady_clock::time_point(); // zero 初始化
-        end_packet_time_ = std::chrono::steady_clock::time_point();
+    // 重置状态并登记本轮标记：登记前提前到达的本轮数据由 RoundGate 暂存后在此补记，
+    // 上一轮迟到的数据和重复结束包按包头轮次标记忽略（实体复用时 Reader 跨轮存活）
+    uint64_t deferred_dropped = 0;
+    roundGate_.arm(static_cast<uint32_t>(round_index + 1), [&](const RoundGate::Deferred& d) {
+        staleCount_.store(0);
+        seqTracker_.reset();
+        for (uint32_t sequence : d.sequences) {
+            seqTracker_.record(sequence);
+        }
+        receivedCount_.store(static_cast<int>(d.sequences.size()));
+        {
+            std::lock_guard<std::mutex> lock(time_mutex_);
+            first_packet_time_ = d.first_data;   // 无暂存样本时为零值
+            end_packet_time_ = d.end_time;
+        }
+        roundFinished_.store(d.end_seen);
+        deferred_dropped = d.dropped;
+        });
+    if (deferred_dropped > 0) {
+        Logger::getInstance().logAndPrint("警告：订阅端就绪前提前到达的样本超出暂存上限，丢弃 " + std::to_string(deferred_dropped) + " 条");
     }
 
+    // 区间采样：接收数 / 丢包来自回调线程维护的原子计数，字节数按配置包大小估算
+    const uint64_t payload_bytes = static_cast<uint64_t>(avg_packet_size);
+    IntervalRecorder recorder(config.m_sampleIntervalMs);
+    recorder.start([this, payload_bytes] {
+        IntervalRecorder::Counters c;
+        c.messages = static_cast<uint64_t>(receivedCount_.load(std::memory_order_relaxed));
+        c.bytes = c.messages * payload_bytes;
+        c.lost = seqTracker_.snapshot().lost;
+        return c;
+        });
+
     // === 阻塞等待测试结束信号 ===
-    waitForRoundEnd();  // 内部调用 cv_.wait(...) 直到 onEndOfRound() 触发
+    const bool end_received = waitForRoundEnd(std::chrono::seconds(config.m_roundIdleTimeoutSec));
+    roundGate_.close();
+    if (!end_received) {
+        Logger::getInstance().logAndPrint("警告：长时间未收到新数据且未收到结束包，按已收数据结算本轮");
+        std::lock_guard<std::mutex> lock(time_mutex_);
+        end_packet_time_ = std::chrono::steady_clock::now();
+    }
+    TestRoundResult round_result;
+    recorder.stopInto(round_result);
 
     // === 获取计时结果 ===
     std::chrono::steady_clock::time_point start_time, end_time;
@@ -301,14 +339,29 @@ int Throughput_ZeroCopyBytes::runSubscriber(const ConfigData& config) {
             (1024.0 * 1024.0)) / max(duration_seconds, 1e-9);
     }
 
-    // === 丢包率 ===
-    int lost = expected - received;
+    // === 丢包率（按序列号，重复包不计入有效接收）===
+    seqTracker_.finalize(static_cast<uint64_t>(expected));
+    SequenceStats seq_stats = seqTracker_.snapshot();
+    int lost = static_cast<int>(seq_stats.lost);
     double lossRate = expected > 0 ? static_cast<double>(lost) / expected * 100.0 : 0.0;
 
+    round_result.perf.role = "subscriber";
+    round_result.perf.time_to_match_ms = ddsManager_.match_tracker().lastTimeToMatchMs();
+    round_result.perf.payload_bytes = avg_packet_size;
+    round_result.perf.sent = static_cast<uint64_t>(expected);
+    round_result.perf.received = static_cast<uint64_t>(received);
+    round_result.perf.lost = seq_stats.lost;
+    round_result.perf.loss_rate_percent = lossRate;
+    round_result.perf.duration_ms = duration_seconds * 1000.0;
+    round_result.perf.msgs_per_sec = throughput_pps;
+    round_result.perf.mb_per_sec = throughput_mbps / 8.0;
+
     // === 上报资源使用 ===
-    SysMetrics end_metrics = resUtil.collectCurrentMetrics();
+    round_result.round_index = round_index + 1;
+    round_result.start_metrics = start_metrics;
+    round_result.end_metrics = resUtil.collectCurrentMetrics();
     if (result_callback_) {
-        result_callback_(TestRoundResult{ round_index + 1, start_metrics, end_metrics }); // <--- 此处也应能正常工作
+        result_callback_(round_result);
     }
 
     // === 输出结果 ===
@@ -323,17 +376,43 @@ int Throughput_ZeroCopyBytes::runSubscriber(const ConfigData& config) {
         << "带宽: " << throughput_mbps << " Mbps";
 
     Logger::getInstance().logAndPrint(oss.str());
+    Logger::getInstance().logAndPrint(formatSequenceStats(seq_stats));
+    if (staleCount_.load() > 0) {
+        Logger::getInstance().logAndPrint("忽略的上一轮迟到样本: " + std::to_string(staleCount_.load()));
+    }
 
-    return 0;
+    // === 完整性校验（m_checkSample）：校验耗时单独列出，不从吞吐中扣除 ===
+    const SampleVerifier& verifier = ddsManager_.sample_verifier();
+    if (verifier.enabled()) {
+        IntegrityStats integrity = verifier.snapshot();
+        std::ostringstream ioss;
+        ioss << std::fixed << std::setprecision(2) << formatIntegrityStats(integrity)
+            << " | 占接收耗时: " << (duration_seconds > 0 ? integrity.verify_ns / 1e9 / duration_seconds * 100.0 : 0.0) << "%";
+        Logger::getInstance().logAndPrint(ioss.str());
+    }
+
+    return end_received ? 0 : -1;
 }
 
 // ========================
 // 回调函数实现（供外部 initialize 时传入）
 // ========================
 
-void Throughput_ZeroCopyBytes::onDataReceived(const DDS_ZeroCopyBytes& /*sample*/, const DDS::SampleInfo& info) {
+void Throughput_ZeroCopyBytes::onDataReceived(const DDS_ZeroCopyBytes& sample, const DDS::SampleInfo& info) {
     if (!info.valid_data) return;
 
+    if (!sample.userBuffer || sample.userLength < sizeof(PacketHeader)) return;
+
+    const PacketHeader* hdr = reinterpret_cast<const PacketHeader*>(sample.userBuffer);
+    const RoundGate::Admit admit = roundGate_.admitData(hdr->round, hdr->sequence);
+    if (admit != RoundGate::Admit::Current) {
+        if (admit == RoundGate::Admit::Stale) {
+            staleCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    seqTracker_.record(hdr->sequence);
+
     int64_t count = receivedCount_.fetch_add(1, std::memory_order_relaxed) + 1;
 
     // 记录第一个包的时间
@@ -344,15 +423,26 @@ void Throughput_ZeroCopyBytes::onDataReceived(const DDS_ZeroCopyBytes& /*sample*
     }
 }
 
-void Throughput_ZeroCopyBytes::onEndOfRound() {
-    // 记录结束时间
-    {
-        std::lock_guard<std::mutex> lock(time_mutex_);
-        end_packet_time_ = std::chrono::steady_clock::now();
+void Throughput_ZeroCopyBytes::onEndOfRound(uint32_t round) {
+    // 发布端每轮的结束包重复发送 3 次：属于上一轮的、或本轮已结算后到达的直接忽略；
+    // 订阅端就绪前提前到达的由 RoundGate 记下，登记本轮时直接结束
+    if (roundGate_.admitEnd(round) != RoundGate::Admit::Current) {
+        return;
     }
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (roundFinished_.load()) {
+            return;
+        }
 
-    roundFinished_.store(true);
-    cv_.notify_one();
+        // 记录结束时间
+        {
+            std::lock_guard<std::mutex> time_lock(time_mutex_);
+            end_packet_time_ = std::chrono::steady_clock::now();
+        }
+        roundFinished_.store(true);
+    }
+    cv_.notify_all();
 
     Logger::getInstance().logAndPrint("[Throughput_ZeroCopyBytes] 测试轮次结束信号已触发");
 }
\ No newline at end of file
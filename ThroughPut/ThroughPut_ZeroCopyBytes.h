@@ -9,6 +9,9 @@
 
 #include "DDSManager_ZeroCopyBytes.h"  // 包含 manager 定义
 
+#include "SequenceTracker.h"
+#include "RoundGate.h"
+
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
@@ -31,28 +34,26 @@ public:
     bool waitForSubscriberReconnect(const std::chrono::seconds& timeout);
 
     void onDataReceived(const DDS::ZeroCopyBytes& sample, const DDS::SampleInfo& info);
-    void onEndOfRound();
+    void onEndOfRound(uint32_t round);
 
 private:
-    class WriterListener;
-
     DDSManager_ZeroCopyBytes& ddsManager_;
     ResultCallback result_callback_;
 
     std::atomic<int> receivedCount_{ 0 };
+    SequenceTracker seqTracker_;   // 按序列号统计丢包、重复与乱序
     std::atomic<bool> roundFinished_{ false };
+    RoundGate roundGate_;                      // 按包头轮次标记（m_activeLoop + 1）划分样本，回调只统计已登记轮次
+    std::atomic<uint64_t> staleCount_{ 0 };    // 本轮忽略的上一轮迟到样本数
     std::mutex mtx_;
     std::condition_variable cv_;
 
-    std::atomic<bool> subscriber_reconnected_{ false };
-    std::mutex reconnect_mtx_;
-    std::condition_variable reconnect_cv_;
-
-    std::unique_ptr<WriterListener> writer_listener_;
+    // 超过 idle_timeout 没有新数据且未收到结束包时返回 false
+    bool waitForRoundEnd(std::chrono::seconds idle_timeout);
 
-    void waitForRoundEnd();
-    bool waitForWriterMatch();
-    bool waitForReaderMatch();
+    // 匹配等待由 DDSManager 的 MatchTracker 回调驱动；timeout 为 0 时最多等待 60 分钟（m_matchTimeoutSec）
+    bool waitForWriterMatch(std::chrono::milliseconds timeout);
+    bool waitForReaderMatch(std::chrono::milliseconds timeout);
 
     std::chrono::steady_clock::time_point first_packet_time_;
     std::chrono::steady_clock::time_point end_packet_time_; // 结束包收到时间